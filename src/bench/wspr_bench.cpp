@@ -0,0 +1,553 @@
+/**
+ * @file wspr_bench.cpp
+ * @brief Google Benchmark microbenchmarks for the WSPR encoder hot paths.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_batch.hpp"
+#include "wspr_cache.hpp"
+#include "wspr_fano.hpp"
+#include "wspr_gpu.hpp"
+#include "wspr_index.hpp"
+#include "wspr_message.hpp"
+#include "wspr_parallel.hpp"
+#include "wspr_pool.hpp"
+#include "wspr_receive.hpp"
+#include "wspr_reference.hpp"
+#include "wspr_service.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Reports throughput as messages per second and nanoseconds per message.
+     *
+     * @param state The benchmark state.
+     * @param per_iteration Messages encoded in each iteration.
+     */
+    void report(benchmark::State &state, std::size_t per_iteration)
+    {
+        const double messages = static_cast<double>(state.iterations()) * static_cast<double>(per_iteration);
+        state.counters["msgs/s"] = benchmark::Counter(messages, benchmark::Counter::kIsRate);
+        // An inverted rate is seconds per message, printed with an SI prefix (e.g. "260ns")
+        state.counters["time/msg"] = benchmark::Counter(messages, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    }
+
+    /**
+     * @brief A reproducible set of distinct, valid Type 1 messages.
+     */
+    struct Corpus
+    {
+        std::vector<std::string> callsign_storage;
+        std::vector<std::string> location_storage;
+        std::vector<std::string_view> callsigns;
+        std::vector<std::string_view> locations;
+        std::vector<int> powers;
+
+        /**
+         * @brief Builds `count` messages.
+         *
+         * @param count Number of messages.
+         */
+        explicit Corpus(std::size_t count)
+        {
+            static const int levels[] = {0, 3, 7, 10, 13, 17, 20, 23, 27, 30, 33, 37, 40, 43, 47, 50, 53, 57, 60};
+            uint32_t seed = 12345;
+            auto next = [&seed]() {
+                seed = seed * 1664525u + 1013904223u;
+                return seed >> 8;
+            };
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                std::string call = "K";
+                call += static_cast<char>('0' + next() % 10);
+                for (int j = 0; j < 3; ++j)
+                {
+                    call += static_cast<char>('A' + next() % 26);
+                }
+                std::string grid;
+                grid += static_cast<char>('A' + next() % 18);
+                grid += static_cast<char>('A' + next() % 18);
+                grid += static_cast<char>('0' + next() % 10);
+                grid += static_cast<char>('0' + next() % 10);
+                callsign_storage.push_back(call);
+                location_storage.push_back(grid);
+                powers.push_back(levels[next() % (sizeof(levels) / sizeof(levels[0]))]);
+            }
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                callsigns.push_back(callsign_storage[i]);
+                locations.push_back(location_storage[i]);
+            }
+        }
+    };
+
+    /**
+     * @brief Returns a shared corpus large enough for every benchmark.
+     *
+     * @return The corpus.
+     */
+    const Corpus &corpus()
+    {
+        static const Corpus shared(1 << 16);
+        return shared;
+    }
+}
+
+/**
+ * @brief One message through the throwing, string-based encode().
+ */
+static void BM_Encode(benchmark::State &state)
+{
+    const std::string callsign = "AA0NT";
+    const std::string location = "EM18";
+    WsprMessage::Symbols symbols;
+    for (auto _ : state)
+    {
+        WsprMessage::encode(callsign, location, 20, symbols.data());
+        benchmark::DoNotOptimize(symbols.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, 1);
+}
+BENCHMARK(BM_Encode);
+
+/**
+ * @brief One message through the noexcept try_encode().
+ */
+static void BM_TryEncode(benchmark::State &state)
+{
+    WsprMessage::Symbols symbols;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(WsprMessage::try_encode("AA0NT", "EM18", 20, symbols.data()));
+        benchmark::ClobberMemory();
+    }
+    report(state, 1);
+}
+BENCHMARK(BM_TryEncode);
+
+/**
+ * @brief Re-encoding an existing message with set_message_parameters().
+ */
+static void BM_SetMessageParameters(benchmark::State &state)
+{
+    const Corpus &input = corpus();
+    WsprMessage message;
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        message.set_message_parameters(input.callsign_storage[i], input.location_storage[i], input.powers[i]);
+        benchmark::DoNotOptimize(message.symbols.data());
+        benchmark::ClobberMemory();
+        i = (i + 1) & (input.callsigns.size() - 1);
+    }
+    report(state, 1);
+}
+BENCHMARK(BM_SetMessageParameters);
+
+/**
+ * @brief The validate-and-pack stage alone.
+ */
+static void BM_Pack(benchmark::State &state)
+{
+    const Corpus &input = corpus();
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        WsprPayload payload;
+        benchmark::DoNotOptimize(WsprMessage::pack(input.callsigns[i], input.locations[i], input.powers[i], payload));
+        benchmark::DoNotOptimize(payload);
+        i = (i + 1) & (input.callsigns.size() - 1);
+    }
+    report(state, 1);
+}
+BENCHMARK(BM_Pack);
+
+/**
+ * @brief The convolutional encode and interleave stage alone.
+ */
+static void BM_EncodePayload(benchmark::State &state)
+{
+    WsprPayload payload;
+    WsprMessage::pack("AA0NT", "EM18", 20, payload);
+    WsprMessage::Symbols symbols;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(payload);
+        WsprMessage::encode_payload(payload, symbols.data());
+        benchmark::DoNotOptimize(symbols.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, 1);
+}
+BENCHMARK(BM_EncodePayload);
+
+/**
+ * @brief Power stepping an encoded message with set_power().
+ */
+static void BM_SetPower(benchmark::State &state)
+{
+    static const int levels[] = {0, 10, 20, 30, 37, 40, 47, 60};
+    WsprMessage message;
+    message.try_set("AA0NT", "EM18", 20);
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(message.set_power(levels[i]));
+        benchmark::DoNotOptimize(message.symbols.data());
+        benchmark::ClobberMemory();
+        i = (i + 1) & 7;
+    }
+    report(state, 1);
+}
+BENCHMARK(BM_SetPower);
+
+/**
+ * @brief The same power stepping with a full try_set() for comparison.
+ */
+static void BM_SetPowerFull(benchmark::State &state)
+{
+    static const int levels[] = {0, 10, 20, 30, 37, 40, 47, 60};
+    WsprMessage message;
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(message.try_set("AA0NT", "EM18", levels[i]));
+        benchmark::DoNotOptimize(message.symbols.data());
+        benchmark::ClobberMemory();
+        i = (i + 1) & 7;
+    }
+    report(state, 1);
+}
+BENCHMARK(BM_SetPowerFull);
+
+/**
+ * @brief WsprBatch::encode() at several batch sizes with one kernel.
+ *
+ * @param state Range 0 is the batch size.
+ * @param kernel The kernel to measure.
+ */
+static void BM_Batch(benchmark::State &state, WsprKernel kernel)
+{
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    if (!WsprSimd::available(kernel))
+    {
+        state.SkipWithError("kernel not available on this CPU");
+        return;
+    }
+
+    const Corpus &input = corpus();
+    std::vector<uint8_t> out(count * MSG_SIZE);
+    auto rows = reinterpret_cast<uint8_t(*)[MSG_SIZE]>(out.data());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(WsprBatch::encode(input.callsigns.data(), input.locations.data(), input.powers.data(),
+                                                   count, rows, nullptr, kernel));
+        benchmark::ClobberMemory();
+    }
+    report(state, count);
+}
+BENCHMARK_CAPTURE(BM_Batch, scalar, WsprKernel::scalar)->ArgName("size")->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_CAPTURE(BM_Batch, avx2, WsprKernel::avx2)->ArgName("size")->RangeMultiplier(8)->Range(1, 16384);
+BENCHMARK_CAPTURE(BM_Batch, neon, WsprKernel::neon)->ArgName("size")->RangeMultiplier(8)->Range(1, 16384);
+
+/**
+ * @brief The original bit-serial encoder at the same batch sizes as BM_Batch.
+ *
+ * This is the baseline for the table-driven parity and interleave code and
+ * the inline symbol storage: it counts parity bits, reverses an address
+ * byte per symbol, and copies each field into a std::string.
+ *
+ * @param state Range 0 is the batch size.
+ */
+static void BM_Reference(benchmark::State &state)
+{
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const Corpus &input = corpus();
+    std::vector<uint8_t> out(count * MSG_SIZE);
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            WsprReference::encode(std::string(input.callsigns[i]), std::string(input.locations[i]), input.powers[i],
+                                  out.data() + i * MSG_SIZE);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, count);
+}
+BENCHMARK(BM_Reference)->ArgName("size")->RangeMultiplier(8)->Range(1, 16384);
+
+/**
+ * @brief WsprParallelEncoder across all cores on a large batch.
+ */
+static void BM_Parallel(benchmark::State &state)
+{
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const Corpus &input = corpus();
+    static WsprParallelEncoder encoder(0);
+    std::vector<uint8_t> out(count * MSG_SIZE);
+    auto rows = reinterpret_cast<uint8_t(*)[MSG_SIZE]>(out.data());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(encoder.encode(input.callsigns.data(), input.locations.data(), input.powers.data(),
+                                                count, rows, nullptr));
+        benchmark::ClobberMemory();
+    }
+    state.counters["threads"] = encoder.threads();
+    report(state, count);
+}
+BENCHMARK(BM_Parallel)->ArgName("size")->Arg(65536)->UseRealTime();
+
+/**
+ * @brief WsprGpuEncoder into packed rows, on the device if one exists.
+ *
+ * The "device" counter is 1 when OpenCL was used, 0 for the CPU fallback.
+ */
+static void BM_GpuEncoder(benchmark::State &state)
+{
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const Corpus &input = corpus();
+    static WsprGpuEncoder encoder;
+    std::vector<uint8_t> out(count * WsprPackedSymbols::size);
+    auto rows = reinterpret_cast<uint8_t(*)[WsprPackedSymbols::size]>(out.data());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(encoder.encode(input.callsigns.data(), input.locations.data(), input.powers.data(),
+                                                count, rows, nullptr));
+        benchmark::ClobberMemory();
+    }
+    state.counters["device"] = encoder.backend() == WsprGpuBackend::opencl;
+    report(state, count);
+}
+BENCHMARK(BM_GpuEncoder)->ArgName("size")->Arg(65536)->UseRealTime();
+
+/**
+ * @brief A warm WsprCache hit.
+ */
+static void BM_CacheHit(benchmark::State &state)
+{
+    WsprCache cache(64);
+    WsprMessage::Symbols symbols;
+    cache.encode("AA0NT", "EM18", 20, symbols.data());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(cache.encode("AA0NT", "EM18", 20, symbols.data()));
+        benchmark::ClobberMemory();
+    }
+    report(state, 1);
+}
+BENCHMARK(BM_CacheHit);
+
+/**
+ * @brief WsprReverseIndex lookups of captured symbols from a 65536-station set.
+ *
+ * Each iteration looks up eight different captures, so the table probes
+ * are not all served from one cache line.
+ */
+static void BM_IndexFind(benchmark::State &state)
+{
+    const Corpus &input = corpus();
+    static const auto setup = [&input]() {
+        std::pair<WsprReverseIndex, std::vector<WsprMessage::Symbols>> s;
+        s.first.reserve(input.callsigns.size());
+        for (std::size_t i = 0; i < input.callsigns.size(); ++i)
+        {
+            s.first.insert(input.callsigns[i], input.locations[i], input.powers[i]);
+        }
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            s.second.push_back(WsprMessage::make_symbols(input.callsigns[i * 4099], input.locations[i * 4099],
+                                                         input.powers[i * 4099]));
+        }
+        return s;
+    }();
+    WsprPayload payload;
+    for (auto _ : state)
+    {
+        for (const WsprMessage::Symbols &capture : setup.second)
+        {
+            benchmark::DoNotOptimize(setup.first.find(capture.data(), payload));
+        }
+    }
+    report(state, setup.second.size());
+}
+BENCHMARK(BM_IndexFind);
+
+/**
+ * @brief A burst of WsprEncodeService requests, each message asked for four times.
+ *
+ * Every iteration uses fresh messages, so the repeats exercise coalescing
+ * rather than the cache.
+ */
+static void BM_ServiceBurst(benchmark::State &state)
+{
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const Corpus &input = corpus();
+    WsprEncodeService service;
+    std::vector<std::future<WsprEncodeResult>> futures(count);
+    std::size_t base = 0;
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::size_t m = (base + i / 4) & (input.callsigns.size() - 1);
+            futures[i] = service.submit(input.callsigns[m], input.locations[m], input.powers[m]);
+        }
+        for (std::future<WsprEncodeResult> &f : futures)
+        {
+            benchmark::DoNotOptimize(f.get());
+        }
+        base += count / 4;
+    }
+    const WsprEncodeService::Stats stats = service.stats();
+    state.counters["batch"] = stats.batches ? static_cast<double>(stats.encoded) / static_cast<double>(stats.batches) : 0.0;
+    report(state, count);
+}
+BENCHMARK(BM_ServiceBurst)->ArgName("requests")->Arg(4096)->UseRealTime();
+
+/**
+ * @brief Acquiring, encoding into, and releasing a pool slot.
+ */
+static void BM_PoolChurn(benchmark::State &state)
+{
+    WsprMessagePool pool(1024);
+    for (auto _ : state)
+    {
+        const WsprMessagePool::Handle handle = pool.encode("AA0NT", "EM18", 20);
+        benchmark::DoNotOptimize(pool.symbols(handle));
+        pool.release(handle);
+    }
+    report(state, 1);
+}
+BENCHMARK(BM_PoolChurn);
+
+/**
+ * @brief Sync correlation across a window of time offsets, per kernel.
+ *
+ * @param state The benchmark state; range(0) is the number of offsets.
+ * @param kernel The kernel to measure.
+ */
+static void BM_SyncSearch(benchmark::State &state, WsprKernel kernel)
+{
+    const std::size_t lags = static_cast<std::size_t>(state.range(0));
+    if (!WsprSimd::available(kernel))
+    {
+        state.SkipWithError("kernel not available on this CPU");
+        return;
+    }
+
+    std::vector<float> window(lags + MSG_SIZE - 1);
+    for (std::size_t i = 0; i < window.size(); ++i)
+    {
+        window[i] = static_cast<float>((i * 2654435761u) % 1000) / 500.0f - 1.0f;
+    }
+    std::vector<float> scores(lags);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(WsprReceiver::sync_search(window.data(), lags, scores.data(), kernel));
+        benchmark::ClobberMemory();
+    }
+    state.counters["offsets/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * static_cast<double>(lags),
+                                                     benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_SyncSearch, scalar, WsprKernel::scalar)->ArgName("lags")->Arg(1024);
+BENCHMARK_CAPTURE(BM_SyncSearch, avx2, WsprKernel::avx2)->ArgName("lags")->Arg(1024);
+BENCHMARK_CAPTURE(BM_SyncSearch, neon, WsprKernel::neon)->ArgName("lags")->Arg(1024);
+
+/**
+ * @brief Splitting tone powers and deinterleaving one candidate.
+ */
+static void BM_Demodulate(benchmark::State &state)
+{
+    std::vector<float> power(MSG_SIZE * WsprReceiver::tones);
+    for (std::size_t i = 0; i < power.size(); ++i)
+    {
+        power[i] = static_cast<float>(i % 7);
+    }
+    WsprReceiver::SoftSymbols sync, bits;
+    for (auto _ : state)
+    {
+        WsprReceiver::demodulate(power.data(), sync.data(), bits.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, 1);
+}
+BENCHMARK(BM_Demodulate);
+
+/**
+ * @brief Fano decoding of soft bits at a given noise level.
+ *
+ * @param state The benchmark state; range(0) is the noise standard deviation in soft units.
+ */
+static void BM_FanoDecode(benchmark::State &state)
+{
+    // A fixed set of noisy candidates, so every iteration does the same work
+    constexpr std::size_t candidates = 64;
+    const int noise = static_cast<int>(state.range(0));
+    std::vector<uint8_t> soft(candidates * MSG_SIZE);
+    uint32_t seed = 12345;
+    for (std::size_t c = 0; c < candidates; ++c)
+    {
+        WsprPayload payload;
+        WsprMessage::pack("AA0NT", "EM18", 20, payload);
+        payload.n = (payload.n + static_cast<uint32_t>(c) * 7919u) % 262177560u;
+        WsprMessage::Symbols symbols;
+        WsprMessage::encode_payload(payload, symbols.data());
+        uint8_t bits[MSG_SIZE];
+        WsprReceiver::deinterleave(symbols.data(), bits);
+        for (std::size_t i = 0; i < MSG_SIZE; ++i)
+        {
+            // Sum of uniforms, roughly Gaussian with the requested spread
+            int jitter = 0;
+            for (int k = 0; k < 4; ++k)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                jitter += static_cast<int>(seed >> 24) - 128;
+            }
+            const int value = 128 + (bits[i] ? 50 : -50) + jitter * noise / 148;
+            soft[c * MSG_SIZE + i] = static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+        }
+    }
+
+    WsprFanoDecoder decoder;
+    std::size_t c = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(decoder.decode(soft.data() + c * MSG_SIZE));
+        c = (c + 1) % candidates;
+    }
+    report(state, 1);
+}
+BENCHMARK(BM_FanoDecode)->ArgName("noise")->Arg(0)->Arg(30)->Arg(45);
+
+BENCHMARK_MAIN();
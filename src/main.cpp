@@ -24,7 +24,14 @@
  */
 
 #include "wspr_message.hpp"
+#include "wspr_stats.hpp"
+#include "wspr_stream.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <vector>
 
 /**
  * @brief Outputs WSPR symbol values to the console.
@@ -35,22 +42,147 @@
  * This function is typically used for debugging or verification of
  * symbol generation logic.
  *
- * @param symbols Pointer to the array of WSPR symbols to be printed.
- * @param count Number of symbols in the array.
+ * @param symbols View of the WSPR symbols to be printed.
  */
-void process_symbols(const uint8_t* symbols, std::size_t count)
+void process_symbols(WsprSpan<const uint8_t> symbols)
 {
-    for (std::size_t i = 0; i < count; ++i)
+    const char *separator = "";
+    for (uint8_t symbol : symbols)
     {
+        std::cout << separator << static_cast<int>(symbol);
+        separator = ","; // Comma before every element but the first
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Prints command-line usage.
+ *
+ * @param program The name the program was invoked as.
+ */
+void print_usage(const char *program)
+{
+    std::fprintf(stderr,
+                 "Usage: %s                          Run the encoding demo\n"
+                 "       %s [options] [input|-]      Encode records from a file or stdin\n"
+                 "\n"
+                 "Each input line holds a callsign, locator, and power level separated\n"
+                 "by commas or whitespace. Lines starting with '#' are ignored.\n"
+                 "\n"
+                 "Options:\n"
+                 "  -f, --format text|binary|json  Output format (default: text)\n"
+                 "  -o, --output FILE              Write to FILE instead of stdout\n"
+                 "  -j, --threads N                Encoding threads, 0 for all cores (default: 1)\n"
+                 "  -h, --help                     Show this help\n",
+                 program, program);
+}
+
+/**
+ * @brief Runs the streaming encoder from command-line arguments.
+ *
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return 0 on success, 1 on a usage or I/O error, 2 if any record was rejected.
+ */
+int run_stream(int argc, char *argv[])
+{
+    WsprStreamEncoder::Options options;
+    const char *input = nullptr;
+    const char *output = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const bool has_value = (i + 1 < argc);
+        if (std::strcmp(arg, "-h") == 0 || std::strcmp(arg, "--help") == 0)
+        {
+            print_usage(argv[0]);
+            return 0;
+        }
+        else if ((std::strcmp(arg, "-f") == 0 || std::strcmp(arg, "--format") == 0) && has_value)
         {
-            std::cout << static_cast<int>(symbols[i]);
-            if (i < count - 1)
+            const char *format = argv[++i];
+            if (std::strcmp(format, "text") == 0)
+            {
+                options.format = WsprStreamFormat::text;
+            }
+            else if (std::strcmp(format, "binary") == 0)
+            {
+                options.format = WsprStreamFormat::binary;
+            }
+            else if (std::strcmp(format, "json") == 0)
             {
-                std::cout << ","; // Append a comma except for the last element
+                options.format = WsprStreamFormat::json;
             }
+            else
+            {
+                std::fprintf(stderr, "Unknown format: %s\n", format);
+                return 1;
+            }
+        }
+        else if ((std::strcmp(arg, "-o") == 0 || std::strcmp(arg, "--output") == 0) && has_value)
+        {
+            output = argv[++i];
+        }
+        else if ((std::strcmp(arg, "-j") == 0 || std::strcmp(arg, "--threads") == 0) && has_value)
+        {
+            options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if ((arg[0] != '-' || std::strcmp(arg, "-") == 0) && input == nullptr)
+        {
+            input = arg;
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return 1;
         }
     }
-    std::cout << std::endl;
+
+    std::FILE *in = stdin;
+    if (input != nullptr && std::strcmp(input, "-") != 0)
+    {
+        in = std::fopen(input, "rb");
+        if (in == nullptr)
+        {
+            std::perror(input);
+            return 1;
+        }
+    }
+
+    std::FILE *out = stdout;
+    if (output != nullptr)
+    {
+        out = std::fopen(output, "wb");
+        if (out == nullptr)
+        {
+            std::perror(output);
+            if (in != stdin)
+            {
+                std::fclose(in);
+            }
+            return 1;
+        }
+    }
+
+    WsprStreamEncoder encoder(options);
+    const bool ok = encoder.run(in, out, stderr);
+
+    if (in != stdin)
+    {
+        std::fclose(in);
+    }
+    if (out != stdout && std::fclose(out) != 0)
+    {
+        std::perror(output);
+        return 1;
+    }
+    if (!ok)
+    {
+        std::fprintf(stderr, "I/O error while encoding.\n");
+        return 1;
+    }
+    return encoder.stats().rejected == 0 ? 0 : 2;
 }
 
 /**
@@ -61,7 +193,7 @@ void process_symbols(const uint8_t* symbols, std::size_t count)
  * @note This program initializes a WSPR message using a given callsign, grid locator,
  *       and power level, then outputs the generated WSPR symbols to the console.
  */
-int main()
+int run_demo()
 {
     // Define callsign, Maidenhead grid location, and power level
     std::string callsign = "AA0NT"; ///< Amateur radio callsign (uppercase, max 6 characters)
@@ -71,14 +203,58 @@ int main()
     // Create a WSPR message instance
     // WsprMessage wMessage(callsign, location, power);
     WsprMessage wMessage;
+#if WSPR_EXCEPTIONS
     wMessage.set_message_parameters(callsign, location, 20);
+#else
+    wMessage.try_set(callsign, location, 20);
+#endif
 
     // Display input parameters
     std::cout << "Callsign: " << callsign << std::endl;
     std::cout << "Location: " << location << std::endl;
     std::cout << "Power: " << power << " dBm" << std::endl;
 
-    process_symbols(wMessage.symbols, WsprMessage::size);
+    // Encode the same message at compile time and confirm both paths agree
+    constexpr WsprMessage::Symbols beacon = WsprMessage::make_symbols("AA0NT", "EM18", 20);
+    std::cout << "Compile-time encoding: " << (beacon == wMessage.symbols ? "matches" : "differs") << std::endl;
+
+    process_symbols(wMessage.view());
+
+    // Encode straight into an externally owned buffer, as a DMA region would be
+    std::vector<uint8_t> region(2 * WsprMessage::size);
+    WsprSymbolBlock block(WsprSpan<uint8_t>(region.data(), region.size()));
+    WsprMessage::try_encode(callsign, location, power, block[1].data());
+    std::cout << "External buffer encoding: " << (std::equal(wMessage.begin(), wMessage.end(), block[1].begin()) ? "matches" : "differs") << std::endl;
+
+    // The noexcept path reports bad input as a status instead of throwing
+    uint8_t scratch[MSG_SIZE];
+    std::cout << "Invalid power status: " << static_cast<int>(WsprMessage::try_encode(callsign, location, 21, scratch)) << std::endl;
+
+    if (WsprStats::enabled)
+    {
+        const WsprStatsSnapshot stats = WsprStats::snapshot();
+        std::cout << "Encodes: " << stats.encode.calls << ", mean " << stats.encode.mean_ns
+                  << " ns, max " << stats.encode.max_ns << " ns" << std::endl;
+    }
 
     return 0; // Indicate successful execution
 }
+
+/**
+ * @brief Program entry point.
+ *
+ * With no arguments the encoding demo runs; any argument selects the
+ * streaming encoder.
+ *
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return Process exit status.
+ */
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        return run_stream(argc, argv);
+    }
+    return run_demo();
+}
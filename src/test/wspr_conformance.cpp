@@ -0,0 +1,1359 @@
+/**
+ * @file wspr_conformance.cpp
+ * @brief Golden-vector and differential conformance checks for every encoding path.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_batch.hpp"
+#include "wspr_c.h"
+#include "wspr_cache.hpp"
+#include "wspr_fano.hpp"
+#include "wspr_gpu.hpp"
+#include "wspr_index.hpp"
+#include "wspr_message.hpp"
+#include "wspr_packed.hpp"
+#include "wspr_parallel.hpp"
+#include "wspr_pool.hpp"
+#include "wspr_receive.hpp"
+#include "wspr_reference.hpp"
+#include "wspr_schedule.hpp"
+#include "wspr_sequence.hpp"
+#include "wspr_service.hpp"
+#include "wspr_stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Compares a symbol array with a string of symbol digits.
+     *
+     * @param symbols The encoded symbols.
+     * @param digits MSG_SIZE characters '0'-'3'.
+     * @return True if every symbol matches.
+     */
+    constexpr bool matches(const WsprMessage::Symbols &symbols, const char *digits)
+    {
+        for (std::size_t i = 0; i < MSG_SIZE; ++i)
+        {
+            if (symbols[i] != digits[i] - '0')
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The compile-time encoder must agree with the reference before anything runs
+    static_assert(matches(WsprMessage::make_symbols("AA0NT", "EM18", 20),
+                          "132000023020111000302321113000022230012300222012112033210003103022213010303230030032332021321030223220203223221310310213010221110002210302110200222310303320011002"),
+                  "constexpr encoding of AA0NT EM18 20 differs from the golden vector");
+    static_assert(matches(WsprMessage::make_symbols("K1ABC", "FN42", 37),
+                          "330020001020131222100323133220200032012322002232110233210221321222033030301210212032132003323032203020201023021112330231212221332000010320132222202332323320031222"),
+                  "constexpr encoding of K1ABC FN42 37 differs from the golden vector");
+
+    /**
+     * @brief One message and its expected symbols.
+     */
+    struct Vector
+    {
+        std::string callsign;
+        std::string location;
+        int power;
+        WsprMessage::Symbols symbols;
+    };
+
+    /**
+     * @brief Runs one encoding path over a set of vectors and reports the result.
+     */
+    class Suite
+    {
+    public:
+        /**
+         * @brief Checks that a path reproduces every vector.
+         *
+         * @param name Path name for the report.
+         * @param vectors Inputs and expected symbols.
+         * @param encode Fills one output row per vector, in order.
+         */
+        void check(const std::string &name, const std::vector<Vector> &vectors,
+                   const std::function<void(const std::vector<Vector> &, std::vector<WsprMessage::Symbols> &)> &encode)
+        {
+            std::vector<WsprMessage::Symbols> out(vectors.size());
+            encode(vectors, out);
+
+            std::size_t mismatches = 0;
+            for (std::size_t i = 0; i < vectors.size(); ++i)
+            {
+                if (out[i] != vectors[i].symbols)
+                {
+                    if (mismatches++ < 5)
+                    {
+                        std::fprintf(stderr, "  %s: mismatch for %s %s %d\n", name.c_str(),
+                                     vectors[i].callsign.c_str(), vectors[i].location.c_str(), vectors[i].power);
+                    }
+                }
+            }
+            std::printf("%-32s %8zu checked, %zu mismatches\n", name.c_str(), vectors.size(), mismatches);
+            failures_ += mismatches;
+        }
+
+        /**
+         * @brief Records a failure that is not a symbol mismatch.
+         *
+         * @param what Description.
+         */
+        void fail(const std::string &what)
+        {
+            std::fprintf(stderr, "  %s\n", what.c_str());
+            ++failures_;
+        }
+
+        /**
+         * @brief Returns the total failure count.
+         *
+         * @return Failures so far.
+         */
+        std::size_t failures() const { return failures_; }
+
+    private:
+        std::size_t failures_ = 0;
+    };
+
+    /**
+     * @brief Loads the golden corpus.
+     *
+     * @param path The corpus file.
+     * @param vectors Receives the vectors.
+     * @return False if the file cannot be read or a line is malformed.
+     */
+    bool load_golden(const char *path, std::vector<Vector> &vectors)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            std::fprintf(stderr, "Cannot open golden corpus %s\n", path);
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+            std::istringstream fields(line);
+            Vector v;
+            std::string digits;
+            if (!(fields >> v.callsign >> v.location >> v.power >> digits) || digits.size() != MSG_SIZE)
+            {
+                std::fprintf(stderr, "Malformed golden line: %s\n", line.c_str());
+                return false;
+            }
+            for (std::size_t i = 0; i < MSG_SIZE; ++i)
+            {
+                v.symbols[i] = static_cast<uint8_t>(digits[i] - '0');
+            }
+            vectors.push_back(v);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Builds random valid Type 1 messages with reference encodings.
+     *
+     * @param count Number of messages.
+     * @param seed Generator seed.
+     * @return The vectors.
+     */
+    std::vector<Vector> random_vectors(std::size_t count, uint32_t seed)
+    {
+        static const int levels[] = {0, 3, 7, 10, 13, 17, 20, 23, 27, 30, 33, 37, 40, 43, 47, 50, 53, 57, 60};
+        std::mt19937 rng(seed);
+        auto letter = [&rng]() { return static_cast<char>((rng() & 1 ? 'A' : 'a') + rng() % 26); };
+        auto digit = [&rng]() { return static_cast<char>('0' + rng() % 10); };
+
+        std::vector<Vector> vectors(count);
+        for (Vector &v : vectors)
+        {
+            v.callsign.clear();
+            if (rng() & 1)
+            {
+                v.callsign += letter(); // Area digit second: "K1ABC"
+            }
+            else
+            {
+                v.callsign += (rng() % 3) ? letter() : digit(); // Area digit third: "AA0NT", "2E0ABC"
+                v.callsign += letter();
+            }
+            v.callsign += digit();
+            const std::size_t suffix = (v.callsign.size() == 2 ? 1 : 0) + rng() % 3;
+            for (std::size_t i = 0; i < suffix && v.callsign.size() < 6; ++i)
+            {
+                v.callsign += letter();
+            }
+
+            v.location.clear();
+            v.location += static_cast<char>((rng() & 1 ? 'A' : 'a') + rng() % 18);
+            v.location += static_cast<char>((rng() & 1 ? 'A' : 'a') + rng() % 18);
+            v.location += digit();
+            v.location += digit();
+            v.power = levels[rng() % (sizeof(levels) / sizeof(levels[0]))];
+
+            WsprReference::encode(v.callsign, v.location, v.power, v.symbols.data());
+        }
+        return vectors;
+    }
+
+    /**
+     * @brief Views the vectors as the parallel arrays the batch encoders take.
+     */
+    struct Columns
+    {
+        std::vector<std::string_view> callsigns;
+        std::vector<std::string_view> locations;
+        std::vector<int> powers;
+
+        /**
+         * @brief Builds the columns.
+         *
+         * @param vectors Source vectors; must outlive the columns.
+         */
+        explicit Columns(const std::vector<Vector> &vectors)
+        {
+            for (const Vector &v : vectors)
+            {
+                callsigns.push_back(v.callsign);
+                locations.push_back(v.location);
+                powers.push_back(v.power);
+            }
+        }
+    };
+
+    /**
+     * @brief Returns the output rows of a symbol vector.
+     *
+     * @param out The output vector.
+     * @return Row pointer for the batch encoders.
+     */
+    uint8_t (*rows(std::vector<WsprMessage::Symbols> &out))[MSG_SIZE]
+    {
+        static_assert(sizeof(WsprMessage::Symbols) == MSG_SIZE, "Symbols must be tightly packed");
+        return reinterpret_cast<uint8_t(*)[MSG_SIZE]>(out.data());
+    }
+
+    /**
+     * @brief Runs every encoding path against a set of vectors.
+     *
+     * @param suite The result collector.
+     * @param label Prefix for path names.
+     * @param vectors Inputs and expected symbols.
+     */
+    void check_paths(Suite &suite, const std::string &label, const std::vector<Vector> &vectors)
+    {
+        using Out = std::vector<WsprMessage::Symbols>;
+
+        for (const Vector &v : vectors)
+        {
+            if (WsprMessage::validate(v.callsign, v.location, v.power) != WsprStatus::ok)
+            {
+                suite.fail(label + ": vector rejected by validate(): " + v.callsign + " " + v.location);
+            }
+        }
+
+        if (label == "golden")
+        {
+            // Random vectors come from the reference, so only the corpus can check it
+            suite.check(label + "/reference", vectors, [](const std::vector<Vector> &in, Out &out) {
+                for (std::size_t i = 0; i < in.size(); ++i)
+                {
+                    WsprReference::encode(in[i].callsign, in[i].location, in[i].power, out[i].data());
+                }
+            });
+        }
+#if WSPR_EXCEPTIONS
+        suite.check(label + "/encode", vectors, [](const std::vector<Vector> &in, Out &out) {
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                WsprMessage::encode(in[i].callsign, in[i].location, in[i].power, out[i].data());
+            }
+        });
+        suite.check(label + "/set_message_parameters", vectors, [](const std::vector<Vector> &in, Out &out) {
+            WsprMessage message;
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                out[i] = message.set_message_parameters(in[i].callsign, in[i].location, in[i].power).symbols;
+            }
+        });
+#endif
+        suite.check(label + "/try_encode", vectors, [](const std::vector<Vector> &in, Out &out) {
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                WsprMessage::try_encode(in[i].callsign, in[i].location, in[i].power, out[i].data());
+            }
+        });
+        suite.check(label + "/make_symbols", vectors, [](const std::vector<Vector> &in, Out &out) {
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                out[i] = WsprMessage::make_symbols(in[i].callsign, in[i].location, in[i].power);
+            }
+        });
+        suite.check(label + "/pack+encode_payload", vectors, [](const std::vector<Vector> &in, Out &out) {
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                WsprPayload payload;
+                WsprMessage::pack(in[i].callsign, in[i].location, in[i].power, payload);
+                WsprMessage::encode_payload(WsprPayload::from_key(payload.key()), out[i].data());
+            }
+        });
+        suite.check(label + "/set_power", vectors, [](const std::vector<Vector> &in, Out &out) {
+            // Encode each message at its neighbour's power, then step to its own
+            WsprMessage message;
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                message.try_set(in[i].callsign, in[i].location, in[(i + in.size() - 1) % in.size()].power);
+                message.set_power(in[i].power);
+                out[i] = message.symbols;
+            }
+        });
+        suite.check(label + "/reencode_power", vectors, [](const std::vector<Vector> &in, Out &out) {
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                WsprPayload payload;
+                WsprMessage::pack(in[i].callsign, in[i].location, in[(i + 1) % in.size()].power, payload);
+                WsprMessage::encode_payload(payload, out[i].data());
+                WsprMessage::reencode_power(payload, in[i].power, out[i].data());
+            }
+        });
+
+        const Columns columns(vectors);
+        const struct
+        {
+            WsprKernel kernel;
+            const char *name;
+        } kernels[] = {{WsprKernel::scalar, "scalar"}, {WsprKernel::avx2, "avx2"}, {WsprKernel::neon, "neon"}};
+        for (const auto &k : kernels)
+        {
+            if (!WsprSimd::available(k.kernel))
+            {
+                std::printf("%-32s skipped (not available)\n", (label + "/batch/" + k.name).c_str());
+                continue;
+            }
+            suite.check(label + "/batch/" + k.name, vectors, [&](const std::vector<Vector> &in, Out &out) {
+                WsprBatch::encode(columns.callsigns.data(), columns.locations.data(), columns.powers.data(),
+                                  in.size(), rows(out), nullptr, k.kernel);
+            });
+            suite.check(label + "/encode_payloads/" + k.name, vectors, [&](const std::vector<Vector> &in, Out &out) {
+                std::vector<WsprPayload> payloads(in.size());
+                for (std::size_t i = 0; i < in.size(); ++i)
+                {
+                    WsprMessage::pack(in[i].callsign, in[i].location, in[i].power, payloads[i]);
+                }
+                WsprBatch::encode_payloads(payloads.data(), in.size(), rows(out), k.kernel);
+            });
+        }
+
+        suite.check(label + "/parallel", vectors, [&](const std::vector<Vector> &in, Out &out) {
+            WsprParallelEncoder encoder(3, 64);
+            encoder.encode(columns.callsigns.data(), columns.locations.data(), columns.powers.data(),
+                           in.size(), rows(out), nullptr);
+        });
+        suite.check(label + "/cache", vectors, [](const std::vector<Vector> &in, Out &out) {
+            // A small cache so the run mixes misses, hits, and evictions
+            WsprCache cache(16);
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                cache.encode(in[i].callsign, in[i].location, in[i].power, out[i].data());
+                const std::size_t back = i - (i % 8);
+                cache.encode(in[back].callsign, in[back].location, in[back].power, out[back].data());
+            }
+        });
+        suite.check(label + "/packed", vectors, [](const std::vector<Vector> &in, Out &out) {
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                out[i] = WsprPackedSymbols::unpack(WsprPackedSymbols::pack(in[i].symbols));
+            }
+        });
+        suite.check(label + "/c/encode", vectors, [](const std::vector<Vector> &in, Out &out) {
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                wspr_encode(in[i].callsign.c_str(), in[i].location.c_str(), in[i].power, out[i].data());
+            }
+        });
+        suite.check(label + "/c/encode_batch", vectors, [](const std::vector<Vector> &in, Out &out) {
+            std::vector<const char *> callsigns(in.size());
+            std::vector<const char *> locators(in.size());
+            std::vector<int> powers(in.size());
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                callsigns[i] = in[i].callsign.c_str();
+                locators[i] = in[i].location.c_str();
+                powers[i] = in[i].power;
+            }
+            wspr_encode_batch(callsigns.data(), locators.data(), powers.data(), in.size(), out[0].data(), nullptr);
+        });
+        suite.check(label + "/c/encode_packed", vectors, [](const std::vector<Vector> &in, Out &out) {
+            uint8_t packed[WSPR_PACKED_SIZE];
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                wspr_encode_packed(in[i].callsign.c_str(), in[i].location.c_str(), in[i].power, packed);
+                WsprPackedSymbols::unpack(packed, out[i].data());
+            }
+        });
+        const auto offload = [&](const char *name, auto &&encode) {
+            suite.check(label + "/gpu/" + name, vectors, [&](const std::vector<Vector> &in, Out &out) {
+                std::vector<WsprPackedSymbols::Packed> packed(in.size());
+                encode(reinterpret_cast<uint8_t(*)[WsprPackedSymbols::size]>(packed.data()));
+                for (std::size_t i = 0; i < in.size(); ++i)
+                {
+                    WsprPackedSymbols::unpack(packed[i].data(), out[i].data());
+                }
+            });
+        };
+        offload("emulate", [&](uint8_t (*packed)[WsprPackedSymbols::size]) {
+            WsprGpuEncoder::emulate(columns.callsigns.data(), columns.locations.data(), columns.powers.data(),
+                                    vectors.size(), packed, nullptr);
+        });
+        offload("cpu", [&](uint8_t (*packed)[WsprPackedSymbols::size]) {
+            WsprGpuEncoder encoder(WsprGpuBackend::cpu);
+            encoder.encode(columns.callsigns.data(), columns.locations.data(), columns.powers.data(),
+                           vectors.size(), packed, nullptr);
+        });
+        offload("encoder", [&](uint8_t (*packed)[WsprPackedSymbols::size]) {
+            // Whatever backend this machine offers, with a chunk small enough to split the run
+            WsprGpuEncoder encoder(WsprGpuBackend::opencl, 1000);
+            encoder.encode(columns.callsigns.data(), columns.locations.data(), columns.powers.data(),
+                           vectors.size(), packed, nullptr);
+        });
+        const auto reverse = [&](const char *name, auto &&find) {
+            suite.check(label + "/index/" + name, vectors, [&](const std::vector<Vector> &in, Out &out) {
+                // Half inserted in bulk, half one at a time
+                std::vector<WsprPayload> payloads(in.size());
+                for (std::size_t i = 0; i < in.size(); ++i)
+                {
+                    WsprMessage::pack(in[i].callsign, in[i].location, in[i].power, payloads[i]);
+                }
+                WsprReverseIndex index;
+                index.insert(payloads.data(), in.size() / 2);
+                for (std::size_t i = in.size() / 2; i < in.size(); ++i)
+                {
+                    index.insert(in[i].callsign, in[i].location, in[i].power);
+                }
+                for (std::size_t i = 0; i < in.size(); ++i)
+                {
+                    WsprPayload payload;
+                    if (find(index, in[i].symbols, payload))
+                    {
+                        WsprMessage::encode_payload(payload, out[i].data());
+                    }
+                }
+            });
+        };
+        reverse("symbols", [](const WsprReverseIndex &index, const WsprMessage::Symbols &symbols, WsprPayload &payload) {
+            return index.find(symbols.data(), payload);
+        });
+        reverse("packed", [](const WsprReverseIndex &index, const WsprMessage::Symbols &symbols, WsprPayload &payload) {
+            return index.find_packed(WsprPackedSymbols::pack(symbols).data(), payload);
+        });
+        reverse("bits", [](const WsprReverseIndex &index, const WsprMessage::Symbols &symbols, WsprPayload &payload) {
+            uint8_t bits[MSG_SIZE];
+            for (std::size_t i = 0; i < MSG_SIZE; ++i)
+            {
+                bits[i] = symbols[i] >> 1;
+            }
+            return index.find_bits(bits, payload);
+        });
+        suite.check(label + "/service/future", vectors, [](const std::vector<Vector> &in, Out &out) {
+            // Every message is asked for twice, so half the requests coalesce or hit
+            WsprEncodeService::Options options;
+            options.cache_capacity = 64;
+            WsprEncodeService service(options);
+            std::vector<std::future<WsprEncodeResult>> futures;
+            futures.reserve(2 * in.size());
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                futures.push_back(service.submit(in[i].callsign, in[i].location, in[i].power));
+                const std::size_t back = i - (i % 4);
+                futures.push_back(service.submit(in[back].callsign, in[back].location, in[back].power));
+            }
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                out[i] = futures[2 * i].get().symbols;
+                if (futures[2 * i + 1].get().symbols != out[i - (i % 4)])
+                {
+                    out[i].fill(0);
+                }
+            }
+        });
+        suite.check(label + "/service/callback", vectors, [](const std::vector<Vector> &in, Out &out) {
+            std::atomic<std::size_t> done{0};
+            {
+                WsprEncodeService service;
+                for (std::size_t i = 0; i < in.size(); ++i)
+                {
+                    service.submit(in[i].callsign, in[i].location, in[i].power, [&out, &done, i](const WsprEncodeResult &r) {
+                        out[i] = r.symbols;
+                        done.fetch_add(1, std::memory_order_relaxed);
+                    });
+                }
+            } // Destruction completes everything still queued
+            if (done.load() != in.size())
+            {
+                std::fill(out.begin(), out.end(), WsprMessage::Symbols{});
+            }
+        });
+        suite.check(label + "/pool", vectors, [](const std::vector<Vector> &in, Out &out) {
+            // Every other slot is freed and re-encoded, so reused slots are checked too
+            WsprMessagePool pool(in.size());
+            std::vector<WsprMessagePool::Handle> handles(in.size());
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                handles[i] = pool.encode(in[i].callsign, in[i].location, in[i].power);
+            }
+            for (std::size_t i = 0; i < in.size(); i += 2)
+            {
+                pool.release(handles[i]);
+            }
+            for (std::size_t i = 0; i < in.size(); i += 2)
+            {
+                WsprPooledMessage message(pool);
+                message.set(in[i].callsign, in[i].location, in[i].power);
+                handles[i] = message.handle();
+                std::copy(message.view().begin(), message.view().end(), out[i].begin());
+            }
+            for (std::size_t i = 1; i < in.size(); i += 2)
+            {
+                std::copy(pool.view(handles[i]).begin(), pool.view(handles[i]).end(), out[i].begin());
+            }
+        });
+        suite.check(label + "/sequence", vectors, [](const std::vector<Vector> &in, Out &out) {
+            WsprMessageSequence sequence;
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                sequence.set(in[i].callsign, in[i].location, in[i].power);
+                out[i] = sequence.symbols(0);
+            }
+        });
+
+        // The receive side must invert the channel mapping exactly
+        suite.check(label + "/receive/hard", vectors, [](const std::vector<Vector> &in, Out &out) {
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                uint8_t bits[MSG_SIZE];
+                WsprReceiver::deinterleave(in[i].symbols.data(), bits);
+                for (std::size_t k = 0; k < MSG_SIZE; ++k)
+                {
+                    const uint8_t position = WsprMessage::interleave_table[k];
+                    out[i][position] = static_cast<uint8_t>(WsprMessage::sync_vector[position] + 2 * bits[k]);
+                }
+                if (WsprReceiver::sync_errors(in[i].symbols.data()) != 0)
+                {
+                    out[i].fill(0xFF);
+                }
+            }
+        });
+        suite.check(label + "/receive/soft", vectors, [](const std::vector<Vector> &in, Out &out) {
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                // One unit of power in the transmitted tone, none in the others
+                float power[MSG_SIZE * WsprReceiver::tones] = {};
+                for (std::size_t p = 0; p < MSG_SIZE; ++p)
+                {
+                    power[p * WsprReceiver::tones + in[i].symbols[p]] = 1.0f;
+                }
+
+                WsprReceiver::SoftSymbols sync, data, split_bits, bits;
+                WsprReceiver::split_tones(power, sync.data(), data.data());
+                WsprReceiver::deinterleave(data.data(), split_bits.data());
+                WsprReceiver::demodulate(power, nullptr, bits.data());
+                for (std::size_t k = 0; k < MSG_SIZE; ++k)
+                {
+                    const uint8_t position = WsprMessage::interleave_table[k];
+                    out[i][position] = static_cast<uint8_t>((sync[position] > 0) + 2 * (bits[k] > 0));
+                }
+                if (bits != split_bits || WsprReceiver::sync_correlation(sync.data()) != float(MSG_SIZE))
+                {
+                    out[i].fill(0xFF);
+                }
+            }
+        });
+        suite.check(label + "/receive/fano", vectors, [](const std::vector<Vector> &in, Out &out) {
+            // Noncoherent 4-FSK tone magnitudes with Gaussian noise, well above the decoding threshold
+            std::mt19937 rng(0x46414e4fu);
+            std::normal_distribution<float> noise(0.0f, 0.3f);
+            WsprFanoDecoder decoder;
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                float power[MSG_SIZE * WsprReceiver::tones];
+                for (std::size_t p = 0; p < MSG_SIZE; ++p)
+                {
+                    for (std::size_t tone = 0; tone < WsprReceiver::tones; ++tone)
+                    {
+                        const float re = (tone == in[i].symbols[p] ? 1.0f : 0.0f) + noise(rng);
+                        const float im = noise(rng);
+                        power[p * WsprReceiver::tones + tone] = std::sqrt(re * re + im * im);
+                    }
+                }
+                WsprReceiver::SoftSymbols bits;
+                WsprReceiver::demodulate(power, nullptr, bits.data());
+                const WsprFanoDecoder::Result result = decoder.decode(bits.data());
+                if (result.status == WsprDecodeStatus::ok)
+                {
+                    WsprMessage::encode_payload(result.payload, out[i].data());
+                }
+                else
+                {
+                    out[i].fill(0xFF);
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Checks that every sync search kernel finds a buried message and agrees with the scalar scores.
+     *
+     * @param suite The result collector.
+     */
+    void check_sync_search(Suite &suite)
+    {
+        std::mt19937 rng(0x53594e43u);
+        std::normal_distribution<float> noise(0.0f, 1.0f);
+
+        const std::size_t lags = 301; // Uneven, so every kernel runs its tail
+        const std::size_t offset = 117;
+        std::vector<float> window(lags + MSG_SIZE - 1);
+        for (float &value : window)
+        {
+            value = noise(rng);
+        }
+        for (std::size_t i = 0; i < MSG_SIZE; ++i)
+        {
+            window[offset + i] += 2.0f * WsprReceiver::sync_pattern[i];
+        }
+
+        std::vector<float> expected(lags);
+        for (std::size_t lag = 0; lag < lags; ++lag)
+        {
+            expected[lag] = WsprReceiver::sync_correlation(window.data() + lag);
+        }
+
+        for (WsprKernel kernel : {WsprKernel::scalar, WsprKernel::avx2, WsprKernel::neon})
+        {
+            if (!WsprSimd::available(kernel))
+            {
+                continue;
+            }
+            std::vector<float> scores(lags);
+            const std::size_t best = WsprReceiver::sync_search(window.data(), lags, scores.data(), kernel);
+            const std::size_t best_only = WsprReceiver::sync_search(window.data(), lags, nullptr, kernel);
+            if (best != offset || best_only != offset || scores != expected)
+            {
+                suite.fail("sync_search kernel " + std::to_string(static_cast<int>(kernel)) + " disagrees with the scalar scores");
+            }
+        }
+        std::printf("%-32s %8zu offsets checked\n", "sync_search", lags);
+    }
+
+    /**
+     * @brief Checks that the Fano decoder stops at its cycle and time budgets.
+     *
+     * @param suite The result collector.
+     */
+    void check_fano_budget(Suite &suite)
+    {
+        // Pure noise never reaches the end of the tree
+        std::mt19937 rng(0x4255444bu);
+        uint8_t soft[MSG_SIZE];
+        for (uint8_t &value : soft)
+        {
+            value = static_cast<uint8_t>(rng());
+        }
+
+        WsprFanoDecoder::Options options;
+        options.max_cycles = 50;
+        WsprFanoDecoder limited(options);
+        const WsprFanoDecoder::Result by_cycles = limited.decode(soft);
+        if (by_cycles.status != WsprDecodeStatus::cycle_limit || by_cycles.cycles != 50 * WsprFanoDecoder::bits)
+        {
+            suite.fail("Fano decoder ignored its cycle budget");
+        }
+
+        options.max_cycles = 1000000000;
+        options.timeout = std::chrono::microseconds(2000);
+        WsprFanoDecoder timed(options);
+        const auto start = std::chrono::steady_clock::now();
+        const WsprFanoDecoder::Result by_time = timed.decode(soft);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        if (by_time.status != WsprDecodeStatus::timeout || elapsed > std::chrono::milliseconds(500))
+        {
+            suite.fail("Fano decoder ignored its timeout");
+        }
+        std::printf("%-32s %8s\n", "fano budgets", "checked");
+    }
+
+    /**
+     * @brief Checks message planning for each callsign and locator combination.
+     *
+     * @param suite The result collector.
+     */
+    void check_sequence(Suite &suite)
+    {
+        struct Case
+        {
+            const char *callsign;
+            const char *location;
+            WsprStatus status;
+            std::size_t count;
+            WsprMessageType second;
+        };
+        const Case cases[] = {
+            {"K1ABC", "FN42", WsprStatus::ok, 1, WsprMessageType::type1},
+            {"K1ABC", "FN42hn", WsprStatus::ok, 2, WsprMessageType::type3},
+            {"PJ4/K1ABC", "FN42hn", WsprStatus::ok, 2, WsprMessageType::type3},
+            {"PJ4/K1ABC", "FN42", WsprStatus::invalid_locator, 0, WsprMessageType::type1},
+            {"PJ4/K1ABC", "ZZZZ", WsprStatus::invalid_locator, 0, WsprMessageType::type1},
+            {"PJ4/K1ABC", "ZZ42hn", WsprStatus::invalid_locator, 0, WsprMessageType::type1},
+            {"K1ABC", "ZZZZ", WsprStatus::invalid_locator, 0, WsprMessageType::type1},
+            {"K1ABC", "FN42zz", WsprStatus::invalid_locator, 0, WsprMessageType::type1},
+        };
+
+        std::size_t wrong = 0;
+        WsprMessageSequence sequence;
+        for (const Case &c : cases)
+        {
+            const bool planned = sequence.set(c.callsign, c.location, 37) == c.status && sequence.count() == c.count &&
+                                 (c.count < 2 || sequence.type(1) == c.second);
+            wrong += !planned;
+        }
+        if (wrong != 0)
+        {
+            suite.fail("message sequence planning is wrong");
+        }
+        std::printf("%-32s %8zu cases checked\n", "message sequences", sizeof(cases) / sizeof(cases[0]));
+    }
+
+    /**
+     * @brief Checks the schedule plan's rotation and the slot ring under a concurrent producer.
+     *
+     * @param suite The result collector.
+     */
+    void check_schedule(Suite &suite)
+    {
+        WsprSchedulePlan plan;
+        plan.add_message("PJ4/K1ABC", "FN42hn", 37); // Type 2 then Type 3
+        plan.add_message("AA0NT", "EM18", 20);
+        plan.set_power_steps({37, 23});
+        plan.set_bands({14097100.0, 7040100.0, 10140200.0});
+        plan.set_tuning(WsprTuningModel::dds(125e6));
+        if (plan.prepare() != WsprStatus::ok || plan.rotation() != 3)
+        {
+            suite.fail("schedule plan failed to prepare");
+            return;
+        }
+
+        // Slot n: transmission n % 3, power step (n / 3) % 2, band (n / 6) % 3
+        WsprMessageSequence compound;
+        compound.set("PJ4/K1ABC", "FN42hn", 23);
+        WsprSlot slot;
+        plan.slot(10, slot);
+        WsprToneWords::ToneTable table;
+        WsprToneWords::make_tone_table(WsprToneWords::base_from_center(7040100.0), WsprTuningModel::dds(125e6), table);
+        if (slot.type != WsprMessageType::type3 || slot.power != 23 || slot.band != 1 ||
+            slot.symbols != compound.symbols(1) || slot.words != WsprToneWords::map(slot.symbols, table))
+        {
+            suite.fail("schedule slot 10 has the wrong content");
+        }
+        WsprSlot first_half;
+        plan.slot(9, first_half); // The Type 2 half goes out on the same band as its Type 3
+        if (first_half.type != WsprMessageType::type2 || first_half.band != slot.band)
+        {
+            suite.fail("schedule split a two-part message across bands");
+        }
+        plan.slot(-1, slot); // Before the epoch the rotation runs backwards consistently
+        if (slot.message != 1 || slot.power != 23 || slot.band != 2 ||
+            slot.symbols != WsprMessage::make_symbols("AA0NT", "EM18", 23))
+        {
+            suite.fail("schedule slot -1 has the wrong content");
+        }
+
+        // Over P * B rotations every transmission uses every (power, band) pair
+        bool visits_all = true;
+        for (int64_t t = 0; t < 3; ++t)
+        {
+            unsigned seen = 0;
+            for (int64_t r = 0; r < 2 * 3; ++r)
+            {
+                plan.slot(r * 3 + t, slot);
+                seen |= 1u << ((slot.power == 23 ? 3 : 0) + slot.band);
+            }
+            visits_all = visits_all && seen == 0x3F;
+        }
+        if (!visits_all)
+        {
+            suite.fail("schedule skips some (power, band) pairs");
+        }
+
+        WsprSchedulePlan bad = plan;
+        bad.set_power_steps({21});
+        WsprSchedulePlan out_of_range = plan;
+        out_of_range.set_tuning(WsprTuningModel::dds(1e6, 16));
+        if (bad.prepare() != WsprStatus::invalid_power || out_of_range.prepare() != WsprStatus::invalid_frequency)
+        {
+            suite.fail("schedule plan accepted an invalid power step or band");
+        }
+
+        // A producer thread races the consumer through many wraps of a small ring
+        constexpr int64_t slots = 20000;
+        WsprScheduler scheduler(plan, 4);
+        std::atomic<bool> done{false};
+        std::thread producer([&]() {
+            while (!done.load(std::memory_order_relaxed))
+            {
+                scheduler.fill(0);
+            }
+        });
+        std::size_t wrong = 0;
+        for (int64_t index = 0; index < slots; ++index)
+        {
+            const WsprSlot *next;
+            while ((next = scheduler.acquire(index)) == nullptr)
+            {
+                std::this_thread::yield();
+            }
+            plan.slot(index, slot);
+            wrong += next->symbols != slot.symbols || next->words != slot.words || next->index != index;
+            scheduler.release();
+        }
+        done = true;
+        producer.join();
+
+        // A late consumer drops the slots whose time has passed
+        WsprScheduler late(plan, 8);
+        late.fill(100);
+        const WsprSlot *jump = late.acquire(105);
+        if (wrong != 0 || jump == nullptr || jump->index != 105 || late.stats().skipped != 5)
+        {
+            suite.fail("scheduler delivered wrong or out-of-order slots");
+        }
+        std::printf("%-32s %8lld slots checked\n", "schedule", static_cast<long long>(slots));
+    }
+
+    /**
+     * @brief Checks set_power() against full encodes for every pair of levels, and its rejections.
+     *
+     * @param suite The result collector.
+     */
+    void check_set_power(Suite &suite)
+    {
+        WsprMessage message;
+        const bool unset = message.set_power(23) == WsprStatus::invalid_callsign;
+
+        message.try_set("AA0NT", "EM18", 20);
+        const WsprMessage::Symbols before = message.symbols;
+        const bool rejected = message.set_power(21) == WsprStatus::invalid_power && message.symbols == before;
+
+        // Every level from every starting level, round trip included
+        bool matches = true;
+        for (int from = 0; from <= 60; ++from)
+        {
+            if (message.try_set("AA0NT", "EM18", from) != WsprStatus::ok)
+            {
+                continue;
+            }
+            for (int to = 0; to <= 60; ++to)
+            {
+                if (message.set_power(to) == WsprStatus::ok)
+                {
+                    matches = matches && message.symbols == WsprMessage::make_symbols("AA0NT", "EM18", to);
+                }
+            }
+        }
+
+#if WSPR_EXCEPTIONS
+        WsprMessage constructed("aa0nt", "em18", 20);
+        matches = matches && constructed.set_power(37) == WsprStatus::ok &&
+                  constructed.symbols == WsprMessage::make_symbols("AA0NT", "EM18", 37);
+#endif
+
+        // A message filled through the cache re-encodes from its new callsign, on a miss and on a hit
+        WsprCache cache(4);
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            WsprMessage cached;
+            cached.try_set("AA0NT", "EM18", 20);
+            matches = matches && cache.encode("K1ABC", "FN42", 37, cached) == WsprStatus::ok &&
+                      cached.symbols == WsprMessage::make_symbols("K1ABC", "FN42", 37) &&
+                      cached.set_power(30) == WsprStatus::ok &&
+                      cached.symbols == WsprMessage::make_symbols("K1ABC", "FN42", 30);
+        }
+        WsprMessage adopted;
+        const bool foreign = adopted.adopt(WsprPayload{}) == WsprStatus::invalid_power &&
+                             adopted.set_power(30) == WsprStatus::invalid_callsign;
+
+        if (!unset || !rejected || !matches || !foreign)
+        {
+            suite.fail("set_power() disagrees with a full encode");
+        }
+        std::printf("%-32s %8s\n", "power-only re-encode", "checked");
+    }
+
+    /**
+     * @brief Checks the C interface's status codes, batch results, and ABI version.
+     *
+     * @param suite The result collector.
+     */
+    void check_c_status(Suite &suite)
+    {
+        uint8_t symbols[WSPR_SYMBOL_COUNT] = {};
+        const char *callsigns[] = {"AA0NT", nullptr, "K1ABC", "K1ABC"};
+        const char *locators[] = {"EM18", "EM18", "EM1", "FN42"};
+        const int powers[] = {20, 20, 20, 21};
+        int status[4] = {};
+        uint8_t rows[4][WSPR_SYMBOL_COUNT];
+
+        const bool single = wspr_encode(nullptr, "EM18", 20, symbols) == WSPR_INVALID_ARGUMENT &&
+                            wspr_encode("AA0NT", "EM18", 21, symbols) == WSPR_INVALID_POWER &&
+                            wspr_encode_packed("AA0NT", "EM1", 20, symbols) == WSPR_INVALID_LOCATOR;
+        const bool batch = wspr_encode_batch(callsigns, locators, powers, 4, rows[0], status) == 1 &&
+                           status[0] == WSPR_OK && status[1] == WSPR_INVALID_CALLSIGN &&
+                           status[2] == WSPR_INVALID_LOCATOR && status[3] == WSPR_INVALID_POWER;
+
+        if (!single || !batch || wspr_abi_version() != WSPR_ABI_VERSION ||
+            std::strcmp(wspr_status_string(WSPR_INVALID_POWER), "invalid power") != 0)
+        {
+            suite.fail("C interface status handling is wrong");
+        }
+        std::printf("%-32s %8s\n", "C interface status", "checked");
+    }
+
+    /**
+     * @brief Checks that the emulated kernel, the CPU path, and the encoder agree on edge cases.
+     *
+     * @param suite The result collector.
+     */
+    void check_gpu(Suite &suite)
+    {
+        const std::string_view callsigns[] = {"aa0nt", "", "K1ABC", "K1ABC", "KK1ABCD", "K1 BC", "AA0NT"};
+        const std::string_view locators[] = {"em18", "EM18", "EM1", "FN42", "FN42", "FN42", "SM18"};
+        const int powers[] = {20, 20, 20, 21, 20, 20, 20};
+        constexpr std::size_t count = sizeof(powers) / sizeof(powers[0]);
+        uint8_t emulated[count][WsprPackedSymbols::size];
+        uint8_t cpu[count][WsprPackedSymbols::size];
+        uint8_t device[count][WsprPackedSymbols::size];
+        WsprStatus emulated_status[count];
+        WsprStatus cpu_status[count];
+        WsprStatus device_status[count];
+
+        WsprGpuEncoder encoder;
+        const bool counts = WsprGpuEncoder::emulate(callsigns, locators, powers, count, emulated, emulated_status) == 1 &&
+                            WsprGpuEncoder::encode_cpu(callsigns, locators, powers, count, cpu, cpu_status) == 1 &&
+                            encoder.encode(callsigns, locators, powers, count, device, device_status) == 1;
+        const bool statuses = std::equal(emulated_status, emulated_status + count, cpu_status) &&
+                              std::equal(emulated_status, emulated_status + count, device_status) &&
+                              emulated_status[1] == WsprStatus::invalid_callsign &&
+                              emulated_status[2] == WsprStatus::invalid_locator &&
+                              emulated_status[3] == WsprStatus::invalid_power &&
+                              emulated_status[4] == WsprStatus::invalid_callsign &&
+                              emulated_status[5] == WsprStatus::invalid_callsign &&
+                              emulated_status[6] == WsprStatus::invalid_locator;
+        const bool rows = std::memcmp(emulated[0], cpu[0], WsprPackedSymbols::size) == 0 &&
+                          std::memcmp(emulated[0], device[0], WsprPackedSymbols::size) == 0;
+
+        if (!counts || !statuses || !rows || std::strstr(WsprGpuEncoder::kernel_source(), "wspr_encode") == nullptr)
+        {
+            suite.fail("offload encoder status handling is wrong");
+        }
+        std::printf("%-32s %8s (%s)\n", "offload status", "checked", encoder.device().c_str());
+    }
+
+    /**
+     * @brief Checks reverse index lookups, duplicates, and serialization round trips.
+     *
+     * @param suite The result collector.
+     * @param vectors Messages to index.
+     */
+    void check_index(Suite &suite, const std::vector<Vector> &vectors)
+    {
+        WsprReverseIndex index;
+        for (const Vector &v : vectors)
+        {
+            index.insert(v.callsign, v.location, v.power);
+        }
+        const std::size_t unique = index.size();
+        index.insert(vectors[0].callsign, vectors[0].location, vectors[0].power); // Duplicates are ignored
+
+        // Every hit unpacks to fields that pack back to the same payload
+        bool fields_ok = index.size() == unique;
+        for (const Vector &v : vectors)
+        {
+            WsprPayload found;
+            WsprPayload expected;
+            WsprFields fields;
+            WsprMessage::pack(v.callsign, v.location, v.power, expected);
+            WsprPayload repacked;
+            fields_ok = fields_ok && index.find(v.symbols.data(), found) && found == expected &&
+                        WsprReverseIndex::unpack(found, fields) && fields.power == v.power &&
+                        WsprMessage::pack(fields.callsign.data(), fields.locator.data(), fields.power, repacked) ==
+                            WsprStatus::ok &&
+                        repacked == expected;
+        }
+
+        // Sync bits are ignored; a single data bit error misses
+        WsprMessage::Symbols symbols = vectors[0].symbols;
+        WsprPayload found;
+        for (uint8_t &s : symbols)
+        {
+            s ^= 1;
+        }
+        const bool sync_ignored = index.find(symbols.data(), found);
+        symbols[17] ^= 2;
+        const bool corrupt_misses = !index.find(symbols.data(), found);
+
+        // A Type 3 payload can be indexed but does not unpack as Type 1
+        WsprMessageSequence sequence;
+        sequence.set("PJ4/K1ABC", "FK52UD", 37);
+        std::vector<WsprPayload> payloads(sequence.count());
+        for (std::size_t i = 0; i < sequence.count(); ++i)
+        {
+            payloads[i] = sequence.payload(i);
+        }
+        WsprFields fields;
+        index.insert(payloads.back());
+        uint8_t encoded[MSG_SIZE];
+        WsprMessage::encode_payload(payloads.back(), encoded);
+        const bool type3 = index.find(encoded, found) && found == payloads.back() &&
+                           !WsprReverseIndex::unpack(found, fields);
+
+        // The serialized form round trips and rejects damage
+        const std::vector<uint8_t> bytes = index.serialize();
+        WsprReverseIndex loaded;
+        const bool compact = bytes.size() == WsprReverseIndex::header_size + index.size() * WsprPayload::byte_size;
+        const bool round_trip = loaded.deserialize(bytes.data(), bytes.size()) && loaded.size() == index.size() &&
+                                loaded.serialize() == bytes && loaded.find(vectors.back().symbols.data(), found);
+        std::vector<uint8_t> damaged(bytes.begin(), bytes.end() - 1);
+        const bool rejected = !loaded.deserialize(damaged.data(), damaged.size()) && loaded.size() == index.size() &&
+                              !loaded.deserialize(nullptr, 0);
+        loaded.clear();
+        const bool cleared = loaded.size() == 0 && !loaded.find(vectors[0].symbols.data(), found);
+
+        if (!fields_ok || !sync_ignored || !corrupt_misses || !type3 || !compact || !round_trip || !rejected ||
+            !cleared)
+        {
+            suite.fail("reverse index lookup or serialization is wrong");
+        }
+        std::printf("%-32s %8zu messages, %zu bytes serialized\n", "reverse index", index.size(), bytes.size());
+    }
+
+#if WSPR_COROUTINES
+    /**
+     * @brief Minimal eager coroutine that signals a future when it finishes.
+     */
+    struct CheckTask
+    {
+        struct promise_type
+        {
+            std::promise<void> done;
+            CheckTask get_return_object() { return CheckTask{done.get_future()}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() { done.set_value(); }
+            void unhandled_exception() { std::abort(); }
+        };
+        std::future<void> finished;
+    };
+
+    /**
+     * @brief Awaits immediate and queued encodes, noting which thread resumed each.
+     *
+     * @param service A service that already caches AA0NT EM18 20.
+     * @param immediate Set if the rejection and the cache hit completed without suspending.
+     * @param suspended Set if a new message resumed the coroutine from the service thread.
+     * @return The task.
+     */
+    CheckTask await_encodes(WsprEncodeService &service, bool &immediate, bool &suspended)
+    {
+        const std::thread::id caller = std::this_thread::get_id();
+        const WsprEncodeResult bad = co_await service.encode("AA0NT", "EM18", 21);
+        const WsprEncodeResult hit = co_await service.encode("AA0NT", "EM18", 20);
+        immediate = bad.status == WsprStatus::invalid_power &&
+                    hit.symbols == WsprMessage::make_symbols("AA0NT", "EM18", 20) &&
+                    std::this_thread::get_id() == caller;
+
+        const WsprEncodeResult fresh = co_await service.encode("KB9ZZZ", "EN61", 43);
+        suspended = fresh.status == WsprStatus::ok &&
+                    fresh.symbols == WsprMessage::make_symbols("KB9ZZZ", "EN61", 43) &&
+                    std::this_thread::get_id() != caller;
+    }
+#endif
+
+    /**
+     * @brief Checks the encode service's immediate results, coalescing, batching, and counters.
+     *
+     * @param suite The result collector.
+     */
+    void check_service(Suite &suite)
+    {
+        WsprEncodeService::Options options;
+        options.max_batch = 8;
+        options.max_delay = std::chrono::milliseconds(50);
+        WsprEncodeService service(options);
+
+        // Rejections and cache hits are ready before submit() returns
+        std::future<WsprEncodeResult> bad = service.submit("AA0NT", "EM18", 21);
+        const bool rejected = bad.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+                              bad.get().status == WsprStatus::invalid_power;
+        const bool first = service.submit("AA0NT", "EM18", 20).get().status == WsprStatus::ok;
+        std::future<WsprEncodeResult> hit = service.submit("aa0nt", "em18", 20);
+        const bool cached = hit.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+                            hit.get().symbols == WsprMessage::make_symbols("AA0NT", "EM18", 20);
+
+#if WSPR_COROUTINES
+        bool immediate = false;
+        bool suspended = false;
+        await_encodes(service, immediate, suspended).finished.wait();
+        const bool awaited = immediate && suspended;
+        std::printf("%-32s %8s\n", "encode service coroutines", "checked");
+#else
+        const bool awaited = true;
+        std::printf("%-32s skipped (built without C++20 coroutines)\n", "encode service coroutines");
+#endif
+
+        // Repeats of a queued message join it; max_delay keeps it queued meanwhile
+        std::vector<std::future<WsprEncodeResult>> repeats;
+        for (int i = 0; i < 5; ++i)
+        {
+            repeats.push_back(service.submit("W9XYZ", "EN50", 37));
+        }
+        bool joined = true;
+        for (auto &f : repeats)
+        {
+            joined = joined && f.get().symbols == WsprMessage::make_symbols("W9XYZ", "EN50", 37);
+        }
+
+        // Concurrent clients asking for a few messages cause few encodes
+        std::vector<std::thread> clients;
+        std::atomic<int> wrong{0};
+        const std::string_view calls[] = {"K1ABC", "W1AW", "G4ABC", "VK2XYZ"};
+        for (int t = 0; t < 4; ++t)
+        {
+            clients.emplace_back([&, t] {
+                for (int i = 0; i < 50; ++i)
+                {
+                    const std::string_view call = calls[(t + i) % 4];
+                    const WsprEncodeResult result = service.submit(call, "FN42", 30 + (i % 2) * 7).get();
+                    if (result.symbols != WsprMessage::make_symbols(call, "FN42", 30 + (i % 2) * 7))
+                    {
+                        ++wrong;
+                    }
+                }
+            });
+        }
+        for (std::thread &client : clients)
+        {
+            client.join();
+        }
+
+        // A full batch is dispatched without waiting out max_delay
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::future<WsprEncodeResult>> burst;
+        for (int i = 0; i < 8; ++i)
+        {
+            burst.push_back(service.submit("KD0XYZ", "DM79", 3 * (i % 2) + 10 * (i / 2)));
+        }
+        for (auto &f : burst)
+        {
+            f.wait();
+        }
+        const bool prompt = std::chrono::steady_clock::now() - start < options.max_delay;
+
+        const WsprEncodeService::Stats stats = service.stats();
+        const bool counted = stats.requests == 3 + 3 * WSPR_COROUTINES + 5 + 200 + 8 &&
+                             stats.rejected == 1 + WSPR_COROUTINES && stats.coalesced >= 4 &&
+                             stats.encoded <= 1 + WSPR_COROUTINES + 1 + 8 + 8 &&
+                             stats.hits + stats.coalesced + stats.encoded + stats.rejected == stats.requests &&
+                             stats.queued == 0;
+
+        if (!rejected || !first || !cached || !awaited || !joined || wrong != 0 || !prompt || !counted)
+        {
+            suite.fail("encode service coalescing or completion is wrong");
+        }
+        std::printf("%-32s %8llu requests, %llu encoded in %llu batches, %llu coalesced, %llu cache hits\n",
+                    "encode service", static_cast<unsigned long long>(stats.requests),
+                    static_cast<unsigned long long>(stats.encoded), static_cast<unsigned long long>(stats.batches),
+                    static_cast<unsigned long long>(stats.coalesced), static_cast<unsigned long long>(stats.hits));
+    }
+
+    /**
+     * @brief Checks the pool's alignment, exhaustion, reuse order, and iteration.
+     *
+     * @param suite The result collector.
+     */
+    void check_pool(Suite &suite)
+    {
+        WsprMessagePool pool(4);
+        const WsprMessagePool::Handle a = pool.acquire();
+        const WsprMessagePool::Handle b = pool.acquire();
+        const WsprMessagePool::Handle c = pool.acquire();
+        const WsprMessagePool::Handle d = pool.acquire();
+        const bool aligned = reinterpret_cast<std::uintptr_t>(pool.symbols(b)) % WsprMessagePool::alignment == 0;
+        const bool exhausted = pool.acquire() == WsprMessagePool::invalid && pool.size() == 4;
+
+        pool.release(b);
+        pool.release(b); // A double release is ignored
+        const bool reused = pool.size() == 3 && pool.acquire() == b;
+
+        WsprStatus status;
+        pool.release(c);
+        const bool rejected = pool.encode("AA0NT", "EM18", 21, &status) == WsprMessagePool::invalid &&
+                              status == WsprStatus::invalid_power && pool.size() == 3;
+
+        std::vector<WsprMessagePool::Handle> visited;
+        pool.for_each([&](WsprMessagePool::Handle h, const uint8_t *) { visited.push_back(h); });
+
+        WsprPooledMessage moved;
+        {
+            WsprPooledMessage scoped(pool);
+            moved = std::move(scoped);
+        }
+        const bool owned = moved && pool.size() == 4;
+        moved.reset();
+
+        WsprMessagePool taken(std::move(pool));
+        const bool move_ok = taken.live(a) && taken.size() == 3 && pool.capacity() == 0 &&
+                             pool.acquire() == WsprMessagePool::invalid;
+
+        if (!aligned || !exhausted || !reused || !rejected || !owned || !move_ok ||
+            visited != std::vector<WsprMessagePool::Handle>{a, b, d})
+        {
+            suite.fail("message pool bookkeeping is wrong");
+        }
+        std::printf("%-32s %8s\n", "pool bookkeeping", "checked");
+    }
+
+    /**
+     * @brief Checks that an instrumented build counted the paths exercised above.
+     *
+     * @param suite The result collector.
+     */
+    void check_stats(Suite &suite)
+    {
+        if (!WsprStats::enabled)
+        {
+            std::printf("%-32s skipped (built without INSTRUMENT=1)\n", "stats");
+            return;
+        }
+        const WsprStatsSnapshot stats = WsprStats::snapshot();
+        if (stats.encode.calls == 0 || stats.reencode.calls == 0 || stats.batch.items == 0 ||
+            stats.parallel.calls == 0 || stats.cache.calls != stats.cache_hits + stats.cache_misses ||
+            stats.cache_hits == 0 || stats.allocations == 0 || stats.encode.max_ns < stats.encode.mean_ns)
+        {
+            suite.fail("instrumentation counters are inconsistent");
+        }
+
+        // Allocations are counted where they happen: a cache makes its two tables, encoding makes none
+        const uint64_t before = WsprStats::snapshot().allocations;
+        {
+            WsprCache cache(64);
+        }
+        const uint64_t constructed = WsprStats::snapshot().allocations;
+        uint8_t symbols[MSG_SIZE];
+        WsprMessage message;
+        for (int power = 0; power <= 60; power += 10)
+        {
+            WsprMessage::try_encode("AA0NT", "EM18", power, symbols);
+            message.try_set("K1ABC", "FN42", power);
+            message.set_power(power);
+        }
+        if (constructed - before != 2 || WsprStats::snapshot().allocations != constructed)
+        {
+            suite.fail("allocation counter does not match the allocations made");
+        }
+        std::printf("%-32s %8llu encodes, mean %.0f ns, max %.0f ns, cache hit rate %.2f\n", "stats",
+                    static_cast<unsigned long long>(stats.encode.calls), stats.encode.mean_ns, stats.encode.max_ns,
+                    stats.cache_hit_rate);
+    }
+}
+
+/**
+ * @brief Runs the golden corpus and a random differential pass.
+ *
+ * @param argc Argument count.
+ * @param argv Optional golden corpus path and random message count.
+ * @return 0 if every path matched, 1 otherwise.
+ */
+int main(int argc, char *argv[])
+{
+    const char *golden_path = (argc > 1) ? argv[1] : "test/wspr_golden.txt";
+    const std::size_t random_count = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 100000;
+
+    Suite suite;
+
+    std::vector<Vector> golden;
+    if (!load_golden(golden_path, golden) || golden.empty())
+    {
+        return 1;
+    }
+    check_paths(suite, "golden", golden);
+    check_index(suite, golden);
+
+    if (random_count > 0)
+    {
+        check_paths(suite, "random", random_vectors(random_count, 0x57535052u));
+    }
+
+    check_sync_search(suite);
+    check_fano_budget(suite);
+    check_set_power(suite);
+    check_sequence(suite);
+    check_schedule(suite);
+    check_pool(suite);
+    check_c_status(suite);
+    check_gpu(suite);
+    check_service(suite);
+    check_stats(suite);
+
+    if (suite.failures() != 0)
+    {
+        std::printf("FAILED: %zu failures\n", suite.failures());
+        return 1;
+    }
+    std::printf("All encoding paths match the reference.\n");
+    return 0;
+}
@@ -0,0 +1,285 @@
+/**
+ * @file wspr_fuzz.cpp
+ * @brief libFuzzer and standalone differential fuzz harness for the encoders.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_batch.hpp"
+#include "wspr_cache.hpp"
+#include "wspr_message.hpp"
+#include "wspr_packed.hpp"
+#include "wspr_reference.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    /**
+     * @brief Reports a disagreement between two paths and aborts.
+     *
+     * @param what The paths that disagree.
+     * @param callsign The input callsign.
+     * @param location The input locator.
+     * @param power The input power.
+     */
+    [[noreturn]] void fail(const char *what, std::string_view callsign, std::string_view location, int power)
+    {
+        std::fprintf(stderr, "Mismatch (%s) for callsign \"%.*s\" locator \"%.*s\" power %d\n", what,
+                     static_cast<int>(callsign.size()), callsign.data(),
+                     static_cast<int>(location.size()), location.data(), power);
+        std::abort();
+    }
+
+    /**
+     * @brief Checks every path on one input.
+     *
+     * The validating paths must agree on the status. For a valid message,
+     * every path must reproduce the reference encoder. For an invalid one,
+     * nothing may be written.
+     *
+     * @param callsign Arbitrary callsign bytes.
+     * @param location Arbitrary locator bytes.
+     * @param power Arbitrary power level.
+     */
+    void check(std::string_view callsign, std::string_view location, int power)
+    {
+        static WsprCache cache(8);
+
+        WsprMessage::Symbols fast;
+        fast.fill(0xEE);
+        const WsprStatus status = WsprMessage::try_encode(callsign, location, power, fast.data());
+
+        WsprPayload payload;
+        if (WsprMessage::validate(callsign, location, power) != status ||
+            WsprMessage::pack(callsign, location, power, payload) != status)
+        {
+            fail("validate/pack status", callsign, location, power);
+        }
+
+        for (WsprKernel kernel : {WsprKernel::scalar, WsprKernel::avx2, WsprKernel::neon})
+        {
+            if (!WsprSimd::available(kernel))
+            {
+                continue;
+            }
+            uint8_t row[1][MSG_SIZE];
+            WsprStatus batch_status;
+            WsprBatch::encode(&callsign, &location, &power, 1, row, &batch_status, kernel);
+            if (batch_status != status)
+            {
+                fail("batch status", callsign, location, power);
+            }
+            if (status == WsprStatus::ok && std::memcmp(row[0], fast.data(), MSG_SIZE) != 0)
+            {
+                fail("batch symbols", callsign, location, power);
+            }
+        }
+
+        WsprMessage::Symbols cached;
+        if (cache.encode(callsign, location, power, cached.data()) != status)
+        {
+            fail("cache status", callsign, location, power);
+        }
+
+        if (status != WsprStatus::ok)
+        {
+            for (uint8_t symbol : fast)
+            {
+                if (symbol != 0xEE)
+                {
+                    fail("try_encode wrote output for invalid input", callsign, location, power);
+                }
+            }
+            return;
+        }
+
+        WsprMessage::Symbols reference;
+        WsprReference::encode(std::string(callsign), std::string(location), power, reference.data());
+        if (fast != reference)
+        {
+            fail("try_encode vs reference", callsign, location, power);
+        }
+        if (cached != reference)
+        {
+            fail("cache vs reference", callsign, location, power);
+        }
+        if (WsprMessage::make_symbols(callsign, location, power) != reference)
+        {
+            fail("make_symbols vs reference", callsign, location, power);
+        }
+        if (WsprPackedSymbols::unpack(WsprPackedSymbols::pack(reference)) != reference)
+        {
+            fail("packed round trip", callsign, location, power);
+        }
+#if WSPR_EXCEPTIONS
+        WsprMessage::Symbols lenient;
+        WsprMessage::encode(std::string(callsign), std::string(location), power, lenient.data());
+        if (lenient != reference)
+        {
+            fail("encode vs reference", callsign, location, power);
+        }
+#endif
+    }
+
+    /**
+     * @brief Splits fuzzer input into a callsign, locator, and power, then checks it.
+     *
+     * Byte 0 selects the callsign length (0-7) and locator length (2-6),
+     * byte 1 is the power as a signed offset around the valid range, and
+     * the rest supplies the characters.
+     *
+     * @param data Input bytes.
+     * @param size Number of bytes.
+     */
+    void run_one(const uint8_t *data, std::size_t size)
+    {
+        if (size < 2)
+        {
+            return;
+        }
+        const std::size_t call_length = data[0] & 7;
+        const std::size_t location_length = 2 + ((data[0] >> 3) % 5);
+        const int power = static_cast<int>(static_cast<int8_t>(data[1])) + 30;
+        const char *text = reinterpret_cast<const char *>(data + 2);
+        const std::size_t available = size - 2;
+
+        const std::size_t call_size = call_length < available ? call_length : available;
+        const std::size_t location_size = location_length < available - call_size ? location_length : available - call_size;
+        check(std::string_view(text, call_size), std::string_view(text + call_size, location_size), power);
+
+        // Type 2/3 packing must stay in range and not trip the sanitizers
+        WsprPayload payload;
+        const std::string_view whole(text, available < 16 ? available : 16);
+        if (WsprMessage::pack_type2(whole, power, payload) == WsprStatus::ok ||
+            WsprMessage::pack_type3(whole, std::string_view(text, available < 6 ? available : 6), power, payload) == WsprStatus::ok)
+        {
+            if (payload.n >= (1u << 28) || payload.m >= (1u << 22))
+            {
+                fail("Type 2/3 payload out of range", whole, std::string_view(), power);
+            }
+        }
+        (void)WsprMessage::callsign_hash(whole);
+    }
+}
+
+/**
+ * @brief libFuzzer entry point.
+ *
+ * @param data Input bytes.
+ * @param size Number of bytes.
+ * @return Always 0.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, std::size_t size)
+{
+    run_one(data, size);
+    return 0;
+}
+
+#ifndef WSPR_LIBFUZZER
+/**
+ * @brief Standalone driver for toolchains without libFuzzer.
+ *
+ * Feeds `iterations` pseudo-random inputs through the harness. Half are
+ * arbitrary bytes; the other half are shaped like real messages, with a
+ * stray byte in a quarter of them, so most exercise the valid paths.
+ *
+ * @param argc Argument count.
+ * @param argv Optional iteration count and seed.
+ * @return 0 if no mismatch was found (a mismatch aborts).
+ */
+int main(int argc, char *argv[])
+{
+    const unsigned long iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    uint64_t state = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 0x9E3779B97F4A7C15ull;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+
+    static const char letters[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    static const char grid[] = "ABCDEFGHIJKLMNOPQR";
+    unsigned long valid = 0;
+    uint8_t input[24];
+    for (unsigned long i = 0; i < iterations; ++i)
+    {
+        std::size_t size;
+        if (i & 1)
+        {
+            // Shaped like a real message: [letter]letter digit letters, grid square, power 0-60
+            const std::size_t prefix = 1 + next() % 2;
+            const std::size_t suffix = 1 + next() % 3;
+            const std::size_t call_length = prefix + 1 + suffix;
+            input[0] = static_cast<uint8_t>(call_length | (2u << 3));
+            input[1] = static_cast<uint8_t>(static_cast<int>(next() % 61) - 30);
+            std::size_t j = 2;
+            for (std::size_t k = 0; k < prefix; ++k)
+            {
+                input[j++] = static_cast<uint8_t>(letters[next() % 26]);
+            }
+            input[j++] = static_cast<uint8_t>('0' + next() % 10);
+            for (std::size_t k = 0; k < suffix; ++k)
+            {
+                input[j++] = static_cast<uint8_t>(letters[next() % 26]);
+            }
+            input[j++] = static_cast<uint8_t>(grid[next() % 18]);
+            input[j++] = static_cast<uint8_t>(grid[next() % 18]);
+            input[j++] = static_cast<uint8_t>('0' + next() % 10);
+            input[j++] = static_cast<uint8_t>('0' + next() % 10);
+            size = j;
+            if ((next() & 3) == 0)
+            {
+                input[next() % size] = static_cast<uint8_t>(next()); // One stray byte
+            }
+        }
+        else
+        {
+            size = 2 + next() % (sizeof(input) - 1);
+            for (std::size_t j = 0; j < size; ++j)
+            {
+                input[j] = static_cast<uint8_t>(next());
+            }
+        }
+        run_one(input, size);
+
+        const std::size_t call_length = input[0] & 7;
+        const std::size_t location_length = 2 + ((input[0] >> 3) % 5);
+        if (size >= 2 + call_length + location_length)
+        {
+            const char *text = reinterpret_cast<const char *>(input + 2);
+            valid += WsprMessage::validate(std::string_view(text, call_length),
+                                           std::string_view(text + call_length, location_length),
+                                           static_cast<int8_t>(input[1]) + 30) == WsprStatus::ok;
+        }
+    }
+    std::printf("%lu inputs, %lu valid messages, no mismatches\n", iterations, valid);
+    return 0;
+}
+#endif // WSPR_LIBFUZZER
@@ -0,0 +1,202 @@
+/**
+ * @file wspr_reference.hpp
+ * @brief Reference WSPR encoder used to check the optimized paths.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_REFERENCE_H
+#define WSPR_REFERENCE_H
+
+#include <algorithm> // For: std::copy_n, std::min
+#include <cctype>    // For: std::isdigit, std::isalpha, std::toupper
+#include <cstddef>   // For: std::size_t
+#include <cstdint>   // For: uint8_t, uint32_t
+#include <string>    // For: std::string
+
+/**
+ * @class WsprReference
+ * @brief The original bit-serial Type 1 encoder, kept as a test oracle.
+ *
+ * This is the encoder the library started from: it packs the fields,
+ * then feeds the convolutional encoder one bit at a time, computing each
+ * parity by counting bits and each interleaved address by reversing an
+ * incrementing byte. It is deliberately unoptimized and shares no code
+ * with the library, so any difference in output is a bug in a fast path.
+ */
+class WsprReference
+{
+public:
+    /**
+     * @brief Encodes a message the way the original generate_wspr_symbols() did.
+     *
+     * @param callsign The callsign (uppercased here, as the original constructor did).
+     * @param location The 4-character locator (uppercased here).
+     * @param power The power level in dBm.
+     * @param symbols Destination buffer of 162 symbols.
+     */
+    static void encode(std::string callsign, std::string location, int power, uint8_t *symbols)
+    {
+        for (char &ch : callsign)
+        {
+            ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+        }
+        for (char &ch : location)
+        {
+            ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+        }
+
+        char call[6] = {' ', ' ', ' ', ' ', ' ', ' '};
+        if (callsign.length() >= 2 && std::isdigit(static_cast<unsigned char>(callsign[1])))
+        {
+            std::copy_n(callsign.begin(), std::min(callsign.length(), std::size_t(5)), call + 1);
+        }
+        else if (callsign.length() >= 3 && std::isdigit(static_cast<unsigned char>(callsign[2])))
+        {
+            std::copy_n(callsign.begin(), std::min(callsign.length(), std::size_t(6)), call);
+        }
+
+        uint32_t N = value(call[0]) * 36 + value(call[1]);
+        N = N * 10 + value(call[2]);
+        N = N * 27 + value(call[3]) - 10;
+        N = N * 27 + value(call[4]) - 10;
+        N = N * 27 + value(call[5]) - 10;
+
+        uint32_t M1 = (179 - 10 * (location[0] - 'A') - (location[2] - '0')) * 180 +
+                      (10 * (location[1] - 'A')) + (location[3] - '0');
+        uint32_t M = M1 * 128 + power + 64;
+
+        static const uint8_t sync[162] = {
+            1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0,
+            1, 0, 0, 1, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0,
+            0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1,
+            0, 1, 0, 0, 0, 1, 1, 0, 1, 0, 0, 0, 0, 1, 1, 0, 1, 0,
+            1, 0, 1, 0, 1, 0, 0, 1, 0, 0, 1, 0, 1, 1, 0, 0, 0, 1,
+            1, 0, 1, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1,
+            0, 0, 1, 1, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 0, 1,
+            1, 1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 1, 0, 0, 0, 0,
+            0, 0, 0, 1, 1, 0, 1, 0, 1, 1, 0, 0, 0, 1, 1, 0, 0, 0};
+        std::copy_n(sync, 162, symbols);
+
+        uint32_t reg = 0;
+        uint8_t address = 0;
+        for (int i = 27; i >= 0; i--)
+        {
+            reg <<= 1;
+            if (N & (uint32_t(1) << i))
+            {
+                reg |= 1;
+            }
+            symbols[next_address(address)] += 2 * parity(reg & 0xf2d05351u);
+            symbols[next_address(address)] += 2 * parity(reg & 0xe4613c47u);
+        }
+        for (int i = 21; i >= 0; i--)
+        {
+            reg <<= 1;
+            if (M & (uint32_t(1) << i))
+            {
+                reg |= 1;
+            }
+            symbols[next_address(address)] += 2 * parity(reg & 0xf2d05351u);
+            symbols[next_address(address)] += 2 * parity(reg & 0xe4613c47u);
+        }
+        for (int i = 30; i >= 0; i--)
+        {
+            reg <<= 1;
+            symbols[next_address(address)] += 2 * parity(reg & 0xf2d05351u);
+            symbols[next_address(address)] += 2 * parity(reg & 0xe4613c47u);
+        }
+    }
+
+private:
+    /**
+     * @brief Converts a callsign character to its packed value.
+     *
+     * @param ch Digit, letter, or space.
+     * @return 0-9 for digits, 10-35 for letters, 36 for space, 0 otherwise.
+     */
+    static int value(char ch)
+    {
+        if (std::isdigit(static_cast<unsigned char>(ch)))
+        {
+            return ch - '0';
+        }
+        if (std::isalpha(static_cast<unsigned char>(ch)))
+        {
+            return 10 + std::toupper(static_cast<unsigned char>(ch)) - 'A';
+        }
+        if (ch == ' ')
+        {
+            return 36;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Returns the next bit-reversed interleaver address below 162.
+     *
+     * @param index Running address counter, advanced in place.
+     * @return The symbol position.
+     */
+    static uint8_t next_address(uint8_t &index)
+    {
+        uint8_t result = reverse(index++);
+        while (result > 161)
+        {
+            result = reverse(index++);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Reverses the bits of a byte.
+     *
+     * @param b The byte.
+     * @return The reversed byte.
+     */
+    static uint8_t reverse(uint8_t b)
+    {
+        b = static_cast<uint8_t>((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+        b = static_cast<uint8_t>((b & 0xCC) >> 2 | (b & 0x33) << 2);
+        b = static_cast<uint8_t>((b & 0xAA) >> 1 | (b & 0x55) << 1);
+        return b;
+    }
+
+    /**
+     * @brief Computes the parity of a 32-bit value by clearing set bits.
+     *
+     * @param x The value.
+     * @return 1 for odd parity, 0 for even.
+     */
+    static int parity(uint32_t x)
+    {
+        int odd = 0;
+        while (x)
+        {
+            odd = 1 - odd;
+            x &= x - 1;
+        }
+        return odd;
+    }
+};
+
+#endif // WSPR_REFERENCE_H
@@ -0,0 +1,416 @@
+/**
+ * @file wspr_archive.cpp
+ * @brief Memory-mapped archive of precomputed, packed WSPR messages.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_archive.hpp"
+#include "wspr_batch.hpp"
+#include <algorithm>  // For: std::sort, std::unique
+#include <cerrno>     // For: errno, EINVAL
+#include <cstdio>     // For: std::FILE, std::fopen, std::fwrite
+#include <cstring>    // For: std::memcmp, std::memcpy
+#include <fcntl.h>    // For: ::open
+#include <sys/mman.h> // For: mmap, munmap
+#include <sys/stat.h> // For: fstat
+#include <unistd.h>   // For: ::close
+#include <utility>    // For: std::move
+
+namespace
+{
+    constexpr char magic[8] = {'W', 'S', 'P', 'R', 'A', 'R', 'C', '1'}; ///< File signature.
+    constexpr std::size_t write_block = 4096;                           ///< Messages encoded per batch call.
+
+    /**
+     * @brief Stores a little-endian integer of `bytes` bytes.
+     *
+     * @param out Destination.
+     * @param value The value to store.
+     * @param bytes Number of bytes.
+     */
+    void store_le(uint8_t *out, uint64_t value, std::size_t bytes) noexcept
+    {
+        for (std::size_t i = 0; i < bytes; ++i)
+        {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    /**
+     * @brief Loads a little-endian integer of `bytes` bytes.
+     *
+     * @param in Source.
+     * @param bytes Number of bytes.
+     * @return The value.
+     */
+    uint64_t load_le(const uint8_t *in, std::size_t bytes) noexcept
+    {
+        uint64_t value = 0;
+        for (std::size_t i = 0; i < bytes; ++i)
+        {
+            value |= static_cast<uint64_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+}
+
+/**
+ * @brief Validates, packs, and queues a Type 1 message.
+ *
+ * @param callsign The callsign (either case).
+ * @param location The 4-character Maidenhead locator (either case).
+ * @param power The power level in dBm.
+ * @return WsprStatus::ok, or the validation failure.
+ */
+WsprStatus WsprArchiveWriter::add(std::string_view callsign, std::string_view location, int power)
+{
+    WsprPayload payload;
+    WsprStatus result = WsprMessage::pack(callsign, location, power, payload);
+    if (result == WsprStatus::ok)
+    {
+        add(payload);
+    }
+    return result;
+}
+
+/**
+ * @brief Queues an already packed payload of any message type.
+ *
+ * @param payload The payload to store.
+ */
+void WsprArchiveWriter::add(const WsprPayload &payload)
+{
+    payloads_.push_back(payload);
+}
+
+/**
+ * @brief Returns the number of queued payloads, including duplicates.
+ *
+ * @return Queued payload count.
+ */
+std::size_t WsprArchiveWriter::size() const noexcept
+{
+    return payloads_.size();
+}
+
+/**
+ * @brief Encodes every queued message and writes the archive.
+ *
+ * @param path Destination file; replaced if it exists.
+ * @param kernel Batch encoder kernel.
+ * @return False if the file could not be written.
+ */
+bool WsprArchiveWriter::write(const std::string &path, WsprKernel kernel)
+{
+    std::sort(payloads_.begin(), payloads_.end(),
+              [](const WsprPayload &a, const WsprPayload &b) { return a.key() < b.key(); });
+    payloads_.erase(std::unique(payloads_.begin(), payloads_.end()), payloads_.end());
+
+    const uint64_t count = payloads_.size();
+    const uint64_t index_offset = WsprArchive::header_size;
+    const uint64_t symbols_offset = index_offset + 8 * count;
+
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    uint8_t header[WsprArchive::header_size] = {};
+    std::memcpy(header, magic, sizeof(magic));
+    store_le(header + 8, WsprArchive::version, 4);
+    store_le(header + 12, WsprArchive::header_size, 4);
+    store_le(header + 16, count, 8);
+    store_le(header + 24, index_offset, 8);
+    store_le(header + 32, symbols_offset, 8);
+    store_le(header + 40, WsprArchive::record_size, 4);
+    bool ok = std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+
+    // Index: one key per record, in the same order as the records
+    std::vector<uint8_t> buffer(write_block * (MSG_SIZE + WsprArchive::record_size));
+    for (std::size_t i = 0; ok && i < count; i += write_block)
+    {
+        const std::size_t block = std::min<std::size_t>(write_block, count - i);
+        for (std::size_t j = 0; j < block; ++j)
+        {
+            store_le(buffer.data() + 8 * j, payloads_[i + j].key(), 8);
+        }
+        ok = std::fwrite(buffer.data(), 8, block, file) == block;
+    }
+
+    // Records: encode a block with the batch encoder, pack it, write it
+    auto rows = reinterpret_cast<uint8_t(*)[MSG_SIZE]>(buffer.data());
+    uint8_t *packed = buffer.data() + write_block * MSG_SIZE;
+    for (std::size_t i = 0; ok && i < count; i += write_block)
+    {
+        const std::size_t block = std::min<std::size_t>(write_block, count - i);
+        WsprBatch::encode_payloads(payloads_.data() + i, block, rows, kernel);
+        for (std::size_t j = 0; j < block; ++j)
+        {
+            WsprPackedSymbols::pack(rows[j], packed + j * WsprArchive::record_size);
+        }
+        ok = std::fwrite(packed, WsprArchive::record_size, block, file) == block;
+    }
+
+    if (std::fclose(file) != 0)
+    {
+        ok = false;
+    }
+    return ok;
+}
+
+/**
+ * @brief Unmaps the file if one is open.
+ */
+WsprArchive::~WsprArchive()
+{
+    close();
+}
+
+/**
+ * @brief Takes over another archive's mapping.
+ *
+ * @param other The archive to move from; left closed.
+ */
+WsprArchive::WsprArchive(WsprArchive &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+/**
+ * @brief Takes over another archive's mapping, closing this one first.
+ *
+ * @param other The archive to move from; left closed.
+ * @return This archive.
+ */
+WsprArchive &WsprArchive::operator=(WsprArchive &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        map_ = other.map_;
+        map_size_ = other.map_size_;
+        index_ = other.index_;
+        records_ = other.records_;
+        count_ = other.count_;
+        other.map_ = nullptr;
+        other.map_size_ = 0;
+        other.index_ = nullptr;
+        other.records_ = nullptr;
+        other.count_ = 0;
+    }
+    return *this;
+}
+
+/**
+ * @brief Maps an archive file.
+ *
+ * @param path The archive to open.
+ * @return False if the file cannot be mapped or is not a valid archive.
+ */
+bool WsprArchive::open(const std::string &path) noexcept
+{
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    if (info.st_size < static_cast<off_t>(header_size))
+    {
+        ::close(fd);
+        errno = EINVAL;
+        return false;
+    }
+
+    const std::size_t length = static_cast<std::size_t>(info.st_size);
+    void *mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping keeps the file referenced
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    const uint8_t *base = static_cast<const uint8_t *>(mapping);
+
+    // Only the header is examined, so opening is O(1) in the archive size
+    const uint64_t count = load_le(base + 16, 8);
+    const uint64_t index_offset = load_le(base + 24, 8);
+    const uint64_t symbols_offset = load_le(base + 32, 8);
+    const bool valid = std::memcmp(base, magic, sizeof(magic)) == 0 &&
+                       load_le(base + 8, 4) == version &&
+                       load_le(base + 12, 4) == header_size &&
+                       load_le(base + 40, 4) == record_size &&
+                       count <= length / (8 + record_size) &&
+                       index_offset >= header_size && index_offset <= length &&
+                       count * 8 <= length - index_offset &&
+                       symbols_offset >= header_size && symbols_offset <= length &&
+                       count * record_size <= length - symbols_offset;
+    if (!valid)
+    {
+        munmap(mapping, length);
+        errno = EINVAL;
+        return false;
+    }
+
+    map_ = base;
+    map_size_ = length;
+    index_ = base + index_offset;
+    records_ = base + symbols_offset;
+    count_ = static_cast<std::size_t>(count);
+    return true;
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+void WsprArchive::close() noexcept
+{
+    if (map_ != nullptr)
+    {
+        munmap(const_cast<uint8_t *>(map_), map_size_);
+    }
+    map_ = nullptr;
+    map_size_ = 0;
+    index_ = nullptr;
+    records_ = nullptr;
+    count_ = 0;
+}
+
+/**
+ * @brief Returns true if an archive is mapped.
+ *
+ * @return Whether open() succeeded.
+ */
+bool WsprArchive::is_open() const noexcept
+{
+    return map_ != nullptr;
+}
+
+/**
+ * @brief Returns the number of messages in the archive.
+ *
+ * @return Record count, or 0 if closed.
+ */
+std::size_t WsprArchive::size() const noexcept
+{
+    return count_;
+}
+
+/**
+ * @brief Finds the record for a payload.
+ *
+ * @param payload The packed payload to look up.
+ * @return The record's position, or size() if it is not present.
+ */
+std::size_t WsprArchive::find(const WsprPayload &payload) const noexcept
+{
+    const uint64_t target = payload.key();
+
+    // Lower-bound binary search over the sorted key index
+    std::size_t low = 0;
+    std::size_t high = count_;
+    while (low < high)
+    {
+        const std::size_t mid = low + (high - low) / 2;
+        if (key(mid) < target)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return (low < count_ && key(low) == target) ? low : count_;
+}
+
+/**
+ * @brief Finds the packed symbols of a payload.
+ *
+ * @param payload The packed payload to look up.
+ * @return View of the 41-byte record in the mapping, or an empty view.
+ */
+WsprSpan<const uint8_t> WsprArchive::lookup(const WsprPayload &payload) const noexcept
+{
+    const std::size_t index = find(payload);
+    return (index < count_) ? packed(index) : WsprSpan<const uint8_t>();
+}
+
+/**
+ * @brief Finds the packed symbols of a Type 1 message.
+ *
+ * @param callsign The callsign (either case).
+ * @param location The 4-character Maidenhead locator (either case).
+ * @param power The power level in dBm.
+ * @return View of the 41-byte record in the mapping, or an empty view.
+ */
+WsprSpan<const uint8_t> WsprArchive::lookup(std::string_view callsign, std::string_view location, int power) const noexcept
+{
+    WsprPayload payload;
+    if (WsprMessage::pack(callsign, location, power, payload) != WsprStatus::ok)
+    {
+        return WsprSpan<const uint8_t>();
+    }
+    return lookup(payload);
+}
+
+/**
+ * @brief Returns the packed symbols of a record.
+ *
+ * @param index Record position, less than size().
+ * @return View of the 41-byte record in the mapping.
+ */
+WsprSpan<const uint8_t> WsprArchive::packed(std::size_t index) const noexcept
+{
+    return WsprSpan<const uint8_t>(records_ + index * record_size, record_size);
+}
+
+/**
+ * @brief Returns the payload stored for a record.
+ *
+ * @param index Record position, less than size().
+ * @return The record's payload.
+ */
+WsprPayload WsprArchive::payload(std::size_t index) const noexcept
+{
+    return WsprPayload::from_key(key(index));
+}
+
+/**
+ * @brief Returns index entry `index`.
+ *
+ * @param index Record position, less than size().
+ * @return The payload key.
+ */
+uint64_t WsprArchive::key(std::size_t index) const noexcept
+{
+    return load_le(index_ + 8 * index, 8);
+}
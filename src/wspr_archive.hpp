@@ -0,0 +1,245 @@
+/**
+ * @file wspr_archive.hpp
+ * @brief Memory-mapped archive of precomputed, packed WSPR messages.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_ARCHIVE_H
+#define WSPR_ARCHIVE_H
+
+#include "wspr_message.hpp"
+#include "wspr_packed.hpp"
+#include "wspr_simd.hpp"
+
+#include <cstddef>     // For: std::size_t
+#include <cstdint>     // For: uint8_t, uint64_t
+#include <string>      // For: std::string
+#include <string_view> // For: std::string_view
+#include <vector>      // For: std::vector
+
+/**
+ * @class WsprArchiveWriter
+ * @brief Collects messages and writes them out as a WsprArchive file.
+ *
+ * File layout, with all integers little-endian:
+ *
+ * | Offset            | Size        | Contents                                     |
+ * |-------------------|-------------|----------------------------------------------|
+ * | 0                 | 64          | Header (see below)                           |
+ * | `index_offset`    | 8 * count   | Payload keys (WsprPayload::key()), ascending |
+ * | `symbols_offset`  | 41 * count  | WsprPackedSymbols records, in key order      |
+ *
+ * The header holds the magic "WSPRARC1", then uint32 version, uint32
+ * header size, uint64 count, uint64 index_offset, uint64 symbols_offset,
+ * uint32 record size (41), and zero padding up to 64 bytes.
+ *
+ * Keys are unique. Record `i` is the message whose payload key is index
+ * entry `i`, so a lookup is a binary search of the index followed by one
+ * fixed-offset access.
+ */
+class WsprArchiveWriter
+{
+public:
+    /**
+     * @brief Validates, packs, and queues a Type 1 message.
+     *
+     * @param callsign The callsign (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The power level in dBm.
+     * @return WsprStatus::ok, or the validation failure.
+     */
+    WsprStatus add(std::string_view callsign, std::string_view location, int power);
+
+    /**
+     * @brief Queues an already packed payload of any message type.
+     *
+     * @param payload The payload to store.
+     */
+    void add(const WsprPayload &payload);
+
+    /**
+     * @brief Returns the number of queued payloads, including duplicates.
+     *
+     * @return Queued payload count.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Encodes every queued message and writes the archive.
+     *
+     * Duplicates are dropped. Messages are encoded in blocks with
+     * WsprBatch::encode_payloads(), packed, and streamed to the file.
+     *
+     * @param path Destination file; replaced if it exists.
+     * @param kernel Batch encoder kernel.
+     * @return False if the file could not be written.
+     */
+    bool write(const std::string &path, WsprKernel kernel = WsprKernel::automatic);
+
+private:
+    std::vector<WsprPayload> payloads_; ///< Queued payloads.
+};
+
+/**
+ * @class WsprArchive
+ * @brief Read-only, memory-mapped view of an archive file.
+ *
+ * Opening maps the file and checks only the fixed-size header against the
+ * file length, so startup takes the same time whatever the archive size.
+ * Pages are faulted in on demand. Lookups return pointers straight into
+ * the mapping, and nothing is copied unless the caller unpacks a record.
+ */
+class WsprArchive
+{
+public:
+    /**
+     * @brief Archive file format version written and accepted.
+     */
+    static constexpr uint32_t version = 1;
+
+    /**
+     * @brief Size of the file header in bytes.
+     */
+    static constexpr std::size_t header_size = 64;
+
+    /**
+     * @brief Size of one packed symbol record in bytes.
+     */
+    static constexpr std::size_t record_size = WsprPackedSymbols::size;
+
+    /**
+     * @brief Creates a closed archive.
+     */
+    WsprArchive() noexcept = default;
+
+    /**
+     * @brief Unmaps the file if one is open.
+     */
+    ~WsprArchive();
+
+    WsprArchive(const WsprArchive &) = delete;
+    WsprArchive &operator=(const WsprArchive &) = delete;
+
+    /**
+     * @brief Takes over another archive's mapping.
+     *
+     * @param other The archive to move from; left closed.
+     */
+    WsprArchive(WsprArchive &&other) noexcept;
+
+    /**
+     * @brief Takes over another archive's mapping, closing this one first.
+     *
+     * @param other The archive to move from; left closed.
+     * @return This archive.
+     */
+    WsprArchive &operator=(WsprArchive &&other) noexcept;
+
+    /**
+     * @brief Maps an archive file.
+     *
+     * @param path The archive to open.
+     * @return False if the file cannot be mapped or is not a valid archive;
+     *         `errno` describes system failures.
+     */
+    bool open(const std::string &path) noexcept;
+
+    /**
+     * @brief Unmaps the file.
+     */
+    void close() noexcept;
+
+    /**
+     * @brief Returns true if an archive is mapped.
+     *
+     * @return Whether open() succeeded.
+     */
+    bool is_open() const noexcept;
+
+    /**
+     * @brief Returns the number of messages in the archive.
+     *
+     * @return Record count, or 0 if closed.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Finds the record for a payload.
+     *
+     * @param payload The packed payload to look up.
+     * @return The record's position, or size() if it is not present.
+     */
+    std::size_t find(const WsprPayload &payload) const noexcept;
+
+    /**
+     * @brief Finds the packed symbols of a payload.
+     *
+     * @param payload The packed payload to look up.
+     * @return View of the 41-byte record in the mapping, or an empty view.
+     */
+    WsprSpan<const uint8_t> lookup(const WsprPayload &payload) const noexcept;
+
+    /**
+     * @brief Finds the packed symbols of a Type 1 message.
+     *
+     * @param callsign The callsign (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The power level in dBm.
+     * @return View of the 41-byte record in the mapping, or an empty view
+     *         if the message is invalid or not present.
+     */
+    WsprSpan<const uint8_t> lookup(std::string_view callsign, std::string_view location, int power) const noexcept;
+
+    /**
+     * @brief Returns the packed symbols of a record.
+     *
+     * @param index Record position, less than size().
+     * @return View of the 41-byte record in the mapping.
+     */
+    WsprSpan<const uint8_t> packed(std::size_t index) const noexcept;
+
+    /**
+     * @brief Returns the payload stored for a record.
+     *
+     * @param index Record position, less than size().
+     * @return The record's payload.
+     */
+    WsprPayload payload(std::size_t index) const noexcept;
+
+private:
+    /**
+     * @brief Returns index entry `index`.
+     *
+     * @param index Record position, less than size().
+     * @return The payload key.
+     */
+    uint64_t key(std::size_t index) const noexcept;
+
+    const uint8_t *map_ = nullptr;     ///< Start of the mapping.
+    std::size_t map_size_ = 0;         ///< Mapping length in bytes.
+    const uint8_t *index_ = nullptr;   ///< Start of the key index.
+    const uint8_t *records_ = nullptr; ///< Start of the packed records.
+    std::size_t count_ = 0;            ///< Number of records.
+};
+
+#endif // WSPR_ARCHIVE_H
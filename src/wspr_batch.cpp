@@ -0,0 +1,161 @@
+/**
+ * @file wspr_batch.cpp
+ * @brief Batch encoding of many WSPR messages into contiguous storage.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_batch.hpp"
+#include "wspr_stats.hpp"
+#include <cstring> // For: std::memset
+
+/**
+ * @brief Encodes `count` messages into contiguous output rows.
+ *
+ * @param callsigns Array of `count` callsigns (either case).
+ * @param locations Array of `count` 4-character Maidenhead locators (either case).
+ * @param powers Array of `count` power levels in dBm.
+ * @param count Number of messages to encode.
+ * @param out Destination block of `count` rows of MSG_SIZE symbols.
+ * @param status Optional array of `count` per-item results; may be nullptr.
+ * @param kernel Encoder kernel; unavailable kernels fall back to WsprSimd::best().
+ * @return Number of messages successfully encoded.
+ *
+ * @note Rows for invalid items are zeroed so stale symbols are never mistaken
+ *       for a valid encoding.
+ */
+std::size_t WsprBatch::encode(const std::string_view *callsigns,
+                              const std::string_view *locations,
+                              const int *powers,
+                              std::size_t count,
+                              uint8_t (*out)[MSG_SIZE],
+                              WsprStatus *status,
+                              WsprKernel kernel) noexcept
+{
+    WSPR_STAT_TIME(batch, count);
+    kernel = WsprSimd::resolve(kernel);
+    const std::size_t lanes = WsprSimd::lanes(kernel);
+
+    // Valid items are packed into a group and encoded once the group fills
+    uint32_t n[max_lanes];
+    uint32_t m[max_lanes];
+    uint8_t *rows[max_lanes];
+    std::size_t pending = 0;
+    std::size_t encoded = 0;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        WsprPayload payload;
+        WsprStatus result = WsprMessage::pack(callsigns[i], locations[i], powers[i], payload);
+        if (result == WsprStatus::ok)
+        {
+            n[pending] = payload.n;
+            m[pending] = payload.m;
+            rows[pending++] = out[i];
+            ++encoded;
+
+            if (pending == lanes)
+            {
+                encode_group(kernel, n, m, rows, pending);
+                pending = 0;
+            }
+        }
+        else
+        {
+            std::memset(out[i], 0, MSG_SIZE);
+        }
+
+        if (status != nullptr)
+        {
+            status[i] = result;
+        }
+    }
+
+    encode_group(kernel, n, m, rows, pending);
+
+    return encoded;
+}
+
+/**
+ * @brief Encodes `count` already packed payloads into contiguous output rows.
+ *
+ * @param payloads Array of `count` payloads.
+ * @param count Number of messages to encode.
+ * @param out Destination block of `count` rows of MSG_SIZE symbols.
+ * @param kernel Encoder kernel; unavailable kernels fall back to WsprSimd::best().
+ */
+void WsprBatch::encode_payloads(const WsprPayload *payloads,
+                                std::size_t count,
+                                uint8_t (*out)[MSG_SIZE],
+                                WsprKernel kernel) noexcept
+{
+    WSPR_STAT_TIME(batch, count);
+    kernel = WsprSimd::resolve(kernel);
+    const std::size_t lanes = WsprSimd::lanes(kernel);
+
+    uint32_t n[max_lanes];
+    uint32_t m[max_lanes];
+    uint8_t *rows[max_lanes];
+
+    for (std::size_t i = 0; i < count; i += lanes)
+    {
+        const std::size_t group = (count - i < lanes) ? count - i : lanes;
+        for (std::size_t j = 0; j < group; ++j)
+        {
+            n[j] = payloads[i + j].n;
+            m[j] = payloads[i + j].m;
+            rows[j] = out[i + j];
+        }
+        encode_group(kernel, n, m, rows, group);
+    }
+}
+
+/**
+ * @brief Encodes a group of packed payloads with the given kernel.
+ *
+ * @param kernel A concrete, available kernel.
+ * @param n Packed callsign integers.
+ * @param m Packed locator/power integers.
+ * @param rows Destination buffers of MSG_SIZE symbols.
+ * @param count Number of payloads in the group.
+ */
+void WsprBatch::encode_group(WsprKernel kernel, const uint32_t *n, const uint32_t *m, uint8_t *const *rows, std::size_t count) noexcept
+{
+    if (kernel == WsprKernel::avx2 && count == WsprSimd::avx2_lanes)
+    {
+        WsprSimd::encode_avx2(n, m, rows);
+        return;
+    }
+    if (kernel == WsprKernel::neon && count == WsprSimd::neon_lanes)
+    {
+        WsprSimd::encode_neon(n, m, rows);
+        return;
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        WsprPayload payload;
+        payload.n = n[i];
+        payload.m = m[i];
+        WsprMessage::encode_payload(payload, rows[i]);
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * @file wspr_batch.hpp
+ * @brief Batch encoding of many WSPR messages into contiguous storage.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_BATCH_H
+#define WSPR_BATCH_H
+
+#include "wspr_message.hpp"
+#include "wspr_simd.hpp"
+
+#include <cstddef>     // For: std::size_t
+#include <cstdint>     // For: uint8_t
+#include <string_view> // For: std::string_view
+
+/**
+ * @class WsprBatch
+ * @brief Encodes many Type 1 WSPR messages in one call without exceptions.
+ *
+ * Inputs are supplied as parallel arrays (structure-of-arrays) and symbols
+ * are written to a caller-provided contiguous `uint8_t[count][MSG_SIZE]`
+ * block. No memory is allocated and no strings are copied; each item is
+ * validated with WsprMessage::validate() and packed with the same logic as
+ * WsprMessage. Valid items are then grouped and convolutionally encoded by
+ * the selected WsprKernel, so several messages share each SIMD pass.
+ */
+class WsprBatch
+{
+public:
+    /**
+     * @brief Encodes `count` messages into contiguous output rows.
+     *
+     * Items that fail validation have their output row zeroed and their
+     * status set to the reason; the remaining items are still encoded.
+     *
+     * @param callsigns Array of `count` callsigns (either case).
+     * @param locations Array of `count` 4-character Maidenhead locators (either case).
+     * @param powers Array of `count` power levels in dBm.
+     * @param count Number of messages to encode.
+     * @param out Destination block of `count` rows of MSG_SIZE symbols.
+     * @param status Optional array of `count` per-item results; may be nullptr.
+     * @param kernel Encoder kernel; unavailable kernels fall back to WsprSimd::best().
+     * @return Number of messages successfully encoded.
+     */
+    static std::size_t encode(const std::string_view *callsigns,
+                              const std::string_view *locations,
+                              const int *powers,
+                              std::size_t count,
+                              uint8_t (*out)[MSG_SIZE],
+                              WsprStatus *status,
+                              WsprKernel kernel = WsprKernel::automatic) noexcept;
+
+    /**
+     * @brief Encodes `count` already packed payloads into contiguous output rows.
+     *
+     * Payloads of any message type can be mixed, since packing has already
+     * been done (see WsprMessage::pack(), pack_type2(), and pack_type3()).
+     *
+     * @param payloads Array of `count` payloads.
+     * @param count Number of messages to encode.
+     * @param out Destination block of `count` rows of MSG_SIZE symbols.
+     * @param kernel Encoder kernel; unavailable kernels fall back to WsprSimd::best().
+     */
+    static void encode_payloads(const WsprPayload *payloads,
+                                std::size_t count,
+                                uint8_t (*out)[MSG_SIZE],
+                                WsprKernel kernel = WsprKernel::automatic) noexcept;
+
+private:
+    /**
+     * @brief Largest number of lanes of any kernel.
+     */
+    static constexpr std::size_t max_lanes = WsprSimd::avx2_lanes;
+
+    /**
+     * @brief Encodes a group of packed payloads with the given kernel.
+     *
+     * @param kernel A concrete, available kernel.
+     * @param n Packed callsign integers.
+     * @param m Packed locator/power integers.
+     * @param rows Destination buffers of MSG_SIZE symbols.
+     * @param count Number of payloads; a full group for SIMD kernels uses
+     *              the kernel, anything shorter is encoded one at a time.
+     */
+    static void encode_group(WsprKernel kernel, const uint32_t *n, const uint32_t *m, uint8_t *const *rows, std::size_t count) noexcept;
+};
+
+#endif // WSPR_BATCH_H
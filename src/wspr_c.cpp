@@ -0,0 +1,188 @@
+/**
+ * @file wspr_c.cpp
+ * @brief Stable C interface to the WSPR encoder for C and FFI callers.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_c.h"
+#include "wspr_batch.hpp"
+#include "wspr_message.hpp"
+#include "wspr_packed.hpp"
+
+#include <cstring>     // For: std::strlen
+#include <string_view> // For: std::string_view
+
+static_assert(WSPR_SYMBOL_COUNT == MSG_SIZE, "WSPR_SYMBOL_COUNT must match the message size");
+static_assert(WSPR_PACKED_SIZE == WsprPackedSymbols::size, "WSPR_PACKED_SIZE must match the packed size");
+static_assert(WSPR_OK == static_cast<int>(WsprStatus::ok) &&
+                  WSPR_INVALID_CALLSIGN == static_cast<int>(WsprStatus::invalid_callsign) &&
+                  WSPR_INVALID_LOCATOR == static_cast<int>(WsprStatus::invalid_locator) &&
+                  WSPR_INVALID_POWER == static_cast<int>(WsprStatus::invalid_power) &&
+                  WSPR_INVALID_FREQUENCY == static_cast<int>(WsprStatus::invalid_frequency),
+              "C result codes must match WsprStatus");
+
+namespace
+{
+    /**
+     * @brief Messages per WsprBatch call, bounding the stack used for views.
+     */
+    constexpr std::size_t batch_chunk = 64;
+
+    /**
+     * @brief Wraps a C string, treating NULL as empty.
+     *
+     * @param text NUL-terminated string, or NULL.
+     * @return A view of `text`.
+     */
+    std::string_view view_of(const char *text) noexcept
+    {
+        return text ? std::string_view(text, std::strlen(text)) : std::string_view();
+    }
+}
+
+/**
+ * @brief Returns the interface version the library was built with.
+ *
+ * @return WSPR_ABI_VERSION.
+ */
+int wspr_abi_version(void)
+{
+    return WSPR_ABI_VERSION;
+}
+
+/**
+ * @brief Encodes one Type 1 message.
+ *
+ * @param callsign NUL-terminated callsign.
+ * @param locator NUL-terminated 4-character Maidenhead locator.
+ * @param power Power level in dBm.
+ * @param symbols Destination of WSPR_SYMBOL_COUNT bytes.
+ * @return WSPR_OK, a field error, or WSPR_INVALID_ARGUMENT for NULL pointers.
+ */
+int wspr_encode(const char *callsign, const char *locator, int power, uint8_t *symbols)
+{
+    if (!callsign || !locator || !symbols)
+    {
+        return WSPR_INVALID_ARGUMENT;
+    }
+    return static_cast<int>(WsprMessage::try_encode(view_of(callsign), view_of(locator), power, symbols));
+}
+
+/**
+ * @brief Encodes `count` Type 1 messages into one contiguous block.
+ *
+ * Input is handed to WsprBatch in fixed chunks so the string views live on
+ * the stack.
+ *
+ * @param callsigns Array of `count` NUL-terminated callsigns.
+ * @param locators Array of `count` NUL-terminated locators.
+ * @param powers Array of `count` power levels in dBm.
+ * @param count Number of messages.
+ * @param symbols Destination of `count * WSPR_SYMBOL_COUNT` bytes.
+ * @param status Optional array of `count` per-item result codes.
+ * @return Number of messages encoded.
+ */
+size_t wspr_encode_batch(const char *const *callsigns, const char *const *locators, const int *powers,
+                         size_t count, uint8_t *symbols, int *status)
+{
+    if (!callsigns || !locators || !powers || !symbols)
+    {
+        return 0;
+    }
+
+    uint8_t(*rows)[MSG_SIZE] = reinterpret_cast<uint8_t(*)[MSG_SIZE]>(symbols);
+    std::string_view calls[batch_chunk];
+    std::string_view locs[batch_chunk];
+    WsprStatus results[batch_chunk];
+    std::size_t encoded = 0;
+
+    for (std::size_t base = 0; base < count; base += batch_chunk)
+    {
+        const std::size_t n = (count - base < batch_chunk) ? count - base : batch_chunk;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            calls[i] = view_of(callsigns[base + i]);
+            locs[i] = view_of(locators[base + i]);
+        }
+        encoded += WsprBatch::encode(calls, locs, powers + base, n, rows + base, results);
+        if (status)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                status[base + i] = static_cast<int>(results[i]);
+            }
+        }
+    }
+    return encoded;
+}
+
+/**
+ * @brief Encodes one Type 1 message straight into the packed form.
+ *
+ * @param callsign NUL-terminated callsign.
+ * @param locator NUL-terminated 4-character Maidenhead locator.
+ * @param power Power level in dBm.
+ * @param packed Destination of WSPR_PACKED_SIZE bytes.
+ * @return WSPR_OK, a field error, or WSPR_INVALID_ARGUMENT for NULL pointers.
+ */
+int wspr_encode_packed(const char *callsign, const char *locator, int power, uint8_t *packed)
+{
+    if (!callsign || !locator || !packed)
+    {
+        return WSPR_INVALID_ARGUMENT;
+    }
+    WsprMessage::Symbols symbols;
+    const WsprStatus result = WsprMessage::try_encode(view_of(callsign), view_of(locator), power, symbols.data());
+    if (result == WsprStatus::ok)
+    {
+        WsprPackedSymbols::pack(symbols.data(), packed);
+    }
+    return static_cast<int>(result);
+}
+
+/**
+ * @brief Describes a result code.
+ *
+ * @param status A result code from this interface.
+ * @return A static description.
+ */
+const char *wspr_status_string(int status)
+{
+    switch (status)
+    {
+    case WSPR_OK:
+        return "ok";
+    case WSPR_INVALID_CALLSIGN:
+        return "invalid callsign";
+    case WSPR_INVALID_LOCATOR:
+        return "invalid locator";
+    case WSPR_INVALID_POWER:
+        return "invalid power";
+    case WSPR_INVALID_FREQUENCY:
+        return "invalid frequency";
+    case WSPR_INVALID_ARGUMENT:
+        return "invalid argument";
+    default:
+        return "unknown status";
+    }
+}
@@ -0,0 +1,141 @@
+/**
+ * @file wspr_c.h
+ * @brief Stable C interface to the WSPR encoder for C and FFI callers.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_C_H
+#define WSPR_C_H
+
+#include <stddef.h> /* For: size_t */
+#include <stdint.h> /* For: uint8_t */
+
+/**
+ * @brief Marks a function as part of the exported C interface.
+ *
+ * The shared library is built with hidden visibility, so only these
+ * functions are exported from it.
+ */
+#if defined(__GNUC__)
+#define WSPR_API __attribute__((visibility("default")))
+#else
+#define WSPR_API
+#endif
+
+/**
+ * @brief Version of this interface; bumped only on incompatible changes.
+ */
+#define WSPR_ABI_VERSION 1
+
+/**
+ * @brief Number of symbols in one encoded message.
+ */
+#define WSPR_SYMBOL_COUNT 162
+
+/**
+ * @brief Number of bytes in one packed message (four symbols per byte).
+ */
+#define WSPR_PACKED_SIZE 41
+
+/**
+ * @brief Result codes, matching WsprStatus in the C++ interface.
+ */
+#define WSPR_OK 0                ///< Message is valid / was encoded.
+#define WSPR_INVALID_CALLSIGN 1  ///< Callsign is empty, too long, or not a Type 1 structure.
+#define WSPR_INVALID_LOCATOR 2   ///< Locator is not a 4-character Maidenhead square.
+#define WSPR_INVALID_POWER 3     ///< Power is outside 0-60 dBm or does not end in 0, 3, or 7.
+#define WSPR_INVALID_FREQUENCY 4 ///< Frequency cannot be produced by the transmitter's tuning model.
+#define WSPR_INVALID_ARGUMENT 255 ///< A required pointer was NULL.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Returns the interface version the library was built with.
+     *
+     * @return WSPR_ABI_VERSION of the library, to compare against the header.
+     */
+    WSPR_API int wspr_abi_version(void);
+
+    /**
+     * @brief Encodes one Type 1 message.
+     *
+     * Never allocates. Lowercase input is accepted.
+     *
+     * @param callsign NUL-terminated callsign.
+     * @param locator NUL-terminated 4-character Maidenhead locator.
+     * @param power Power level in dBm.
+     * @param symbols Destination of WSPR_SYMBOL_COUNT bytes, each 0-3.
+     * @return WSPR_OK, or the first field found to be invalid. On failure
+     *         `symbols` is left unchanged.
+     */
+    WSPR_API int wspr_encode(const char *callsign, const char *locator, int power, uint8_t *symbols);
+
+    /**
+     * @brief Encodes `count` Type 1 messages into one contiguous block.
+     *
+     * Row `i` of `symbols` starts at byte `i * WSPR_SYMBOL_COUNT`. Rows of
+     * rejected items are zeroed and the rest are still encoded. Never
+     * allocates; messages go through the fastest available SIMD kernel.
+     *
+     * @param callsigns Array of `count` NUL-terminated callsigns; a NULL entry is rejected.
+     * @param locators Array of `count` NUL-terminated locators; a NULL entry is rejected.
+     * @param powers Array of `count` power levels in dBm.
+     * @param count Number of messages.
+     * @param symbols Destination of `count * WSPR_SYMBOL_COUNT` bytes.
+     * @param status Optional array of `count` per-item result codes; may be NULL.
+     * @return Number of messages encoded, or 0 if a required array is NULL.
+     */
+    WSPR_API size_t wspr_encode_batch(const char *const *callsigns, const char *const *locators, const int *powers,
+                                      size_t count, uint8_t *symbols, int *status);
+
+    /**
+     * @brief Encodes one Type 1 message straight into the packed form.
+     *
+     * Symbol `i` occupies bits `2 * (i % 4)` and `2 * (i % 4) + 1` of byte
+     * `i / 4`, independent of host endianness. Never allocates.
+     *
+     * @param callsign NUL-terminated callsign.
+     * @param locator NUL-terminated 4-character Maidenhead locator.
+     * @param power Power level in dBm.
+     * @param packed Destination of WSPR_PACKED_SIZE bytes.
+     * @return WSPR_OK, or the first field found to be invalid. On failure
+     *         `packed` is left unchanged.
+     */
+    WSPR_API int wspr_encode_packed(const char *callsign, const char *locator, int power, uint8_t *packed);
+
+    /**
+     * @brief Describes a result code.
+     *
+     * @param status A result code from this interface.
+     * @return A static, NUL-terminated description; never NULL.
+     */
+    WSPR_API const char *wspr_status_string(int status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WSPR_C_H */
@@ -0,0 +1,360 @@
+/**
+ * @file wspr_cache.cpp
+ * @brief Thread-safe bounded LRU cache of encoded WSPR messages.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_cache.hpp"
+#include "wspr_stats.hpp"
+#include <algorithm> // For: std::fill
+#include <cstring>   // For: std::memcpy
+
+/**
+ * @brief Creates an empty cache.
+ *
+ * @param capacity Maximum number of cached messages (at least 1).
+ *
+ * @note The index is sized to a power of two at least twice the capacity,
+ *       keeping linear probe sequences short.
+ */
+WsprCache::WsprCache(std::size_t capacity)
+{
+    if (capacity == 0)
+    {
+        capacity = 1;
+    }
+
+    std::size_t slots = 1;
+    while (slots < capacity * 2)
+    {
+        slots <<= 1;
+    }
+
+    entries_.resize(capacity);
+    index_.assign(slots, none);
+}
+
+/**
+ * @brief Returns the symbols for a message, encoding it only on a miss.
+ *
+ * @param callsign The callsign to encode (either case).
+ * @param location The 4-character Maidenhead locator (either case).
+ * @param power The power level in dBm.
+ * @param out Destination buffer of at least MSG_SIZE bytes.
+ * @return WsprStatus::ok, or the validation failure.
+ */
+WsprStatus WsprCache::encode(std::string_view callsign, std::string_view location, int power, uint8_t *out)
+{
+    WSPR_STAT_TIME(cache, 1);
+    WsprPayload payload;
+    WsprStatus result = WsprMessage::pack(callsign, location, power, payload);
+    if (result == WsprStatus::ok)
+    {
+        fetch(payload, out);
+    }
+    return result;
+}
+
+/**
+ * @brief Copies out a cached message, encoding and storing it on a miss.
+ *
+ * @param payload A validated Type 1 payload.
+ * @param out Destination buffer of at least MSG_SIZE bytes.
+ */
+void WsprCache::fetch(const WsprPayload &payload, uint8_t *out)
+{
+    if (lookup(payload, out))
+    {
+        WSPR_STAT_ADD(cache_hits, 1);
+        return;
+    }
+
+    // Encode without holding the lock, then publish the result
+    WSPR_STAT_ADD(cache_misses, 1);
+    WsprMessage::encode_payload(payload, out);
+    store(payload, out);
+}
+
+/**
+ * @brief Copies out a cached message, counting a hit or a miss.
+ *
+ * @param payload The packed payload to look up.
+ * @param out Destination buffer of at least MSG_SIZE bytes; untouched on a miss.
+ * @return True on a hit.
+ */
+bool WsprCache::lookup(const WsprPayload &payload, uint8_t *out)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::size_t slot = find_slot(payload.key());
+        if (slot != no_slot)
+        {
+            const uint32_t entry = index_[slot];
+            if (entry != head_)
+            {
+                unlink(entry);
+                push_front(entry);
+            }
+            std::memcpy(out, entries_[entry].symbols.data(), MSG_SIZE);
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+/**
+ * @brief Adds an encoded message unless it is already cached.
+ *
+ * @param payload The packed payload the symbols were encoded from.
+ * @param symbols The MSG_SIZE encoded symbols.
+ */
+void WsprCache::store(const WsprPayload &payload, const uint8_t *symbols)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (find_slot(payload.key()) == no_slot)
+    {
+        insert(payload.key(), symbols);
+    }
+}
+
+/**
+ * @brief Fills a WsprMessage's symbols through the cache.
+ *
+ * @param callsign The callsign to encode (either case).
+ * @param location The 4-character Maidenhead locator (either case).
+ * @param power The power level in dBm.
+ * @param message Message whose symbols are replaced on success; its
+ *        set_power() then works on the new message.
+ * @return WsprStatus::ok, or the validation failure.
+ */
+WsprStatus WsprCache::encode(std::string_view callsign, std::string_view location, int power, WsprMessage &message)
+{
+    WSPR_STAT_TIME(cache, 1);
+    WsprPayload payload;
+    WsprStatus result = WsprMessage::pack(callsign, location, power, payload);
+    if (result == WsprStatus::ok)
+    {
+        fetch(payload, message.symbols.data());
+        result = message.adopt(payload);
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the current counters.
+ *
+ * @return A snapshot of hit, miss, and eviction counts and occupancy.
+ */
+WsprCache::Stats WsprCache::stats() const
+{
+    Stats snapshot{};
+    snapshot.hits = hits_.load(std::memory_order_relaxed);
+    snapshot.misses = misses_.load(std::memory_order_relaxed);
+    snapshot.evictions = evictions_.load(std::memory_order_relaxed);
+    snapshot.capacity = entries_.size();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot.size = size_;
+    return snapshot;
+}
+
+/**
+ * @brief Returns the fraction of lookups served from the cache.
+ *
+ * @return Hits divided by total lookups, or 0 before the first lookup.
+ */
+double WsprCache::hit_rate() const noexcept
+{
+    const uint64_t hits = hits_.load(std::memory_order_relaxed);
+    const uint64_t total = hits + misses_.load(std::memory_order_relaxed);
+    return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+}
+
+/**
+ * @brief Drops every entry and resets the counters.
+ */
+void WsprCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fill(index_.begin(), index_.end(), none);
+    size_ = 0;
+    head_ = none;
+    tail_ = none;
+    hits_.store(0, std::memory_order_relaxed);
+    misses_.store(0, std::memory_order_relaxed);
+    evictions_.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Maps a key to its home slot in the index.
+ *
+ * @param key The packed payload key.
+ * @return Slot number in [0, index_.size()).
+ *
+ * @note Fibonacci hashing spreads the structured payload bits across the
+ *       high word before masking.
+ */
+std::size_t WsprCache::home_slot(uint64_t key) const noexcept
+{
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & (index_.size() - 1);
+}
+
+/**
+ * @brief Finds the index slot holding a key.
+ *
+ * @param key The packed payload key.
+ * @return The slot, or `no_slot` if the key is not cached.
+ */
+std::size_t WsprCache::find_slot(uint64_t key) const noexcept
+{
+    const std::size_t mask = index_.size() - 1;
+    for (std::size_t slot = home_slot(key);; slot = (slot + 1) & mask)
+    {
+        const uint32_t entry = index_[slot];
+        if (entry == none)
+        {
+            return no_slot;
+        }
+        if (entries_[entry].key == key)
+        {
+            return slot;
+        }
+    }
+}
+
+/**
+ * @brief Removes a slot from the index, closing the probe gap.
+ *
+ * @param slot The slot to clear.
+ *
+ * @note Uses backward-shift deletion: later members of the same probe run
+ *       move into the hole so lookups never need tombstones.
+ */
+void WsprCache::erase_slot(std::size_t slot) noexcept
+{
+    const std::size_t mask = index_.size() - 1;
+    std::size_t hole = slot;
+    index_[hole] = none;
+
+    for (std::size_t next = (hole + 1) & mask; index_[next] != none; next = (next + 1) & mask)
+    {
+        const std::size_t home = home_slot(entries_[index_[next]].key);
+
+        // Move the entry back if its home is not cyclically within (hole, next]
+        const bool stays = (hole <= next) ? (hole < home && home <= next)
+                                          : (hole < home || home <= next);
+        if (!stays)
+        {
+            index_[hole] = index_[next];
+            index_[next] = none;
+            hole = next;
+        }
+    }
+}
+
+/**
+ * @brief Unlinks an entry from the recency list.
+ *
+ * @param entry The entry to unlink.
+ */
+void WsprCache::unlink(uint32_t entry) noexcept
+{
+    Entry &e = entries_[entry];
+    if (e.prev != none)
+    {
+        entries_[e.prev].next = e.next;
+    }
+    else
+    {
+        head_ = e.next;
+    }
+    if (e.next != none)
+    {
+        entries_[e.next].prev = e.prev;
+    }
+    else
+    {
+        tail_ = e.prev;
+    }
+}
+
+/**
+ * @brief Links an entry in as the most recently used.
+ *
+ * @param entry The entry to link.
+ */
+void WsprCache::push_front(uint32_t entry) noexcept
+{
+    Entry &e = entries_[entry];
+    e.prev = none;
+    e.next = head_;
+    if (head_ != none)
+    {
+        entries_[head_].prev = entry;
+    }
+    head_ = entry;
+    if (tail_ == none)
+    {
+        tail_ = entry;
+    }
+}
+
+/**
+ * @brief Adds a freshly encoded message, evicting the oldest if full.
+ *
+ * @param key The packed payload key.
+ * @param symbols The encoded message.
+ *
+ * @note The caller must hold the lock and have checked that `key` is absent.
+ */
+void WsprCache::insert(uint64_t key, const uint8_t *symbols) noexcept
+{
+    uint32_t entry;
+    if (size_ < entries_.size())
+    {
+        entry = static_cast<uint32_t>(size_++);
+    }
+    else
+    {
+        // Reuse the least recently used entry
+        entry = tail_;
+        erase_slot(find_slot(entries_[entry].key));
+        unlink(entry);
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Entry &e = entries_[entry];
+    e.key = key;
+    std::memcpy(e.symbols.data(), symbols, MSG_SIZE);
+    push_front(entry);
+
+    const std::size_t mask = index_.size() - 1;
+    std::size_t slot = home_slot(key);
+    while (index_[slot] != none)
+    {
+        slot = (slot + 1) & mask;
+    }
+    index_[slot] = entry;
+}
@@ -0,0 +1,235 @@
+/**
+ * @file wspr_cache.hpp
+ * @brief Thread-safe bounded LRU cache of encoded WSPR messages.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_CACHE_H
+#define WSPR_CACHE_H
+
+#include "wspr_message.hpp"
+
+#include <atomic>      // For: std::atomic
+#include <cstddef>     // For: std::size_t
+#include <cstdint>     // For: uint8_t, uint32_t, uint64_t, SIZE_MAX
+#include <mutex>       // For: std::mutex
+#include <string_view> // For: std::string_view
+#include <vector>      // For: std::vector
+
+/**
+ * @class WsprCache
+ * @brief Remembers recently encoded messages so repeats cost one copy.
+ *
+ * Entries are keyed on the packed 28-bit callsign and 22-bit locator/power
+ * integers, so "k1abc"/"K1ABC" or "em18"/"EM18" share one entry. All storage
+ * is allocated up front by the constructor: a fixed pool of entries linked
+ * into a recency list, and an open-addressed index over them. Lookups,
+ * inserts, and evictions never allocate.
+ *
+ * All member functions may be called concurrently. Encoding on a miss runs
+ * outside the lock.
+ */
+class WsprCache
+{
+public:
+    /**
+     * @brief Default maximum number of cached messages.
+     */
+    static constexpr std::size_t default_capacity = 64;
+
+    /**
+     * @brief Snapshot of cache counters.
+     */
+    struct Stats
+    {
+        uint64_t hits;        ///< Lookups served from the cache.
+        uint64_t misses;      ///< Lookups that had to encode.
+        uint64_t evictions;   ///< Entries dropped to make room.
+        std::size_t size;     ///< Entries currently cached.
+        std::size_t capacity; ///< Maximum number of entries.
+    };
+
+    /**
+     * @brief Creates an empty cache.
+     *
+     * @param capacity Maximum number of cached messages (at least 1).
+     */
+    explicit WsprCache(std::size_t capacity = default_capacity);
+
+    WsprCache(const WsprCache &) = delete;
+    WsprCache &operator=(const WsprCache &) = delete;
+
+    /**
+     * @brief Returns the symbols for a message, encoding it only on a miss.
+     *
+     * Fields are validated as by WsprMessage::validate(); invalid input is
+     * neither encoded nor cached and leaves `out` untouched.
+     *
+     * @param callsign The callsign to encode (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The power level in dBm.
+     * @param out Destination buffer of at least MSG_SIZE bytes.
+     * @return WsprStatus::ok, or the validation failure.
+     */
+    WsprStatus encode(std::string_view callsign, std::string_view location, int power, uint8_t *out);
+
+    /**
+     * @brief Fills a WsprMessage's symbols through the cache.
+     *
+     * The message also records the new payload, so a later set_power()
+     * re-encodes from the new callsign rather than the previous one.
+     *
+     * @param callsign The callsign to encode (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The power level in dBm.
+     * @param message Message whose symbols are replaced on success.
+     * @return WsprStatus::ok, or the validation failure.
+     */
+    WsprStatus encode(std::string_view callsign, std::string_view location, int power, WsprMessage &message);
+
+    /**
+     * @brief Copies out a cached message, counting a hit or a miss.
+     *
+     * With store(), this splits encode() for callers that encode misses
+     * themselves, for example in batches.
+     *
+     * @param payload The packed payload to look up.
+     * @param out Destination buffer of at least MSG_SIZE bytes; untouched on a miss.
+     * @return True on a hit.
+     */
+    bool lookup(const WsprPayload &payload, uint8_t *out);
+
+    /**
+     * @brief Adds an encoded message unless it is already cached.
+     *
+     * @param payload The packed payload the symbols were encoded from.
+     * @param symbols The MSG_SIZE encoded symbols.
+     */
+    void store(const WsprPayload &payload, const uint8_t *symbols);
+
+    /**
+     * @brief Returns the current counters.
+     *
+     * @return A snapshot of hit, miss, and eviction counts and occupancy.
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Returns the fraction of lookups served from the cache.
+     *
+     * @return Hits divided by total lookups, or 0 before the first lookup.
+     */
+    double hit_rate() const noexcept;
+
+    /**
+     * @brief Drops every entry and resets the counters.
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Marks an empty index slot or the end of the recency list.
+     */
+    static constexpr uint32_t none = UINT32_MAX;
+
+    /**
+     * @brief Returned by find_slot() when a key is not cached.
+     */
+    static constexpr std::size_t no_slot = SIZE_MAX;
+
+    /**
+     * @brief One cached message and its recency-list links.
+     */
+    struct Entry
+    {
+        uint64_t key;                 ///< WsprPayload::key() of the message.
+        uint32_t prev;                ///< More recently used neighbour, or none.
+        uint32_t next;                ///< Less recently used neighbour, or none.
+        WsprMessage::Symbols symbols; ///< Encoded message.
+    };
+
+    /**
+     * @brief Maps a key to its home slot in the index.
+     *
+     * @param key The packed payload key.
+     * @return Slot number in [0, index_.size()).
+     */
+    std::size_t home_slot(uint64_t key) const noexcept;
+
+    /**
+     * @brief Finds the index slot holding a key.
+     *
+     * @param key The packed payload key.
+     * @return The slot, or `no_slot` if the key is not cached.
+     */
+    std::size_t find_slot(uint64_t key) const noexcept;
+
+    /**
+     * @brief Removes a slot from the index, closing the probe gap.
+     *
+     * @param slot The slot to clear.
+     */
+    void erase_slot(std::size_t slot) noexcept;
+
+    /**
+     * @brief Unlinks an entry from the recency list.
+     *
+     * @param entry The entry to unlink.
+     */
+    void unlink(uint32_t entry) noexcept;
+
+    /**
+     * @brief Copies out a cached message, encoding and storing it on a miss.
+     *
+     * @param payload A validated Type 1 payload.
+     * @param out Destination buffer of at least MSG_SIZE bytes.
+     */
+    void fetch(const WsprPayload &payload, uint8_t *out);
+
+    /**
+     * @brief Links an entry in as the most recently used.
+     *
+     * @param entry The entry to link.
+     */
+    void push_front(uint32_t entry) noexcept;
+
+    /**
+     * @brief Adds a freshly encoded message, evicting the oldest if full.
+     *
+     * @param key The packed payload key.
+     * @param symbols The encoded message.
+     */
+    void insert(uint64_t key, const uint8_t *symbols) noexcept;
+
+    mutable std::mutex mutex_;           ///< Guards everything below except the counters.
+    std::vector<Entry> entries_;         ///< Fixed pool of entries.
+    std::vector<uint32_t> index_;        ///< Open-addressed slots holding entry numbers.
+    std::size_t size_ = 0;               ///< Entries in use.
+    uint32_t head_ = none;               ///< Most recently used entry.
+    uint32_t tail_ = none;               ///< Least recently used entry.
+    std::atomic<uint64_t> hits_{0};      ///< Lookups served from the cache.
+    std::atomic<uint64_t> misses_{0};    ///< Lookups that had to encode.
+    std::atomic<uint64_t> evictions_{0}; ///< Entries dropped to make room.
+};
+
+#endif // WSPR_CACHE_H
@@ -0,0 +1,268 @@
+/**
+ * @file wspr_fano.cpp
+ * @brief Sequential (Fano) decoder for the WSPR K=32, rate 1/2 convolutional code.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_fano.hpp"
+
+#include <algorithm> // For: std::max
+#include <cmath>     // For: std::exp, std::log2, std::lround, std::sqrt
+
+// Flipping the input bit flips both outputs only if both polynomials tap bit 0
+static_assert((WsprMessage::poly_a & WsprMessage::poly_b & 1) == 1, "Fano branch pairing assumes both polynomials tap the newest bit");
+
+/**
+ * @brief Builds a metric table for an additive Gaussian noise channel.
+ *
+ * @param amplitude Expected soft value of a clean bit.
+ * @param sigma Noise standard deviation.
+ * @param bias Per-bit bias.
+ * @param scale Multiplier before rounding.
+ * @return The metric table.
+ */
+WsprFanoDecoder::MetricTable WsprFanoDecoder::make_metric_table(float amplitude, float sigma, float bias, float scale) noexcept
+{
+    MetricTable table{};
+    const double variance2 = 2.0 * static_cast<double>(sigma) * static_cast<double>(sigma);
+    for (int s = 0; s < 256; ++s)
+    {
+        const double y = s - 127.5;
+        // Log-likelihoods up to a shared constant, kept in the log domain to avoid underflow
+        const double l1 = -(y - amplitude) * (y - amplitude) / variance2;
+        const double l0 = -(y + amplitude) * (y + amplitude) / variance2;
+        const double peak = std::max(l0, l1);
+        const double mix = peak + std::log(0.5 * std::exp(l0 - peak) + 0.5 * std::exp(l1 - peak));
+        table[0][s] = static_cast<int>(std::lround(scale * ((l0 - mix) / std::log(2.0) - bias)));
+        table[1][s] = static_cast<int>(std::lround(scale * ((l1 - mix) / std::log(2.0) - bias)));
+    }
+    return table;
+}
+
+/**
+ * @brief Scales float soft values to the decoder's byte input.
+ *
+ * @param soft MSG_SIZE soft values.
+ * @param out MSG_SIZE soft bytes.
+ * @param target_rms RMS of the scaled values.
+ */
+void WsprFanoDecoder::quantize(const float *soft, uint8_t *out, float target_rms) noexcept
+{
+    double sum = 0.0;
+    for (std::size_t i = 0; i < MSG_SIZE; ++i)
+    {
+        sum += static_cast<double>(soft[i]) * soft[i];
+    }
+    const double rms = std::sqrt(sum / MSG_SIZE);
+    const double factor = (rms > 0.0) ? target_rms / rms : 0.0;
+    for (std::size_t i = 0; i < MSG_SIZE; ++i)
+    {
+        const long value = std::lround(128.0 + soft[i] * factor);
+        out[i] = static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+    }
+}
+
+/**
+ * @brief Constructs a decoder with the default metric table and options.
+ */
+WsprFanoDecoder::WsprFanoDecoder() noexcept
+    : WsprFanoDecoder(make_metric_table(), Options())
+{
+}
+
+/**
+ * @brief Constructs a decoder with the default Gaussian metric table.
+ *
+ * @param options Threshold step and budgets.
+ */
+WsprFanoDecoder::WsprFanoDecoder(const Options &options) noexcept
+    : WsprFanoDecoder(make_metric_table(), options)
+{
+}
+
+/**
+ * @brief Constructs a decoder with a caller-supplied metric table.
+ *
+ * @param metrics Branch metrics.
+ * @param options Threshold step and budgets.
+ */
+WsprFanoDecoder::WsprFanoDecoder(const MetricTable &metrics, const Options &options) noexcept
+    : metrics_(metrics), options_(options), nodes_{}
+{
+}
+
+/**
+ * @brief Orders the two branches leaving a node, best first.
+ *
+ * @param node The node to sort; its state must have a clear low bit.
+ */
+void WsprFanoDecoder::sort_branches(Node &node) noexcept
+{
+    const unsigned char pair = WsprMessage::encode_parity_pair(node.state);
+    const int zero = node.branch[pair];
+    const int one = node.branch[pair ^ 3];
+    if (zero >= one)
+    {
+        node.sorted[0] = zero;
+        node.sorted[1] = one;
+    }
+    else
+    {
+        node.sorted[0] = one;
+        node.sorted[1] = zero;
+        node.state |= 1;
+    }
+}
+
+/**
+ * @brief Decodes one candidate.
+ *
+ * @param soft MSG_SIZE soft bytes in encoder order.
+ * @return Status, payload, and search statistics.
+ */
+WsprFanoDecoder::Result WsprFanoDecoder::decode(const uint8_t *soft) noexcept
+{
+    using clock = std::chrono::steady_clock;
+
+    // Branch metrics for every output pair at every node; the only pass over the input
+    for (std::size_t k = 0; k < bits; ++k)
+    {
+        const uint8_t a = soft[2 * k];
+        const uint8_t b = soft[2 * k + 1];
+        Node &node = nodes_[k];
+        node.branch[0] = metrics_[0][a] + metrics_[0][b];
+        node.branch[1] = metrics_[1][a] + metrics_[0][b];
+        node.branch[2] = metrics_[0][a] + metrics_[1][b];
+        node.branch[3] = metrics_[1][a] + metrics_[1][b];
+    }
+
+    Node *const first = nodes_.data();
+    Node *const end = first + bits;
+    Node *const tail = end - 31; // Input bits are forced to zero from here on
+    const int delta = options_.delta;
+    const unsigned long budget = static_cast<unsigned long>(options_.max_cycles) * bits;
+    const bool timed = options_.timeout.count() > 0;
+    const clock::time_point deadline = timed ? clock::now() + options_.timeout : clock::time_point();
+
+    Result result;
+    Node *node = first;
+    node->state = 0;
+    node->gamma = 0;
+    node->tried = 0;
+    sort_branches(*node);
+
+    int threshold = 0;
+    unsigned long cycle = 1;
+    for (; cycle <= budget; ++cycle)
+    {
+        if (timed && (cycle & 4095) == 0 && clock::now() >= deadline)
+        {
+            result.status = WsprDecodeStatus::timeout;
+            break;
+        }
+        result.max_depth = std::max(result.max_depth, static_cast<std::size_t>(node - first));
+
+        // Look forward
+        const int next_gamma = node->gamma + node->sorted[node->tried];
+        if (next_gamma >= threshold)
+        {
+            // On the first visit to a node, tighten the threshold as far as it goes
+            if (node->gamma < threshold + delta)
+            {
+                while (next_gamma >= threshold + delta)
+                {
+                    threshold += delta;
+                }
+            }
+
+            if (node + 1 == end)
+            {
+                node->gamma = next_gamma; // Keep the final metric on the last node
+                result.status = WsprDecodeStatus::ok;
+                break;
+            }
+            node[1].gamma = next_gamma;
+            node[1].state = node->state << 1;
+            ++node;
+
+            if (node >= tail)
+            {
+                // Only the zero branch exists in the tail
+                node->sorted[0] = node->branch[WsprMessage::encode_parity_pair(node->state)];
+            }
+            else
+            {
+                sort_branches(*node);
+            }
+            node->tried = 0;
+            continue;
+        }
+
+        // Threshold violated: look back
+        for (;;)
+        {
+            if (node == first || node[-1].gamma < threshold)
+            {
+                // Cannot move back either; lower the threshold and retry the best branch
+                threshold -= delta;
+                if (node->tried != 0)
+                {
+                    node->tried = 0;
+                    node->state ^= 1;
+                }
+                break;
+            }
+            --node;
+            if (node < tail && node->tried != 1)
+            {
+                // Try the other branch from here
+                node->tried = 1;
+                node->state ^= 1;
+                break;
+            }
+        }
+    }
+
+    result.cycles = static_cast<unsigned int>(cycle < budget ? cycle : budget);
+    result.metric = node->gamma;
+    if (result.status == WsprDecodeStatus::ok)
+    {
+        // Each state holds the newest 32 input bits, so these two hold exactly N and M
+        result.payload.n = nodes_[27].state & 0x0FFFFFFF;
+        result.payload.m = nodes_[49].state & 0x003FFFFF;
+    }
+    return result;
+}
+
+/**
+ * @brief Quantizes and decodes one candidate.
+ *
+ * @param soft MSG_SIZE float soft values in encoder order.
+ * @return Status, payload, and search statistics.
+ */
+WsprFanoDecoder::Result WsprFanoDecoder::decode(const float *soft) noexcept
+{
+    uint8_t bytes[MSG_SIZE];
+    quantize(soft, bytes);
+    return decode(bytes);
+}
@@ -0,0 +1,209 @@
+/**
+ * @file wspr_fano.hpp
+ * @brief Sequential (Fano) decoder for the WSPR K=32, rate 1/2 convolutional code.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_FANO_H
+#define WSPR_FANO_H
+
+#include "wspr_message.hpp"
+
+#include <array>   // For: std::array
+#include <chrono>  // For: std::chrono::microseconds
+#include <cstddef> // For: std::size_t
+#include <cstdint> // For: uint8_t, uint32_t
+
+/**
+ * @brief Outcome of a Fano decode.
+ */
+enum class WsprDecodeStatus : uint8_t
+{
+    ok = 0,         ///< The decoder reached the end of the tail.
+    cycle_limit,    ///< The cycle budget ran out first.
+    timeout,        ///< The wall-clock budget ran out first.
+};
+
+/**
+ * @class WsprFanoDecoder
+ * @brief Recovers a WsprPayload from 162 soft bits in encoder order.
+ *
+ * This is the sequential decoder used by WSPR receivers, matched to
+ * WsprMessage's encoder: the branch outputs come from
+ * WsprMessage::encode_parity_pair(), so both sides share the generator
+ * polynomials, and the input is expected in the order produced by
+ * WsprReceiver::deinterleave(). A Viterbi decoder is not offered because a
+ * K=32 code has 2^31 states.
+ *
+ * The decoder searches the code tree one information bit per node. After
+ * each step it compares the path metric with a running threshold, moving
+ * back and lowering the threshold in steps of `delta` when the metric falls
+ * below it. The last 31 bits are the encoder's zero tail and are not searched.
+ * All working memory lives in the object and nothing is allocated per
+ * decode, so one decoder per thread can be reused for every candidate.
+ *
+ * Soft input is one byte per code bit: 0 is a confident 0, 255 a confident
+ * 1, and 128 an erasure. quantize() converts WsprReceiver's float soft
+ * values to this form.
+ */
+class WsprFanoDecoder
+{
+public:
+    /**
+     * @brief Branch metric per code bit value (row) and soft input byte (column).
+     */
+    using MetricTable = std::array<std::array<int, 256>, 2>;
+
+    /**
+     * @brief Number of information bits, including the 31-bit zero tail.
+     */
+    static constexpr std::size_t bits = MSG_SIZE / 2;
+
+    /**
+     * @brief Decoder settings.
+     */
+    struct Options
+    {
+        int delta = 60;                        ///< Threshold step, in metric units.
+        unsigned int max_cycles = 10000;       ///< Cycle budget per information bit.
+        std::chrono::microseconds timeout{0};  ///< Wall-clock budget per candidate, 0 for none.
+    };
+
+    /**
+     * @brief Result of one decode.
+     */
+    struct Result
+    {
+        WsprDecodeStatus status = WsprDecodeStatus::cycle_limit; ///< Whether the search completed.
+        WsprPayload payload;                                     ///< Decoded N and M, valid when status is ok.
+        int metric = 0;                                          ///< Final path metric.
+        unsigned int cycles = 0;                                 ///< Decoder cycles spent.
+        std::size_t max_depth = 0;                               ///< Deepest node reached.
+    };
+
+    /**
+     * @brief Builds a metric table for an additive Gaussian noise channel.
+     *
+     * Each entry is `scale * (log2(P(y | bit) / P(y)) - bias)`, rounded,
+     * where a soft byte `s` is read as `y = s - 127.5`. A transmitted 1 is
+     * centered at `+amplitude` and a 0 at `-amplitude`, both with standard
+     * deviation `sigma`.
+     *
+     * @param amplitude Expected soft value of a clean bit, relative to 127.5.
+     * @param sigma Noise standard deviation, in soft input units.
+     * @param bias Per-bit bias subtracted from the log-likelihood ratio.
+     * @param scale Multiplier applied before rounding to integers.
+     * @return The metric table.
+     */
+    static MetricTable make_metric_table(float amplitude = 50.0f, float sigma = 50.0f,
+                                         float bias = 0.45f, float scale = 10.0f) noexcept;
+
+    /**
+     * @brief Scales float soft values to the decoder's byte input.
+     *
+     * The values are scaled so that their RMS is `target_rms`, then offset
+     * by 128 and clamped to 0-255. This matches the amplitude the default
+     * metric table expects.
+     *
+     * @param soft MSG_SIZE soft values, positive meaning 1.
+     * @param out Destination for MSG_SIZE soft bytes.
+     * @param target_rms RMS of the scaled values.
+     */
+    static void quantize(const float *soft, uint8_t *out, float target_rms = 50.0f) noexcept;
+
+    /**
+     * @brief Constructs a decoder with the default metric table and options.
+     */
+    WsprFanoDecoder() noexcept;
+
+    /**
+     * @brief Constructs a decoder with the default Gaussian metric table.
+     *
+     * @param options Threshold step and budgets.
+     */
+    explicit WsprFanoDecoder(const Options &options) noexcept;
+
+    /**
+     * @brief Constructs a decoder with a caller-supplied metric table.
+     *
+     * @param metrics Branch metrics, copied into the decoder.
+     * @param options Threshold step and budgets.
+     */
+    WsprFanoDecoder(const MetricTable &metrics, const Options &options) noexcept;
+
+    /**
+     * @brief Decodes one candidate.
+     *
+     * @param soft MSG_SIZE soft bytes in encoder order.
+     * @return Status, payload, and search statistics.
+     */
+    Result decode(const uint8_t *soft) noexcept;
+
+    /**
+     * @brief Quantizes and decodes one candidate.
+     *
+     * @param soft MSG_SIZE float soft values in encoder order.
+     * @return Status, payload, and search statistics.
+     */
+    Result decode(const float *soft) noexcept;
+
+    /**
+     * @brief Returns the metric table in use.
+     *
+     * @return The branch metrics.
+     */
+    const MetricTable &metrics() const noexcept { return metrics_; }
+
+    /**
+     * @brief Returns the decoder settings.
+     *
+     * @return The options.
+     */
+    const Options &options() const noexcept { return options_; }
+
+private:
+    /**
+     * @brief One node of the code tree on the current path.
+     */
+    struct Node
+    {
+        uint32_t state;     ///< Encoder register after this node's bit.
+        int gamma;          ///< Path metric on arrival at this node.
+        int branch[4];      ///< Metric of each possible output pair.
+        int sorted[2];      ///< Metrics of the better and the worse branch.
+        int tried;          ///< Index into `sorted` of the branch being tried.
+    };
+
+    /**
+     * @brief Orders the two branches leaving a node, best first.
+     *
+     * @param node The node; its state low bit is set to the better branch's input bit.
+     */
+    static void sort_branches(Node &node) noexcept;
+
+    MetricTable metrics_;
+    Options options_;
+    std::array<Node, bits> nodes_;
+};
+
+#endif // WSPR_FANO_H
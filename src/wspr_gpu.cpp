@@ -0,0 +1,761 @@
+/**
+ * @file wspr_gpu.cpp
+ * @brief Optional OpenCL bulk encoder with a CPU fallback.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_gpu.hpp"
+#include "wspr_batch.hpp"
+
+#include <dlfcn.h> // For: dlopen, dlsym, dlclose
+#include <cstring> // For: std::memcpy, std::memset
+
+namespace
+{
+    /**
+     * @brief Defines the device kernel once, as OpenCL C text and as host C++.
+     *
+     * Stringizing the kernel gives the source handed to the OpenCL
+     * compiler; expanding it inside a namespace with the shims below gives
+     * a host copy of exactly the same code for emulate(). The kernel may
+     * therefore use only the common subset of OpenCL C and C++, and no
+     * preprocessor directives. Address space qualifiers are spelled
+     * WSPR_CL_KERNEL, WSPR_CL_GLOBAL and WSPR_CL_CONSTANT: a prelude maps
+     * them to the OpenCL keywords in the device source, and they expand to
+     * nothing on the host.
+     */
+#define WSPR_GPU_KERNEL(...)                           \
+    const char *const device_source =                  \
+        "#define WSPR_CL_KERNEL __kernel\n"            \
+        "#define WSPR_CL_GLOBAL __global\n"            \
+        "#define WSPR_CL_CONSTANT __constant\n"        \
+        #__VA_ARGS__;                                  \
+    namespace device                                   \
+    {                                                  \
+        using uchar = unsigned char;                   \
+        using uint = unsigned int;                     \
+        thread_local std::size_t global_id = 0;        \
+        inline std::size_t get_global_id(unsigned)     \
+        {                                              \
+            return global_id;                          \
+        }                                              \
+        inline uint popcount(uint x)                   \
+        {                                              \
+            return static_cast<uint>(__builtin_popcount(x)); \
+        }                                              \
+        __VA_ARGS__                                    \
+    }
+
+#define WSPR_CL_KERNEL
+#define WSPR_CL_GLOBAL
+#define WSPR_CL_CONSTANT
+
+    WSPR_GPU_KERNEL(
+        /* Packed value of a callsign or locator character, or -1 */
+        int wspr_value(uchar c)
+        {
+            if (c >= '0' && c <= '9')
+            {
+                return c - '0';
+            }
+            if (c >= 'A' && c <= 'Z')
+            {
+                return c - 'A' + 10;
+            }
+            if (c >= 'a' && c <= 'z')
+            {
+                return c - 'a' + 10;
+            }
+            return -1;
+        }
+
+        /* Validates and packs one record; returns a WsprStatus value */
+        uchar wspr_pack(WSPR_CL_GLOBAL const uchar *record, int power, uint *n_out, uint *m_out)
+        {
+            const int length = record[7];
+            if (length == 0 || length > 6)
+            {
+                return 1;
+            }
+
+            int shift = 0;
+            const int second = length >= 2 ? wspr_value(record[1]) : -1;
+            const int third = length >= 3 ? wspr_value(record[2]) : -1;
+            if (second >= 0 && second <= 9)
+            {
+                if (length > 5)
+                {
+                    return 1;
+                }
+                shift = 1;
+            }
+            else if (third < 0 || third > 9)
+            {
+                return 1;
+            }
+
+            const int digit = 2 - shift;
+            uint value[6] = {36, 36, 36, 36, 36, 36};
+            for (int i = 0; i < length; ++i)
+            {
+                const int v = wspr_value(record[i]);
+                const int ok = (i < digit) ? (v >= 0) : (i == digit || v >= 10);
+                if (!ok)
+                {
+                    return 1;
+                }
+                value[i + shift] = (uint)v;
+            }
+
+            if (record[12] != 4)
+            {
+                return 2;
+            }
+            const int field0 = wspr_value(record[8]) - 10;
+            const int field1 = wspr_value(record[9]) - 10;
+            const int square0 = wspr_value(record[10]);
+            const int square1 = wspr_value(record[11]);
+            if (field0 < 0 || field0 > 17 || field1 < 0 || field1 > 17 ||
+                square0 < 0 || square0 > 9 || square1 < 0 || square1 > 9)
+            {
+                return 2;
+            }
+
+            const int last = power % 10;
+            if (power < 0 || power > 60 || !(last == 0 || last == 3 || last == 7))
+            {
+                return 3;
+            }
+
+            uint n = value[0] * 36 + value[1];
+            n = n * 10 + value[2];
+            n = n * 27 + value[3] - 10;
+            n = n * 27 + value[4] - 10;
+            n = n * 27 + value[5] - 10;
+            *n_out = n;
+            *m_out = (uint)((179 - 10 * field0 - square0) * 180 + 10 * field1 + square1) * 128 + (uint)power + 64;
+            return 0;
+        }
+
+        /* Sets the data bits of the two symbols produced for one encoder step */
+        void wspr_emit(uint reg, uint *bit, WSPR_CL_CONSTANT const uchar *interleave, uchar *packed)
+        {
+            const uint a = popcount(reg & 0xf2d05351u) & 1u;
+            const uint b = popcount(reg & 0xe4613c47u) & 1u;
+            uint at = interleave[(*bit)++];
+            packed[at >> 2] |= (uchar)(a << (2 * (at & 3) + 1));
+            at = interleave[(*bit)++];
+            packed[at >> 2] |= (uchar)(b << (2 * (at & 3) + 1));
+        }
+
+        /* One message per work item: pack, encode, interleave, and write 41 packed bytes */
+        WSPR_CL_KERNEL void wspr_encode(WSPR_CL_GLOBAL const uchar *records, WSPR_CL_GLOBAL const int *powers,
+                                        const uint count, WSPR_CL_CONSTANT const uchar *interleave,
+                                        WSPR_CL_CONSTANT const uchar *sync_packed, WSPR_CL_GLOBAL uchar *out,
+                                        WSPR_CL_GLOBAL uchar *status)
+        {
+            const uint id = (uint)get_global_id(0);
+            if (id >= count)
+            {
+                return;
+            }
+
+            uint n = 0;
+            uint m = 0;
+            const uchar result = wspr_pack(records + (size_t)id * 16, powers[id], &n, &m);
+            status[id] = result;
+
+            uchar packed[41];
+            for (int i = 0; i < 41; ++i)
+            {
+                packed[i] = result == 0 ? sync_packed[i] : 0;
+            }
+
+            if (result == 0)
+            {
+                uint reg = 0;
+                uint bit = 0;
+                for (int i = 27; i >= 0; --i)
+                {
+                    reg = (reg << 1) | ((n >> i) & 1u);
+                    wspr_emit(reg, &bit, interleave, packed);
+                }
+                for (int i = 21; i >= 0; --i)
+                {
+                    reg = (reg << 1) | ((m >> i) & 1u);
+                    wspr_emit(reg, &bit, interleave, packed);
+                }
+                for (int i = 0; i < 31; ++i)
+                {
+                    reg <<= 1;
+                    wspr_emit(reg, &bit, interleave, packed);
+                }
+            }
+
+            WSPR_CL_GLOBAL uchar *row = out + (size_t)id * 41;
+            for (int i = 0; i < 41; ++i)
+            {
+                row[i] = packed[i];
+            }
+        })
+
+#undef WSPR_CL_KERNEL
+#undef WSPR_CL_GLOBAL
+#undef WSPR_CL_CONSTANT
+#undef WSPR_GPU_KERNEL
+
+    static_assert(WsprGpuEncoder::record_size == 16 && WsprPackedSymbols::size == 41,
+                  "The kernel hardcodes the record and packed row sizes");
+
+    /**
+     * @brief The sync vector alone, in packed form: the starting point of every row.
+     */
+    WsprPackedSymbols::Packed packed_sync() noexcept
+    {
+        return WsprPackedSymbols::pack(WsprMessage::sync_vector);
+    }
+
+    /**
+     * @brief Minimal OpenCL 1.2 types and constants, so no headers are needed.
+     */
+    namespace cl
+    {
+        using int_t = int32_t;
+        using uint_t = uint32_t;
+        using bitfield = uint64_t;
+        using platform_id = struct platform *;
+        using device_id = struct device_obj *;
+        using context = struct context_obj *;
+        using command_queue = struct queue_obj *;
+        using program = struct program_obj *;
+        using kernel = struct kernel_obj *;
+        using mem = struct mem_obj *;
+        using event = struct event_obj *;
+
+        constexpr int_t success = 0;
+        constexpr uint_t true_value = 1;
+        constexpr bitfield device_type_cpu = 1 << 1;
+        constexpr bitfield device_type_gpu = 1 << 2;
+        constexpr bitfield device_type_accelerator = 1 << 3;
+        constexpr bitfield device_type_all = 0xFFFFFFFF;
+        constexpr bitfield mem_write_only = 1 << 1;
+        constexpr bitfield mem_read_only = 1 << 2;
+        constexpr bitfield mem_copy_host_ptr = 1 << 5;
+        constexpr uint_t device_name = 0x102B;
+        constexpr uint_t program_build_log = 0x1183;
+    }
+}
+
+/**
+ * @brief OpenCL library handle, entry points, and device objects.
+ */
+struct WsprGpuEncoder::Device
+{
+    void *library = nullptr;
+
+    cl::int_t (*GetPlatformIDs)(cl::uint_t, cl::platform_id *, cl::uint_t *) = nullptr;
+    cl::int_t (*GetDeviceIDs)(cl::platform_id, cl::bitfield, cl::uint_t, cl::device_id *, cl::uint_t *) = nullptr;
+    cl::int_t (*GetDeviceInfo)(cl::device_id, cl::uint_t, std::size_t, void *, std::size_t *) = nullptr;
+    cl::context (*CreateContext)(const intptr_t *, cl::uint_t, const cl::device_id *, void (*)(const char *, const void *, std::size_t, void *), void *, cl::int_t *) = nullptr;
+    cl::command_queue (*CreateCommandQueue)(cl::context, cl::device_id, cl::bitfield, cl::int_t *) = nullptr;
+    cl::program (*CreateProgramWithSource)(cl::context, cl::uint_t, const char **, const std::size_t *, cl::int_t *) = nullptr;
+    cl::int_t (*BuildProgram)(cl::program, cl::uint_t, const cl::device_id *, const char *, void (*)(cl::program, void *), void *) = nullptr;
+    cl::int_t (*GetProgramBuildInfo)(cl::program, cl::device_id, cl::uint_t, std::size_t, void *, std::size_t *) = nullptr;
+    cl::kernel (*CreateKernel)(cl::program, const char *, cl::int_t *) = nullptr;
+    cl::mem (*CreateBuffer)(cl::context, cl::bitfield, std::size_t, void *, cl::int_t *) = nullptr;
+    cl::int_t (*SetKernelArg)(cl::kernel, cl::uint_t, std::size_t, const void *) = nullptr;
+    cl::int_t (*EnqueueWriteBuffer)(cl::command_queue, cl::mem, cl::uint_t, std::size_t, std::size_t, const void *, cl::uint_t, const cl::event *, cl::event *) = nullptr;
+    cl::int_t (*EnqueueReadBuffer)(cl::command_queue, cl::mem, cl::uint_t, std::size_t, std::size_t, void *, cl::uint_t, const cl::event *, cl::event *) = nullptr;
+    cl::int_t (*EnqueueNDRangeKernel)(cl::command_queue, cl::kernel, cl::uint_t, const std::size_t *, const std::size_t *, const std::size_t *, cl::uint_t, const cl::event *, cl::event *) = nullptr;
+    cl::int_t (*ReleaseMemObject)(cl::mem) = nullptr;
+    cl::int_t (*ReleaseKernel)(cl::kernel) = nullptr;
+    cl::int_t (*ReleaseProgram)(cl::program) = nullptr;
+    cl::int_t (*ReleaseCommandQueue)(cl::command_queue) = nullptr;
+    cl::int_t (*ReleaseContext)(cl::context) = nullptr;
+
+    cl::device_id id = nullptr;
+    cl::context context = nullptr;
+    cl::command_queue queue = nullptr;
+    cl::program program = nullptr;
+    cl::kernel kernel = nullptr;
+    cl::mem interleave = nullptr;   ///< Constant interleave table.
+    cl::mem sync = nullptr;         ///< Constant packed sync vector.
+    cl::mem records = nullptr;      ///< One chunk of field records.
+    cl::mem powers = nullptr;       ///< One chunk of power levels.
+    cl::mem out = nullptr;          ///< One chunk of packed rows.
+    cl::mem status = nullptr;       ///< One chunk of results.
+    std::string name;               ///< Device name.
+
+    /**
+     * @brief Resolves one entry point.
+     *
+     * @param slot Receives the function pointer.
+     * @param symbol Exported name.
+     * @return True if found.
+     */
+    template <typename Function>
+    bool load(Function &slot, const char *symbol) noexcept
+    {
+        slot = reinterpret_cast<Function>(dlsym(library, symbol));
+        return slot != nullptr;
+    }
+
+    /**
+     * @brief Releases every object that was created, then the library.
+     */
+    ~Device()
+    {
+        for (cl::mem buffer : {status, out, powers, records, sync, interleave})
+        {
+            if (buffer)
+            {
+                ReleaseMemObject(buffer);
+            }
+        }
+        if (kernel)
+        {
+            ReleaseKernel(kernel);
+        }
+        if (program)
+        {
+            ReleaseProgram(program);
+        }
+        if (queue)
+        {
+            ReleaseCommandQueue(queue);
+        }
+        if (context)
+        {
+            ReleaseContext(context);
+        }
+        if (library)
+        {
+            dlclose(library);
+        }
+    }
+};
+
+/**
+ * @brief Creates the encoder, setting up the device if one is requested.
+ *
+ * @param backend The preferred backend.
+ * @param chunk Messages per device dispatch.
+ */
+WsprGpuEncoder::WsprGpuEncoder(WsprGpuBackend backend, std::size_t chunk)
+    : chunk_(chunk == 0 ? default_chunk : chunk)
+{
+    if (backend != WsprGpuBackend::opencl)
+    {
+        reason_ = "CPU backend requested";
+        return;
+    }
+    if (!open_device())
+    {
+        device_.reset();
+        return;
+    }
+    records_.resize(chunk_ * record_size);
+    statuses_.resize(chunk_);
+}
+
+/**
+ * @brief Releases the device, if any.
+ */
+WsprGpuEncoder::~WsprGpuEncoder() = default;
+
+/**
+ * @brief Reports the backend currently in use.
+ *
+ * @return WsprGpuBackend::opencl while a device is in use.
+ */
+WsprGpuBackend WsprGpuEncoder::backend() const noexcept
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return device_ ? WsprGpuBackend::opencl : WsprGpuBackend::cpu;
+}
+
+/**
+ * @brief Describes the device in use.
+ *
+ * @return Device name, or "cpu" and the reason.
+ */
+std::string WsprGpuEncoder::device() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return device_ ? device_->name : "cpu (" + reason_ + ")";
+}
+
+/**
+ * @brief Tries to set up an OpenCL device.
+ *
+ * @return True if the device is ready.
+ */
+bool WsprGpuEncoder::open_device()
+{
+    std::unique_ptr<Device> dev(new Device);
+    dev->library = dlopen("libOpenCL.so.1", RTLD_NOW | RTLD_LOCAL);
+    if (!dev->library)
+    {
+        dev->library = dlopen("libOpenCL.so", RTLD_NOW | RTLD_LOCAL);
+    }
+    if (!dev->library)
+    {
+        reason_ = "no OpenCL runtime";
+        return false;
+    }
+
+    const bool loaded =
+        dev->load(dev->GetPlatformIDs, "clGetPlatformIDs") && dev->load(dev->GetDeviceIDs, "clGetDeviceIDs") &&
+        dev->load(dev->GetDeviceInfo, "clGetDeviceInfo") && dev->load(dev->CreateContext, "clCreateContext") &&
+        dev->load(dev->CreateCommandQueue, "clCreateCommandQueue") &&
+        dev->load(dev->CreateProgramWithSource, "clCreateProgramWithSource") &&
+        dev->load(dev->BuildProgram, "clBuildProgram") && dev->load(dev->GetProgramBuildInfo, "clGetProgramBuildInfo") &&
+        dev->load(dev->CreateKernel, "clCreateKernel") && dev->load(dev->CreateBuffer, "clCreateBuffer") &&
+        dev->load(dev->SetKernelArg, "clSetKernelArg") && dev->load(dev->EnqueueWriteBuffer, "clEnqueueWriteBuffer") &&
+        dev->load(dev->EnqueueReadBuffer, "clEnqueueReadBuffer") &&
+        dev->load(dev->EnqueueNDRangeKernel, "clEnqueueNDRangeKernel") &&
+        dev->load(dev->ReleaseMemObject, "clReleaseMemObject") && dev->load(dev->ReleaseKernel, "clReleaseKernel") &&
+        dev->load(dev->ReleaseProgram, "clReleaseProgram") &&
+        dev->load(dev->ReleaseCommandQueue, "clReleaseCommandQueue") && dev->load(dev->ReleaseContext, "clReleaseContext");
+    if (!loaded)
+    {
+        reason_ = "OpenCL runtime is missing entry points";
+        // Nothing was created, so only the library needs releasing
+        dlclose(dev->library);
+        dev->library = nullptr;
+        return false;
+    }
+
+    // Prefer a GPU, then an accelerator, then whatever OpenCL device exists
+    cl::platform_id platforms[16];
+    cl::uint_t platform_count = 0;
+    if (dev->GetPlatformIDs(16, platforms, &platform_count) != cl::success || platform_count == 0)
+    {
+        reason_ = "no OpenCL platform";
+        return false;
+    }
+    platform_count = platform_count < 16 ? platform_count : 16;
+    for (cl::bitfield type : {cl::device_type_gpu, cl::device_type_accelerator, cl::device_type_all})
+    {
+        for (cl::uint_t p = 0; p < platform_count && !dev->id; ++p)
+        {
+            cl::uint_t found = 0;
+            if (dev->GetDeviceIDs(platforms[p], type, 1, &dev->id, &found) != cl::success || found == 0)
+            {
+                dev->id = nullptr;
+            }
+        }
+        if (dev->id)
+        {
+            break;
+        }
+    }
+    if (!dev->id)
+    {
+        reason_ = "no OpenCL device";
+        return false;
+    }
+
+    char name[256] = {};
+    if (dev->GetDeviceInfo(dev->id, cl::device_name, sizeof(name) - 1, name, nullptr) == cl::success)
+    {
+        dev->name = name;
+    }
+
+    cl::int_t error = cl::success;
+    dev->context = dev->CreateContext(nullptr, 1, &dev->id, nullptr, nullptr, &error);
+    if (error == cl::success)
+    {
+        dev->queue = dev->CreateCommandQueue(dev->context, dev->id, 0, &error);
+    }
+    const char *source = device_source;
+    if (error == cl::success)
+    {
+        dev->program = dev->CreateProgramWithSource(dev->context, 1, &source, nullptr, &error);
+    }
+    if (error != cl::success)
+    {
+        reason_ = "OpenCL setup failed (error " + std::to_string(error) + ")";
+        return false;
+    }
+
+    if (dev->BuildProgram(dev->program, 1, &dev->id, "", nullptr, nullptr) != cl::success)
+    {
+        char log[512] = {};
+        dev->GetProgramBuildInfo(dev->program, dev->id, cl::program_build_log, sizeof(log) - 1, log, nullptr);
+        reason_ = std::string("OpenCL kernel build failed: ") + log;
+        return false;
+    }
+    dev->kernel = dev->CreateKernel(dev->program, "wspr_encode", &error);
+
+    // Constant tables are uploaded once; the per-chunk buffers are reused
+    WsprPackedSymbols::Packed sync = packed_sync();
+    WsprMessage::InterleaveTable interleave = WsprMessage::interleave_table;
+    const struct
+    {
+        cl::mem *buffer;
+        cl::bitfield flags;
+        std::size_t size;
+        void *host;
+    } buffers[] = {
+        {&dev->interleave, cl::mem_read_only | cl::mem_copy_host_ptr, interleave.size(), interleave.data()},
+        {&dev->sync, cl::mem_read_only | cl::mem_copy_host_ptr, sync.size(), sync.data()},
+        {&dev->records, cl::mem_read_only, chunk_ * record_size, nullptr},
+        {&dev->powers, cl::mem_read_only, chunk_ * sizeof(int), nullptr},
+        {&dev->out, cl::mem_write_only, chunk_ * WsprPackedSymbols::size, nullptr},
+        {&dev->status, cl::mem_write_only, chunk_, nullptr},
+    };
+    for (const auto &b : buffers)
+    {
+        if (error == cl::success)
+        {
+            *b.buffer = dev->CreateBuffer(dev->context, b.flags, b.size, b.host, &error);
+        }
+    }
+
+    // Every argument except the count stays the same across dispatches
+    const cl::mem *args[] = {&dev->records, &dev->powers, nullptr, &dev->interleave, &dev->sync, &dev->out, &dev->status};
+    for (cl::uint_t i = 0; i < 7 && error == cl::success; ++i)
+    {
+        if (args[i])
+        {
+            error = dev->SetKernelArg(dev->kernel, i, sizeof(cl::mem), args[i]);
+        }
+    }
+    if (error != cl::success)
+    {
+        reason_ = "OpenCL setup failed (error " + std::to_string(error) + ")";
+        return false;
+    }
+
+    device_ = std::move(dev);
+    return true;
+}
+
+/**
+ * @brief Fills device field records for a range of messages.
+ *
+ * Callsigns longer than six characters are recorded with length 7 so the
+ * kernel still rejects them; longer locators likewise get length 5.
+ *
+ * @param callsigns Array of `count` callsigns.
+ * @param locations Array of `count` locators.
+ * @param count Number of messages.
+ * @param records Destination of `count * record_size` bytes.
+ */
+void WsprGpuEncoder::make_records(const std::string_view *callsigns,
+                                  const std::string_view *locations,
+                                  std::size_t count,
+                                  uint8_t *records) noexcept
+{
+    std::memset(records, 0, count * record_size);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        uint8_t *record = records + i * record_size;
+        const std::size_t call = callsigns[i].size() < 7 ? callsigns[i].size() : 7;
+        const std::size_t loc = locations[i].size() < 5 ? locations[i].size() : 5;
+        std::memcpy(record, callsigns[i].data(), call);
+        record[7] = static_cast<uint8_t>(call);
+        std::memcpy(record + 8, locations[i].data(), loc < 4 ? loc : 4);
+        record[12] = static_cast<uint8_t>(loc);
+    }
+}
+
+/**
+ * @brief Encodes one chunk on the device.
+ *
+ * @param powers Array of `count` power levels in dBm.
+ * @param count Number of messages; records_ must be filled.
+ * @param out Destination block of `count` packed rows.
+ * @return True on success.
+ */
+bool WsprGpuEncoder::run_device(const int *powers, std::size_t count, uint8_t (*out)[WsprPackedSymbols::size])
+{
+    Device &dev = *device_;
+    const cl::uint_t items = static_cast<cl::uint_t>(count);
+    const std::size_t global = (count + 63) / 64 * 64;
+
+    cl::int_t error = dev.EnqueueWriteBuffer(dev.queue, dev.records, 0, 0, count * record_size, records_.data(), 0, nullptr, nullptr);
+    if (error == cl::success)
+    {
+        error = dev.EnqueueWriteBuffer(dev.queue, dev.powers, 0, 0, count * sizeof(int), powers, 0, nullptr, nullptr);
+    }
+    if (error == cl::success)
+    {
+        error = dev.SetKernelArg(dev.kernel, 2, sizeof(items), &items);
+    }
+    if (error == cl::success)
+    {
+        error = dev.EnqueueNDRangeKernel(dev.queue, dev.kernel, 1, nullptr, &global, nullptr, 0, nullptr, nullptr);
+    }
+    // Blocking reads also wait for the kernel to finish
+    if (error == cl::success)
+    {
+        error = dev.EnqueueReadBuffer(dev.queue, dev.out, cl::true_value, 0, count * WsprPackedSymbols::size, out[0], 0, nullptr, nullptr);
+    }
+    if (error == cl::success)
+    {
+        error = dev.EnqueueReadBuffer(dev.queue, dev.status, cl::true_value, 0, count, statuses_.data(), 0, nullptr, nullptr);
+    }
+
+    if (error != cl::success)
+    {
+        reason_ = "OpenCL dispatch failed (error " + std::to_string(error) + ")";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Encodes `count` messages into packed output rows.
+ *
+ * A device failure switches this encoder to the CPU path for good, and
+ * the whole call is redone there so the output is always complete.
+ *
+ * @param callsigns Array of `count` callsigns (either case).
+ * @param locations Array of `count` 4-character Maidenhead locators (either case).
+ * @param powers Array of `count` power levels in dBm.
+ * @param count Number of messages to encode.
+ * @param out Destination block of `count` packed rows.
+ * @param status Optional array of `count` per-item results.
+ * @return Number of messages successfully encoded.
+ */
+std::size_t WsprGpuEncoder::encode(const std::string_view *callsigns,
+                                   const std::string_view *locations,
+                                   const int *powers,
+                                   std::size_t count,
+                                   uint8_t (*out)[WsprPackedSymbols::size],
+                                   WsprStatus *status)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (device_)
+    {
+        std::size_t encoded = 0;
+        std::size_t base = 0;
+        for (; base < count; base += chunk_)
+        {
+            const std::size_t n = (count - base < chunk_) ? count - base : chunk_;
+            make_records(callsigns + base, locations + base, n, records_.data());
+            if (!run_device(powers + base, n, out + base))
+            {
+                break;
+            }
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                encoded += statuses_[i] == 0;
+                if (status)
+                {
+                    status[base + i] = static_cast<WsprStatus>(statuses_[i]);
+                }
+            }
+        }
+        if (base >= count)
+        {
+            return encoded;
+        }
+        device_.reset();
+    }
+    return encode_cpu(callsigns, locations, powers, count, out, status);
+}
+
+/**
+ * @brief The CPU path: WsprBatch on the best kernel, then packing.
+ *
+ * Messages go through a small stack block of unpacked rows, so nothing is
+ * allocated.
+ *
+ * @param callsigns Array of `count` callsigns (either case).
+ * @param locations Array of `count` 4-character Maidenhead locators (either case).
+ * @param powers Array of `count` power levels in dBm.
+ * @param count Number of messages to encode.
+ * @param out Destination block of `count` packed rows.
+ * @param status Optional array of `count` per-item results.
+ * @return Number of messages successfully encoded.
+ */
+std::size_t WsprGpuEncoder::encode_cpu(const std::string_view *callsigns,
+                                       const std::string_view *locations,
+                                       const int *powers,
+                                       std::size_t count,
+                                       uint8_t (*out)[WsprPackedSymbols::size],
+                                       WsprStatus *status) noexcept
+{
+    constexpr std::size_t block = 64;
+    uint8_t rows[block][MSG_SIZE];
+    std::size_t encoded = 0;
+    for (std::size_t base = 0; base < count; base += block)
+    {
+        const std::size_t n = (count - base < block) ? count - base : block;
+        encoded += WsprBatch::encode(callsigns + base, locations + base, powers + base, n, rows,
+                                     status ? status + base : nullptr);
+        WsprPackedSymbols::pack_batch(rows, n, out + base);
+    }
+    return encoded;
+}
+
+/**
+ * @brief Runs the device kernel source on the host, one work item at a time.
+ *
+ * @param callsigns Array of `count` callsigns (either case).
+ * @param locations Array of `count` 4-character Maidenhead locators (either case).
+ * @param powers Array of `count` power levels in dBm.
+ * @param count Number of messages to encode.
+ * @param out Destination block of `count` packed rows.
+ * @param status Optional array of `count` per-item results.
+ * @return Number of messages successfully encoded.
+ */
+std::size_t WsprGpuEncoder::emulate(const std::string_view *callsigns,
+                                    const std::string_view *locations,
+                                    const int *powers,
+                                    std::size_t count,
+                                    uint8_t (*out)[WsprPackedSymbols::size],
+                                    WsprStatus *status)
+{
+    std::vector<uint8_t> records(count * record_size);
+    std::vector<uint8_t> results(count);
+    make_records(callsigns, locations, count, records.data());
+    const WsprPackedSymbols::Packed sync = packed_sync();
+
+    std::size_t encoded = 0;
+    for (std::size_t id = 0; id < count; ++id)
+    {
+        device::global_id = id;
+        device::wspr_encode(records.data(), powers, static_cast<unsigned>(count), WsprMessage::interleave_table.data(),
+                            sync.data(), out[0], results.data());
+        encoded += results[id] == 0;
+        if (status)
+        {
+            status[id] = static_cast<WsprStatus>(results[id]);
+        }
+    }
+    return encoded;
+}
+
+/**
+ * @brief Returns the OpenCL C source of the device kernel.
+ *
+ * @return NUL-terminated kernel source.
+ */
+const char *WsprGpuEncoder::kernel_source() noexcept
+{
+    return device_source;
+}
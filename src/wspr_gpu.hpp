@@ -0,0 +1,229 @@
+/**
+ * @file wspr_gpu.hpp
+ * @brief Optional OpenCL bulk encoder with a CPU fallback.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_GPU_H
+#define WSPR_GPU_H
+
+#include "wspr_message.hpp"
+#include "wspr_packed.hpp"
+
+#include <cstddef>     // For: std::size_t
+#include <cstdint>     // For: uint8_t
+#include <memory>      // For: std::unique_ptr
+#include <mutex>       // For: std::mutex
+#include <string>      // For: std::string
+#include <string_view> // For: std::string_view
+#include <vector>      // For: std::vector
+
+/**
+ * @brief Where a WsprGpuEncoder runs its work.
+ */
+enum class WsprGpuBackend : uint8_t
+{
+    cpu = 0, ///< WsprBatch on the calling thread, with the best SIMD kernel.
+    opencl,  ///< An OpenCL device, preferring a GPU.
+};
+
+/**
+ * @class WsprGpuEncoder
+ * @brief Offloads validation, packing, encoding, and interleaving to an OpenCL device.
+ *
+ * Takes the same structure-of-arrays input as WsprBatch::encode() and
+ * writes 41-byte WsprPackedSymbols rows. Each work item handles one message
+ * end to end: it validates and packs the fields with the rules of
+ * WsprMessage::try_encode(), runs the K=32 encoder, and writes the
+ * interleaved, packed symbols. Only fixed 16-byte field records cross the
+ * bus on the way in, and 41 bytes per message on the way out.
+ *
+ * OpenCL is loaded with `dlopen()` when the encoder is constructed, so the
+ * library neither links against nor needs headers for it. When there is no
+ * OpenCL runtime or device, or when a device call fails, the encoder falls
+ * back to the CPU path and keeps using it. Both paths give identical
+ * output, and emulate() runs the device kernel source on the host so
+ * conformance tests can check it without a device.
+ *
+ * Calls on one encoder are serialized.
+ */
+class WsprGpuEncoder
+{
+public:
+    /**
+     * @brief Bytes per field record: callsign[7], its length, locator[4], its length, padding.
+     */
+    static constexpr std::size_t record_size = 16;
+
+    /**
+     * @brief Default number of messages sent to the device per dispatch.
+     */
+    static constexpr std::size_t default_chunk = 65536;
+
+    /**
+     * @brief Creates the encoder, setting up the device if one is requested.
+     *
+     * Never fails: if OpenCL cannot be used, backend() reports
+     * WsprGpuBackend::cpu and device() says why.
+     *
+     * @param backend The preferred backend.
+     * @param chunk Messages per device dispatch; bounds host and device buffers.
+     */
+    explicit WsprGpuEncoder(WsprGpuBackend backend = WsprGpuBackend::opencl, std::size_t chunk = default_chunk);
+
+    /**
+     * @brief Releases the device, if any.
+     */
+    ~WsprGpuEncoder();
+
+    WsprGpuEncoder(const WsprGpuEncoder &) = delete;
+    WsprGpuEncoder &operator=(const WsprGpuEncoder &) = delete;
+
+    /**
+     * @brief Reports the backend currently in use.
+     *
+     * @return WsprGpuBackend::opencl while a device is in use, otherwise cpu.
+     */
+    WsprGpuBackend backend() const noexcept;
+
+    /**
+     * @brief Describes the device in use.
+     *
+     * @return The OpenCL device name, or "cpu" followed by the reason the
+     *         device is not in use.
+     */
+    std::string device() const;
+
+    /**
+     * @brief Encodes `count` messages into packed output rows.
+     *
+     * Arguments and results match WsprBatch::encode(), except that rows
+     * are packed. Rows of rejected items are zeroed.
+     *
+     * @param callsigns Array of `count` callsigns (either case).
+     * @param locations Array of `count` 4-character Maidenhead locators (either case).
+     * @param powers Array of `count` power levels in dBm.
+     * @param count Number of messages to encode.
+     * @param out Destination block of `count` packed rows.
+     * @param status Optional array of `count` per-item results; may be nullptr.
+     * @return Number of messages successfully encoded.
+     */
+    std::size_t encode(const std::string_view *callsigns,
+                       const std::string_view *locations,
+                       const int *powers,
+                       std::size_t count,
+                       uint8_t (*out)[WsprPackedSymbols::size],
+                       WsprStatus *status);
+
+    /**
+     * @brief The CPU path: WsprBatch on the best kernel, then packing.
+     *
+     * @param callsigns Array of `count` callsigns (either case).
+     * @param locations Array of `count` 4-character Maidenhead locators (either case).
+     * @param powers Array of `count` power levels in dBm.
+     * @param count Number of messages to encode.
+     * @param out Destination block of `count` packed rows.
+     * @param status Optional array of `count` per-item results; may be nullptr.
+     * @return Number of messages successfully encoded.
+     */
+    static std::size_t encode_cpu(const std::string_view *callsigns,
+                                  const std::string_view *locations,
+                                  const int *powers,
+                                  std::size_t count,
+                                  uint8_t (*out)[WsprPackedSymbols::size],
+                                  WsprStatus *status) noexcept;
+
+    /**
+     * @brief Runs the device kernel source on the host, one work item at a time.
+     *
+     * This compiles the same kernel text that is sent to the device as
+     * C++, so the kernel can be checked against the other encoders on
+     * machines without OpenCL. It is slow and meant for tests.
+     *
+     * @param callsigns Array of `count` callsigns (either case).
+     * @param locations Array of `count` 4-character Maidenhead locators (either case).
+     * @param powers Array of `count` power levels in dBm.
+     * @param count Number of messages to encode.
+     * @param out Destination block of `count` packed rows.
+     * @param status Optional array of `count` per-item results; may be nullptr.
+     * @return Number of messages successfully encoded.
+     */
+    static std::size_t emulate(const std::string_view *callsigns,
+                               const std::string_view *locations,
+                               const int *powers,
+                               std::size_t count,
+                               uint8_t (*out)[WsprPackedSymbols::size],
+                               WsprStatus *status);
+
+    /**
+     * @brief Returns the OpenCL C source of the device kernel.
+     *
+     * @return NUL-terminated kernel source.
+     */
+    static const char *kernel_source() noexcept;
+
+private:
+    /**
+     * @brief Fills device field records for a range of messages.
+     *
+     * @param callsigns Array of `count` callsigns.
+     * @param locations Array of `count` locators.
+     * @param count Number of messages.
+     * @param records Destination of `count * record_size` bytes.
+     */
+    static void make_records(const std::string_view *callsigns,
+                             const std::string_view *locations,
+                             std::size_t count,
+                             uint8_t *records) noexcept;
+
+    /**
+     * @brief OpenCL library handle, entry points, and device objects.
+     */
+    struct Device;
+
+    /**
+     * @brief Tries to set up an OpenCL device.
+     *
+     * @return True if the device is ready; otherwise reason_ says why not.
+     */
+    bool open_device();
+
+    /**
+     * @brief Encodes one chunk on the device.
+     *
+     * @param powers Array of `count` power levels in dBm.
+     * @param count Number of messages, at most chunk_; records_ must be filled.
+     * @param out Destination block of `count` packed rows.
+     * @return True on success; otherwise reason_ says what failed.
+     */
+    bool run_device(const int *powers, std::size_t count, uint8_t (*out)[WsprPackedSymbols::size]);
+
+    std::size_t chunk_;               ///< Messages per device dispatch.
+    std::unique_ptr<Device> device_;  ///< Device state, or nullptr on the CPU path.
+    std::string reason_;              ///< Why the CPU path is in use.
+    std::vector<uint8_t> records_;    ///< Host staging for one chunk of field records.
+    std::vector<uint8_t> statuses_;   ///< Host staging for one chunk of results.
+    mutable std::mutex mutex_;        ///< Serializes encode() and guards the state above.
+};
+
+#endif // WSPR_GPU_H
@@ -0,0 +1,510 @@
+/**
+ * @file wspr_index.cpp
+ * @brief Reverse lookup from transmitted symbols to the message payload.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_index.hpp"
+#include "wspr_batch.hpp"
+#include "wspr_packed.hpp"
+
+#include <algorithm> // For: std::sort, std::min
+#include <cstring>   // For: std::memcmp, std::memcpy
+
+namespace
+{
+    constexpr char magic[8] = {'W', 'S', 'P', 'R', 'I', 'D', 'X', '1'}; ///< Serialized signature.
+    constexpr std::size_t insert_block = 1024;                          ///< Payloads encoded per batch call.
+
+    /**
+     * @brief Stores a little-endian integer of `bytes` bytes.
+     *
+     * @param out Destination.
+     * @param value The value to store.
+     * @param bytes Number of bytes.
+     */
+    void store_le(uint8_t *out, uint64_t value, std::size_t bytes) noexcept
+    {
+        for (std::size_t i = 0; i < bytes; ++i)
+        {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    /**
+     * @brief Loads a little-endian integer of `bytes` bytes.
+     *
+     * @param in Source.
+     * @param bytes Number of bytes.
+     * @return The value.
+     */
+    uint64_t load_le(const uint8_t *in, std::size_t bytes) noexcept
+    {
+        uint64_t value = 0;
+        for (std::size_t i = 0; i < bytes; ++i)
+        {
+            value |= static_cast<uint64_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    /**
+     * @brief Loads eight bytes as a little-endian word with a single load.
+     *
+     * @param in Source.
+     * @return The value.
+     */
+    inline uint64_t load_word(const uint8_t *in) noexcept
+    {
+        uint64_t value;
+        std::memcpy(&value, in, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        value = __builtin_bswap64(value);
+#endif
+        return value;
+    }
+
+    /**
+     * @brief The 64-bit finalizer from SplitMix64.
+     *
+     * @param x Value to scramble.
+     * @return Scrambled value.
+     */
+    constexpr uint64_t scramble(uint64_t x) noexcept
+    {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * @brief Character for a packed callsign or locator value.
+     *
+     * @param value 0-9 for digits, 10-35 for letters, 36 for a space.
+     * @return The character.
+     */
+    constexpr char value_char(uint32_t value) noexcept
+    {
+        return value < 10 ? static_cast<char>('0' + value)
+                          : (value < 36 ? static_cast<char>('A' + value - 10) : ' ');
+    }
+}
+
+/**
+ * @brief Creates an empty index sized for `expected` messages.
+ *
+ * @param expected Number of messages to make room for.
+ */
+WsprReverseIndex::WsprReverseIndex(std::size_t expected)
+{
+    reserve(expected);
+}
+
+/**
+ * @brief Validates, packs, and indexes a Type 1 message.
+ *
+ * @param callsign The callsign (either case).
+ * @param location The 4-character Maidenhead locator (either case).
+ * @param power The power level in dBm.
+ * @return WsprStatus::ok, or the validation failure.
+ */
+WsprStatus WsprReverseIndex::insert(std::string_view callsign, std::string_view location, int power)
+{
+    WsprPayload payload;
+    const WsprStatus result = WsprMessage::pack(callsign, location, power, payload);
+    if (result == WsprStatus::ok)
+    {
+        insert(payload);
+    }
+    return result;
+}
+
+/**
+ * @brief Indexes an already packed payload of any message type.
+ *
+ * @param payload The payload to index.
+ */
+void WsprReverseIndex::insert(const WsprPayload &payload)
+{
+    uint8_t symbols[MSG_SIZE];
+    WsprMessage::encode_payload(payload, symbols);
+    place(fingerprint(symbols), payload.key());
+}
+
+/**
+ * @brief Indexes a block of payloads, encoding them with the batch encoder.
+ *
+ * @param payloads Array of `count` payloads.
+ * @param count Number of payloads.
+ * @param kernel Batch encoder kernel.
+ */
+void WsprReverseIndex::insert(const WsprPayload *payloads, std::size_t count, WsprKernel kernel)
+{
+    reserve(size_ + count);
+    std::vector<uint8_t> buffer(std::min(count, insert_block) * MSG_SIZE);
+    auto rows = reinterpret_cast<uint8_t(*)[MSG_SIZE]>(buffer.data());
+    for (std::size_t i = 0; i < count; i += insert_block)
+    {
+        const std::size_t block = std::min(insert_block, count - i);
+        WsprBatch::encode_payloads(payloads + i, block, rows, kernel);
+        for (std::size_t j = 0; j < block; ++j)
+        {
+            place(fingerprint(rows[j]), payloads[i + j].key());
+        }
+    }
+}
+
+/**
+ * @brief Makes room for `count` messages without further growth.
+ *
+ * @param count Total number of messages to make room for.
+ */
+void WsprReverseIndex::reserve(std::size_t count)
+{
+    // At most half the slots are used, which keeps probe runs short
+    std::size_t capacity = 16;
+    while (capacity < 2 * count)
+    {
+        capacity *= 2;
+    }
+    if (capacity > slots_.size())
+    {
+        rehash(capacity);
+    }
+}
+
+/**
+ * @brief Returns the number of indexed messages.
+ *
+ * @return Message count.
+ */
+std::size_t WsprReverseIndex::size() const noexcept
+{
+    return size_;
+}
+
+/**
+ * @brief Removes every message, keeping the table allocation.
+ */
+void WsprReverseIndex::clear() noexcept
+{
+    std::fill(slots_.begin(), slots_.end(), Slot{0, empty});
+    size_ = 0;
+}
+
+/**
+ * @brief Looks up a capture given as symbols.
+ *
+ * @param symbols Buffer of MSG_SIZE symbols, each 0-3; sync bits are ignored.
+ * @param payload Receives the payload on a hit.
+ * @return True if the data bits match an indexed message.
+ */
+bool WsprReverseIndex::find(const uint8_t *symbols, WsprPayload &payload) const noexcept
+{
+    return lookup(fingerprint(symbols), payload);
+}
+
+/**
+ * @brief Looks up a capture given as WsprPackedSymbols bytes.
+ *
+ * @param packed Buffer of WsprPackedSymbols::size bytes.
+ * @param payload Receives the payload on a hit.
+ * @return True if the data bits match an indexed message.
+ */
+bool WsprReverseIndex::find_packed(const uint8_t *packed, WsprPayload &payload) const noexcept
+{
+    // Each byte holds four symbols; bits 1, 3, 5, and 7 are their data bits.
+    // The last byte holds two, and its padding bits are ignored.
+    DataWords words{};
+    for (std::size_t i = 0; i < WsprPackedSymbols::size; ++i)
+    {
+        const uint32_t used = (i + 1 < WsprPackedSymbols::size) ? 0xFF : (1u << (2 * (MSG_SIZE % 4))) - 1;
+        uint32_t bits = ((packed[i] & used) >> 1) & 0x55;
+        bits = (bits | (bits >> 1)) & 0x33;
+        bits = (bits | (bits >> 2)) & 0x0F;
+        words[i / 16] |= static_cast<uint64_t>(bits) << (4 * (i % 16));
+    }
+    return lookup(mix(words), payload);
+}
+
+/**
+ * @brief Looks up a capture given as data bits with the sync stripped.
+ *
+ * @param bits Buffer of MSG_SIZE bits, each 0 or 1, in symbol order.
+ * @param payload Receives the payload on a hit.
+ * @return True if the data bits match an indexed message.
+ */
+bool WsprReverseIndex::find_bits(const uint8_t *bits, WsprPayload &payload) const noexcept
+{
+    return lookup(mix(gather(bits, 0)), payload);
+}
+
+/**
+ * @brief Turns a Type 1 payload back into its callsign, locator, and power.
+ *
+ * The fields are rebuilt by inverting the packing, then packed again; a
+ * payload that does not survive the round trip is not Type 1.
+ *
+ * @param payload The payload to unpack.
+ * @param fields Receives the fields on success.
+ * @return False if the payload is not a valid Type 1 message.
+ */
+bool WsprReverseIndex::unpack(const WsprPayload &payload, WsprFields &fields) noexcept
+{
+    // N = ((v0 * 36 + v1) * 10 + v2) * 27^3 + letters, last three offset by 10
+    uint32_t n = payload.n;
+    char aligned[6];
+    for (int i = 5; i >= 3; --i)
+    {
+        aligned[i] = value_char(n % 27 + 10);
+        n /= 27;
+    }
+    aligned[2] = value_char(n % 10);
+    n /= 10;
+    aligned[1] = value_char(n % 36);
+    aligned[0] = value_char(n / 36);
+
+    // A leading space marks a callsign shifted right; trailing spaces are padding
+    std::size_t first = aligned[0] == ' ' ? 1 : 0;
+    std::size_t last = 6;
+    while (last > first && aligned[last - 1] == ' ')
+    {
+        --last;
+    }
+    WsprFields out;
+    std::memcpy(out.callsign.data(), aligned + first, last - first);
+
+    // M = grid * 128 + power + 64, grid = (179 - 10 * field0 - square0) * 180 + 10 * field1 + square1
+    const uint32_t grid = payload.m >> 7;
+    const uint32_t row = 179 - std::min<uint32_t>(grid / 180, 179);
+    out.locator = {static_cast<char>('A' + row / 10), static_cast<char>('A' + (grid % 180) / 10),
+                   static_cast<char>('0' + row % 10), static_cast<char>('0' + grid % 10), '\0'};
+    out.power = static_cast<int>(payload.m & 0x7F) - 64;
+
+    WsprPayload check;
+    if (WsprMessage::pack(out.callsign.data(), std::string_view(out.locator.data(), 4), out.power, check) !=
+            WsprStatus::ok ||
+        check != payload)
+    {
+        return false;
+    }
+    fields = out;
+    return true;
+}
+
+/**
+ * @brief Writes the compact serialized form.
+ *
+ * @return header_size + 7 bytes per message.
+ */
+std::vector<uint8_t> WsprReverseIndex::serialize() const
+{
+    std::vector<uint64_t> keys;
+    keys.reserve(size_);
+    for (const Slot &slot : slots_)
+    {
+        if (slot.key != empty)
+        {
+            keys.push_back(slot.key);
+        }
+    }
+    // Sorted, so equal sets serialize identically whatever the insertion order
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<uint8_t> out(header_size + keys.size() * WsprPayload::byte_size);
+    std::memcpy(out.data(), magic, sizeof(magic));
+    store_le(out.data() + 8, version, 4);
+    store_le(out.data() + 12, WsprPayload::byte_size, 4);
+    store_le(out.data() + 16, keys.size(), 8);
+    uint8_t *record = out.data() + header_size;
+    for (uint64_t key : keys)
+    {
+        WsprPayload::from_key(key).to_bytes(record);
+        record += WsprPayload::byte_size;
+    }
+    return out;
+}
+
+/**
+ * @brief Replaces the contents with a serialized index.
+ *
+ * @param data Serialized bytes from serialize().
+ * @param size Number of bytes.
+ * @param kernel Batch encoder kernel used to rebuild the fingerprints.
+ * @return False, leaving the index unchanged, if the data is malformed.
+ */
+bool WsprReverseIndex::deserialize(const uint8_t *data, std::size_t size, WsprKernel kernel)
+{
+    if (data == nullptr || size < header_size)
+    {
+        return false;
+    }
+    const uint64_t count = load_le(data + 16, 8);
+    const bool valid = std::memcmp(data, magic, sizeof(magic)) == 0 &&
+                       load_le(data + 8, 4) == version &&
+                       load_le(data + 12, 4) == WsprPayload::byte_size &&
+                       count == (size - header_size) / WsprPayload::byte_size &&
+                       (size - header_size) % WsprPayload::byte_size == 0;
+    if (!valid)
+    {
+        return false;
+    }
+
+    std::vector<WsprPayload> payloads(static_cast<std::size_t>(count));
+    for (std::size_t i = 0; i < payloads.size(); ++i)
+    {
+        payloads[i] = WsprPayload::from_bytes(data + header_size + i * WsprPayload::byte_size);
+    }
+
+    WsprReverseIndex loaded(payloads.size());
+    loaded.insert(payloads.data(), payloads.size(), kernel);
+    *this = std::move(loaded);
+    return true;
+}
+
+/**
+ * @brief Fingerprint of symbols, as used by find().
+ *
+ * @param symbols Buffer of MSG_SIZE symbols, each 0-3.
+ * @return 64-bit fingerprint of the data bits.
+ */
+uint64_t WsprReverseIndex::fingerprint(const uint8_t *symbols) noexcept
+{
+    return mix(gather(symbols, 1));
+}
+
+/**
+ * @brief Gathers the data bits of MSG_SIZE symbols.
+ *
+ * Eight symbols are read as one little-endian word; the multiply moves
+ * bit `shift` of byte k to bit 56 + k without carries between them.
+ *
+ * @param symbols Symbols, each 0-3, or bits with `shift` 0.
+ * @param shift 1 to take the high bit of each symbol, 0 for plain bits.
+ * @return The data words.
+ */
+WsprReverseIndex::DataWords WsprReverseIndex::gather(const uint8_t *symbols, unsigned shift) noexcept
+{
+    DataWords words{};
+    constexpr std::size_t whole = MSG_SIZE / 8;
+    for (std::size_t i = 0; i < whole; ++i)
+    {
+        const uint64_t lanes = (load_word(symbols + 8 * i) >> shift) & 0x0101010101010101ULL;
+        words[i / 8] |= ((lanes * 0x0102040810204080ULL) >> 56) << (8 * (i % 8));
+    }
+    for (std::size_t i = 8 * whole; i < MSG_SIZE; ++i)
+    {
+        words[i / 64] |= static_cast<uint64_t>((symbols[i] >> shift) & 1) << (i % 64);
+    }
+    return words;
+}
+
+/**
+ * @brief Hashes data words into a fingerprint.
+ *
+ * @param words The data words.
+ * @return The fingerprint.
+ */
+uint64_t WsprReverseIndex::mix(const DataWords &words) noexcept
+{
+    uint64_t hash = scramble(words[0] + 0x57535052ULL);
+    hash = scramble(hash ^ words[1]);
+    return scramble(hash ^ words[2]);
+}
+
+/**
+ * @brief Files a fingerprint and key, growing the table if needed.
+ *
+ * @param fingerprint The fingerprint.
+ * @param key The payload key.
+ */
+void WsprReverseIndex::place(uint64_t fingerprint, uint64_t key)
+{
+    if (2 * (size_ + 1) > slots_.size())
+    {
+        rehash(slots_.empty() ? 16 : 2 * slots_.size());
+    }
+    const std::size_t mask = slots_.size() - 1;
+    for (std::size_t i = static_cast<std::size_t>(fingerprint) & mask;; i = (i + 1) & mask)
+    {
+        Slot &slot = slots_[i];
+        if (slot.key == empty)
+        {
+            slot = Slot{fingerprint, key};
+            ++size_;
+            return;
+        }
+        if (slot.fingerprint == fingerprint && slot.key == key)
+        {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Probes for a fingerprint.
+ *
+ * @param fingerprint The fingerprint.
+ * @param payload Receives the payload on a hit.
+ * @return True on a hit.
+ */
+bool WsprReverseIndex::lookup(uint64_t fingerprint, WsprPayload &payload) const noexcept
+{
+    if (slots_.empty())
+    {
+        return false;
+    }
+    const std::size_t mask = slots_.size() - 1;
+    for (std::size_t i = static_cast<std::size_t>(fingerprint) & mask;; i = (i + 1) & mask)
+    {
+        const Slot &slot = slots_[i];
+        if (slot.key == empty)
+        {
+            return false;
+        }
+        if (slot.fingerprint == fingerprint)
+        {
+            payload = WsprPayload::from_key(slot.key);
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Rebuilds the table with `capacity` slots.
+ *
+ * @param capacity New slot count, a power of two.
+ */
+void WsprReverseIndex::rehash(std::size_t capacity)
+{
+    std::vector<Slot> old(capacity, Slot{0, empty});
+    old.swap(slots_);
+    size_ = 0;
+    for (const Slot &slot : old)
+    {
+        if (slot.key != empty)
+        {
+            place(slot.fingerprint, slot.key);
+        }
+    }
+}
@@ -0,0 +1,274 @@
+/**
+ * @file wspr_index.hpp
+ * @brief Reverse lookup from transmitted symbols to the message payload.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_INDEX_H
+#define WSPR_INDEX_H
+
+#include "wspr_message.hpp"
+#include "wspr_simd.hpp"
+
+#include <array>       // For: std::array
+#include <cstddef>     // For: std::size_t
+#include <cstdint>     // For: uint8_t, uint32_t, uint64_t
+#include <string_view> // For: std::string_view
+#include <vector>      // For: std::vector
+
+/**
+ * @brief Human-readable fields of a Type 1 payload.
+ */
+struct WsprFields
+{
+    std::array<char, 7> callsign{}; ///< Callsign, NUL-terminated.
+    std::array<char, 5> locator{};  ///< 4-character locator, NUL-terminated.
+    int power = 0;                  ///< Power level in dBm.
+};
+
+/**
+ * @class WsprReverseIndex
+ * @brief Maps captured symbols of a known station set back to their payloads.
+ *
+ * Each indexed payload is encoded once and filed under a 64-bit
+ * fingerprint of its 162 data bits, the high bit of each symbol. The sync
+ * bits are ignored, so a capture can be looked up as full symbols, as
+ * packed symbols, or as the data bits alone. A lookup is a fingerprint
+ * computation and one probe of a flat open-addressing table, with no
+ * re-encoding, and unpack() turns the payload back into text.
+ *
+ * A hit means the capture's data bits have the same 64-bit fingerprint
+ * as an indexed message. A capture with bit errors misses rather than
+ * matching a neighbour; decode those with WsprFanoDecoder instead.
+ *
+ * The serialized form holds only the sorted 7-byte payloads. Fingerprints
+ * are rebuilt on load with the batch encoder, so the stored index is
+ * independent of the fingerprint function and of byte order.
+ *
+ * The index is not thread-safe for writers. Concurrent lookups are safe
+ * while nothing is inserted.
+ */
+class WsprReverseIndex
+{
+public:
+    /**
+     * @brief Serialized format version written and accepted.
+     */
+    static constexpr uint32_t version = 1;
+
+    /**
+     * @brief Size of the serialized header in bytes.
+     */
+    static constexpr std::size_t header_size = 24;
+
+    /**
+     * @brief Creates an empty index.
+     */
+    WsprReverseIndex() noexcept = default;
+
+    /**
+     * @brief Creates an empty index sized for `expected` messages.
+     *
+     * @param expected Number of messages to make room for.
+     */
+    explicit WsprReverseIndex(std::size_t expected);
+
+    /**
+     * @brief Validates, packs, and indexes a Type 1 message.
+     *
+     * @param callsign The callsign (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The power level in dBm.
+     * @return WsprStatus::ok, or the validation failure.
+     */
+    WsprStatus insert(std::string_view callsign, std::string_view location, int power);
+
+    /**
+     * @brief Indexes an already packed payload of any message type.
+     *
+     * Inserting a payload that is already present has no effect.
+     *
+     * @param payload The payload to index.
+     */
+    void insert(const WsprPayload &payload);
+
+    /**
+     * @brief Indexes a block of payloads, encoding them with the batch encoder.
+     *
+     * @param payloads Array of `count` payloads.
+     * @param count Number of payloads.
+     * @param kernel Batch encoder kernel.
+     */
+    void insert(const WsprPayload *payloads, std::size_t count, WsprKernel kernel = WsprKernel::automatic);
+
+    /**
+     * @brief Makes room for `count` messages without further growth.
+     *
+     * @param count Total number of messages to make room for.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * @brief Returns the number of indexed messages.
+     *
+     * @return Message count.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Removes every message, keeping the table allocation.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Looks up a capture given as symbols.
+     *
+     * @param symbols Buffer of MSG_SIZE symbols, each 0-3; sync bits are ignored.
+     * @param payload Receives the payload on a hit.
+     * @return True if the data bits match an indexed message.
+     */
+    bool find(const uint8_t *symbols, WsprPayload &payload) const noexcept;
+
+    /**
+     * @brief Looks up a capture given as WsprPackedSymbols bytes.
+     *
+     * @param packed Buffer of WsprPackedSymbols::size bytes.
+     * @param payload Receives the payload on a hit.
+     * @return True if the data bits match an indexed message.
+     */
+    bool find_packed(const uint8_t *packed, WsprPayload &payload) const noexcept;
+
+    /**
+     * @brief Looks up a capture given as data bits with the sync stripped.
+     *
+     * @param bits Buffer of MSG_SIZE bits, each 0 or 1, in symbol order.
+     * @param payload Receives the payload on a hit.
+     * @return True if the data bits match an indexed message.
+     */
+    bool find_bits(const uint8_t *bits, WsprPayload &payload) const noexcept;
+
+    /**
+     * @brief Turns a Type 1 payload back into its callsign, locator, and power.
+     *
+     * @param payload The payload to unpack.
+     * @param fields Receives the fields on success.
+     * @return False if the payload is not a valid Type 1 message.
+     */
+    static bool unpack(const WsprPayload &payload, WsprFields &fields) noexcept;
+
+    /**
+     * @brief Writes the compact serialized form.
+     *
+     * Layout, little-endian: the signature "WSPRIDX1", the 4-byte
+     * version, the 4-byte payload size (WsprPayload::byte_size), the
+     * 8-byte count, then `count` payloads from WsprPayload::to_bytes()
+     * in ascending key order.
+     *
+     * @return header_size + 7 bytes per message.
+     */
+    std::vector<uint8_t> serialize() const;
+
+    /**
+     * @brief Replaces the contents with a serialized index.
+     *
+     * @param data Serialized bytes from serialize().
+     * @param size Number of bytes.
+     * @param kernel Batch encoder kernel used to rebuild the fingerprints.
+     * @return False, leaving the index unchanged, if the data is malformed.
+     */
+    bool deserialize(const uint8_t *data, std::size_t size, WsprKernel kernel = WsprKernel::automatic);
+
+    /**
+     * @brief Fingerprint of symbols, as used by find().
+     *
+     * @param symbols Buffer of MSG_SIZE symbols, each 0-3.
+     * @return 64-bit fingerprint of the data bits.
+     */
+    static uint64_t fingerprint(const uint8_t *symbols) noexcept;
+
+private:
+    /**
+     * @brief Data bits in symbol order, bit `i % 64` of word `i / 64`.
+     */
+    using DataWords = std::array<uint64_t, 3>;
+
+    /**
+     * @brief One table slot.
+     */
+    struct Slot
+    {
+        uint64_t fingerprint; ///< Fingerprint of the data bits.
+        uint64_t key;         ///< WsprPayload::key(), or empty.
+    };
+
+    /**
+     * @brief Key value of an unused slot; real keys use only 50 bits.
+     */
+    static constexpr uint64_t empty = ~static_cast<uint64_t>(0);
+
+    /**
+     * @brief Gathers the data bits of MSG_SIZE symbols.
+     *
+     * @param symbols Symbols, each 0-3, or bits with `shift` 0.
+     * @param shift 1 to take the high bit of each symbol, 0 for plain bits.
+     * @return The data words.
+     */
+    static DataWords gather(const uint8_t *symbols, unsigned shift) noexcept;
+
+    /**
+     * @brief Hashes data words into a fingerprint.
+     *
+     * @param words The data words.
+     * @return The fingerprint.
+     */
+    static uint64_t mix(const DataWords &words) noexcept;
+
+    /**
+     * @brief Files a fingerprint and key, growing the table if needed.
+     *
+     * @param fingerprint The fingerprint.
+     * @param key The payload key.
+     */
+    void place(uint64_t fingerprint, uint64_t key);
+
+    /**
+     * @brief Probes for a fingerprint.
+     *
+     * @param fingerprint The fingerprint.
+     * @param payload Receives the payload on a hit.
+     * @return True on a hit.
+     */
+    bool lookup(uint64_t fingerprint, WsprPayload &payload) const noexcept;
+
+    /**
+     * @brief Rebuilds the table with `capacity` slots.
+     *
+     * @param capacity New slot count, a power of two.
+     */
+    void rehash(std::size_t capacity);
+
+    std::vector<Slot> slots_; ///< Open-addressing table, a power of two in size.
+    std::size_t size_ = 0;    ///< Occupied slots.
+};
+
+#endif // WSPR_INDEX_H
@@ -24,23 +24,10 @@
  */
 
 #include "wspr_message.hpp"
-#include <iostream> // For: std::cout, std::endl
-#include <cctype>   // For: std::isdigit, std::isalpha
-#include <cstring>  // For: std::memcpy
+#include "wspr_stats.hpp"
+#include <stdexcept> // For: std::invalid_argument
 
-/**
- * @brief 162-bit synchronization vector.
- */
-const unsigned char sync[] = {
-    1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0,
-    1, 0, 0, 1, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0,
-    0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1,
-    0, 1, 0, 0, 0, 1, 1, 0, 1, 0, 0, 0, 0, 1, 1, 0, 1, 0,
-    1, 0, 1, 0, 1, 0, 0, 1, 0, 0, 1, 0, 1, 1, 0, 0, 0, 1,
-    1, 0, 1, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1,
-    0, 0, 1, 1, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 0, 1,
-    1, 1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 1, 0, 0, 0, 0,
-    0, 0, 0, 1, 1, 0, 1, 0, 1, 1, 0, 0, 0, 1, 1, 0, 0, 0};
+#if WSPR_EXCEPTIONS
 
 /**
  * @brief Constructs a WSPR message from a callsign, grid location, and power level.
@@ -52,267 +39,169 @@ const unsigned char sync[] = {
  * @note This constructor ensures that the callsign and location are converted to uppercase
  *       before encoding them into the WSPR symbol sequence.
  */
-WsprMessage::WsprMessage(const std::string &callsign, const std::string &location, int power)
+WsprMessage::WsprMessage(std::string_view callsign, std::string_view location, int power)
 {
-    // Validate input length to prevent out-of-range errors
-    if (callsign.empty() || location.length() != 4)
-    {
-        throw std::invalid_argument("Invalid callsign or location format.");
-    }
-
-    // Create modifiable copies for processing
-    std::string mod_callsign = callsign;
-    std::string mod_location = location;
-
-    // Convert callsign and location to uppercase to comply with WSPR encoding rules
-    to_upper(mod_callsign);
-    to_upper(mod_location);
-
-    // Generate the WSPR symbols based on the processed callsign, location, and power
-    generate_wspr_symbols(mod_callsign, mod_location, power);
+    WSPR_STAT_TIME(encode, 1);
+    const WsprPayload payload = encode_checked(callsign, location, power, symbols.data());
+    remember(payload.n, payload.m, power);
 }
 
-WsprMessage &WsprMessage::set_message_parameters(const std::string &callsign, const std::string &location, int power)
+/**
+ * @brief Re-encodes this message with a new callsign, grid location, and power level.
+ *
+ * @param callsign The callsign to encode.
+ * @param location The Maidenhead grid locator (4-character format, e.g., "EM18").
+ * @param power The transmission power level in dBm.
+ * @return A reference to this WsprMessage instance.
+ *
+ * @note Symbols are written in place; no memory is allocated or freed.
+ */
+WsprMessage &WsprMessage::set_message_parameters(std::string_view callsign, std::string_view location, int power)
 {
-    // Validate input length to prevent out-of-range errors
-    if (callsign.empty() || location.length() != 4)
-    {
-        throw std::invalid_argument("Invalid callsign or location format.");
-    }
-
-    // Free any previously allocated symbols if they exist
-    if (symbols != nullptr)
-    {
-        delete[] symbols;
-        symbols = nullptr;
-    }
-
-    // Create modifiable copies for processing
-    std::string mod_callsign = callsign;
-    std::string mod_location = location;
-
-    // Convert callsign and location to uppercase to comply with WSPR encoding rules
-    to_upper(mod_callsign);
-    to_upper(mod_location);
-
-    // Generate the WSPR symbols based on the processed callsign, location, and power
-    generate_wspr_symbols(mod_callsign, mod_location, power);
+    WSPR_STAT_TIME(reencode, 1);
+    const WsprPayload payload = encode_checked(callsign, location, power, symbols.data());
+    remember(payload.n, payload.m, power);
 
     return *this;
 }
 
 /**
- * @brief Converts a given string to uppercase.
+ * @brief Encodes a WSPR message into a caller-supplied buffer.
  *
- * @param str The string to be modified in-place.
+ * @param callsign The callsign to encode.
+ * @param location The Maidenhead grid locator (4-character format, e.g., "EM18").
+ * @param power The transmission power level in dBm.
+ * @param out Destination buffer of at least MSG_SIZE bytes.
  *
- * @note This function modifies the input string directly.
- *       It uses `std::transform` with `::toupper` for efficiency.
- *       Only ASCII characters are guaranteed to be correctly transformed.
+ * @throws std::invalid_argument If the callsign is empty or compound, or the
+ *         location is not 4 characters. Compound callsigns need a Type 2
+ *         message; see pack_type2().
  */
-void WsprMessage::to_upper(std::string &str)
+void WsprMessage::encode(std::string_view callsign, std::string_view location, int power, uint8_t *out)
 {
-    if (str.empty())
-    {
-        return; // No processing needed for an empty string
-    }
-
-    std::transform(str.begin(), str.end(), str.begin(),
-                   [](unsigned char c)
-                   { return std::toupper(c); });
+    WSPR_STAT_TIME(encode, 1);
+    encode_checked(callsign, location, power, out);
 }
 
 /**
- * @brief Generates WSPR symbols based on callsign, grid location, and power.
- *
- * @param callsign The amateur radio callsign (up to 6 characters, uppercase).
- * @param location The Maidenhead grid locator (4 characters, uppercase).
- * @param power The transmission power level in dBm (0-60 dBm typical range).
+ * @brief Validates, normalizes, and encodes a message for the throwing API.
  *
- * @note This function encodes the callsign, grid locator, and power level
- *       into a 162-bit WSPR message and stores the resulting symbols in
- *       the `symbols` array.
+ * @param callsign The callsign to encode.
+ * @param location The Maidenhead grid locator (4-character format, e.g., "EM18").
+ * @param power The transmission power level in dBm.
+ * @param out Destination buffer of at least MSG_SIZE bytes.
+ * @return The packed payload that was encoded.
  *
- * @throws std::runtime_error If memory allocation for symbols fails.
+ * @throws std::invalid_argument As for encode().
  */
-void WsprMessage::generate_wspr_symbols(const std::string &callsign, const std::string &location, int power)
+WsprPayload WsprMessage::encode_checked(std::string_view callsign, std::string_view location, int power, uint8_t *out)
 {
-    // Allocate memory for symbols and check for allocation failure
-    symbols = new (std::nothrow) unsigned char[MSG_SIZE];
-    if (!symbols)
-    {
-        throw std::runtime_error("Memory allocation failed for WSPR symbols.");
-    }
-
-    // Callsign processing - ensure correct structure
-    char call[6] = {' ', ' ', ' ', ' ', ' ', ' '}; // Default to padded spaces
-
-    if (callsign.length() >= 2 && std::isdigit(callsign[1]))
+    // Validate input length to prevent out-of-range errors
+    if (callsign.empty() || location.length() != 4)
     {
-        // Numeric second character: shift callsign one position right
-        std::copy_n(callsign.begin(), std::min(callsign.length(), size_t(5)), call + 1);
+        throw std::invalid_argument("Invalid callsign or location format.");
     }
-    else if (callsign.length() >= 3 && std::isdigit(callsign[2]))
+    if (is_compound_callsign(callsign))
     {
-        // Numeric third character: copy callsign as is
-        std::copy_n(callsign.begin(), std::min(callsign.length(), size_t(6)), call);
+        throw std::invalid_argument("Compound callsigns require a Type 2 message.");
     }
 
-    // Encode callsign into integer N
-    uint32_t N = get_character_value(call[0]) * 36 + get_character_value(call[1]);
-    N = N * 10 + get_character_value(call[2]);
-    N = N * 27 + get_character_value(call[3]) - 10;
-    N = N * 27 + get_character_value(call[4]) - 10;
-    N = N * 27 + get_character_value(call[5]) - 10;
-
-    // Encode location and power into integer M
-    uint32_t M1 = (179 - 10 * (location[0] - 'A') - (location[2] - '0')) * 180 +
-                  (10 * (location[1] - 'A')) + (location[3] - '0');
-    uint32_t M = M1 * 128 + power + 64;
-
-    // Initialize symbols array with sync vector
-    std::copy(std::begin(sync), std::end(sync), symbols);
-
-    int i;
-    uint32_t reg = 0;
-    unsigned char reverseAddressIndex = 0;
-
-    // Encode N into symbols using convolutional encoding
-    for (i = 27; i >= 0; i--)
+    // Fold case into stack buffers in one pass; packing reads at most six callsign characters
+    const std::size_t length = callsign.length() < 6 ? callsign.length() : 6;
+    char call[6] = {};
+    for (std::size_t i = 0; i < length; ++i)
     {
-        reg <<= 1;
-        if (N & ((uint32_t)1 << i))
-            reg |= 1;
-        symbols[reverse_address(reverseAddressIndex)] += 2 * calculate_parity(reg & 0xf2d05351L);
-        symbols[reverse_address(reverseAddressIndex)] += 2 * calculate_parity(reg & 0xe4613c47L);
+        call[i] = upper_char(callsign[i]);
     }
-
-    // Encode M into symbols
-    for (i = 21; i >= 0; i--)
+    char grid[4] = {};
+    for (std::size_t i = 0; i < 4; ++i)
     {
-        reg <<= 1;
-        if (M & ((uint32_t)1 << i))
-            reg |= 1;
-        symbols[reverse_address(reverseAddressIndex)] += 2 * calculate_parity(reg & 0xf2d05351L);
-        symbols[reverse_address(reverseAddressIndex)] += 2 * calculate_parity(reg & 0xe4613c47L);
+        grid[i] = upper_char(location[i]);
     }
 
-    // Final encoding loop for synchronization
-    for (i = 30; i >= 0; i--)
-    {
-        reg <<= 1;
-        symbols[reverse_address(reverseAddressIndex)] += 2 * calculate_parity(reg & 0xf2d05351L);
-        symbols[reverse_address(reverseAddressIndex)] += 2 * calculate_parity(reg & 0xe4613c47L);
-    }
+    // Generate the WSPR symbols based on the processed callsign, location, and power
+    WsprPayload payload;
+    pack_fields(std::string_view(call, length), std::string_view(grid, 4), power, payload.n, payload.m);
+    encode_packed(payload.n, payload.m, out);
+    return payload;
 }
 
 /**
- * @brief Converts a character to its corresponding numeric value for WSPR encoding.
+ * @brief Encodes a WSPR message directly into an externally owned buffer.
  *
- * @param ch The character to convert (digit, letter, or space).
- * @return The numeric value of the character:
- *         - Digits ('0'-'9') return their integer value (0-9).
- *         - Uppercase letters ('A'-'Z') return 10-35.
- *         - A space (' ') returns 36.
- *         - All other characters return 0 (invalid input).
+ * @param callsign The callsign to encode.
+ * @param location The Maidenhead grid locator (4-character format, e.g., "EM18").
+ * @param power The transmission power level in dBm.
+ * @param out Destination view of at least MSG_SIZE bytes.
  *
- * @note This function assumes the input character is either a valid alphanumeric
- *       character or a space. Any other input returns 0 as a fallback.
+ * @throws std::invalid_argument If the view is too small or the message is invalid.
  */
-int WsprMessage::get_character_value(char ch)
+void WsprMessage::encode(std::string_view callsign, std::string_view location, int power, WsprSpan<uint8_t> out)
 {
-    if (std::isdigit(static_cast<unsigned char>(ch)))
+    if (out.size() < MSG_SIZE)
     {
-        return ch - '0';
+        throw std::invalid_argument("Destination buffer is smaller than a WSPR message.");
     }
-    if (std::isalpha(static_cast<unsigned char>(ch)))
-    {
-        return 10 + std::toupper(static_cast<unsigned char>(ch)) - 'A';
-    }
-    if (ch == ' ')
-    {
-        return 36;
-    }
-
-    return 0; // Return 0 for invalid characters
+    encode(callsign, location, power, out.data());
 }
 
+#endif // WSPR_EXCEPTIONS
+
+#if WSPR_TIMED_CONSTEXPR
+
 /**
- * @brief Reverses the bit order of the address index and ensures it stays within bounds.
- *
- * @param reverseAddressIndex Reference to the current address index, which is incremented.
- * @return The reversed bit address, ensuring it is within the valid WSPR symbol range (0-161).
+ * @brief Times a run-time try_encode() call into WsprStats::encode.
  *
- * @note This function modifies `reverseAddressIndex` in-place by incrementing it.
- *       If the reversed address is out of range (>161), the function retries until a valid address is found.
+ * @param callsign The callsign to encode (either case).
+ * @param location The 4-character Maidenhead locator (either case).
+ * @param power The transmission power level in dBm.
+ * @param out Destination buffer of at least MSG_SIZE bytes.
+ * @return As for try_encode().
  */
-unsigned char WsprMessage::reverse_address(unsigned char &reverseAddressIndex)
+WsprStatus WsprMessage::try_encode_timed(std::string_view callsign, std::string_view location, int power, uint8_t *out) noexcept
 {
-    unsigned char result = reverse_bits(reverseAddressIndex++);
-
-    // Ensure result is within valid range (0-161)
-    while (result > 161)
-    {
-        result = reverse_bits(reverseAddressIndex++);
-    }
-
-    return result;
+    WSPR_STAT_TIME(encode, 1);
+    return try_encode_untimed(callsign, location, power, out);
 }
 
 /**
- * @brief Reverses the bit order of an 8-bit unsigned integer.
+ * @brief Times a run-time try_set() call into WsprStats::reencode.
  *
- * @param b The byte (8-bit unsigned char) to reverse.
- * @return The byte with its bits reversed.
- *
- * @note This function performs an in-place bit reversal using bitwise operations.
- *       The algorithm swaps bits in groups of 4, then 2, then 1 to efficiently reverse the byte.
+ * @param callsign The callsign to encode (either case).
+ * @param location The 4-character Maidenhead locator (either case).
+ * @param power The transmission power level in dBm.
+ * @return As for try_set().
  */
-unsigned char WsprMessage::reverse_bits(unsigned char b)
+WsprStatus WsprMessage::try_set_timed(std::string_view callsign, std::string_view location, int power) noexcept
 {
-    // Swap nibbles (4-bit groups)
-    b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
-
-    // Swap pairs of bits
-    b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
-
-    // Swap individual bits
-    b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
-
-    return b;
+    WSPR_STAT_TIME(reencode, 1);
+    return try_set_untimed(callsign, location, power);
 }
 
 /**
- * @brief Computes the parity of a 32-bit integer.
+ * @brief Times a run-time set_power() call into WsprStats::reencode.
  *
- * @param x The 32-bit unsigned integer whose parity is to be calculated.
- * @return 1 if the number of set bits (1s) in `x` is odd, 0 if even.
- *
- * @note This function uses Kernighan’s algorithm to count set bits efficiently.
- *       Each iteration removes the least significant set bit, ensuring O(k) complexity,
- *       where k is the number of bits set in `x`.
+ * @param power The new transmission power level in dBm.
+ * @return As for set_power().
  */
-int WsprMessage::calculate_parity(uint32_t ch)
+WsprStatus WsprMessage::set_power_timed(int power) noexcept
 {
-    int even = 0; // Tracks parity (0 = even, 1 = odd)
-
-    // Iterate through all set bits using Kernighan’s algorithm
-    while (ch)
-    {
-        even = 1 - even;    // Toggle parity
-        ch = ch & (ch - 1); // Remove the lowest set bit
-    }
-
-    return even; // Returns 1 for odd parity, 0 for even parity
+    WSPR_STAT_TIME(reencode, 1);
+    return set_power_untimed(power);
 }
 
 /**
- * @brief Destructor for the WsprMessage class.
+ * @brief Times a run-time reencode_power() call into WsprStats::reencode.
  *
- * @note This destructor ensures proper cleanup of dynamically allocated memory for `symbols`.
- *       If `symbols` is already `nullptr`, the delete operation has no effect.
+ * @param payload The Type 1 payload that `out` encodes.
+ * @param power The new transmission power level in dBm.
+ * @param out Symbol buffer of at least MSG_SIZE bytes.
+ * @return As for reencode_power().
  */
-WsprMessage::~WsprMessage()
+WsprStatus WsprMessage::reencode_power_timed(WsprPayload &payload, int power, uint8_t *out) noexcept
 {
-    delete[] symbols; // Deallocates the dynamically allocated symbols array
+    WSPR_STAT_TIME(reencode, 1);
+    return reencode_power_untimed(payload, power, out);
 }
+
+#endif // WSPR_TIMED_CONSTEXPR
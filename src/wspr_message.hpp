@@ -26,38 +26,228 @@
 #ifndef WSPR_MESSAGE_H
 #define WSPR_MESSAGE_H
 
-#include <cstdint>   // For: uint32_t
-#include <string>    // For: std::string
-#include <algorithm> // For std::transform
+#include <array>       // For: std::array
+#include <cstdint>     // For: uint8_t, uint32_t
+#include <string>      // For: std::string
+#include <string_view> // For: std::string_view
+#include <stdexcept>   // For: std::invalid_argument
+#include <cstddef>     // For: std::size_t
+#include <functional>  // For: std::hash
+#include <cstdlib>     // For: std::abort
+
+#include "wspr_span.hpp" // For: WsprSpan, WsprSymbolBlock
+
+/**
+ * @brief Nonzero when the throwing API is compiled in.
+ *
+ * Follows the compiler's exception setting, so building with
+ * `-fno-exceptions` leaves only the noexcept, status-returning API. Define
+ * it to 0 to drop the throwing API explicitly.
+ */
+#ifndef WSPR_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define WSPR_EXCEPTIONS 1
+#else
+#define WSPR_EXCEPTIONS 0
+#endif
+#endif
+
+/**
+ * @brief Nonzero when the constexpr encoders report run-time calls to WsprStats.
+ *
+ * try_encode(), try_set(), set_power() and reencode_power() stay usable in
+ * constant expressions, so they reach the timers in wspr_message.cpp only
+ * when the compiler can tell a run-time call from constant evaluation.
+ * Instrumented builds on compilers without `__builtin_is_constant_evaluated`
+ * leave these four untimed.
+ */
+#ifndef WSPR_TIMED_CONSTEXPR
+#if defined(WSPR_INSTRUMENT) && defined(__has_builtin)
+#if WSPR_INSTRUMENT && __has_builtin(__builtin_is_constant_evaluated)
+#define WSPR_TIMED_CONSTEXPR 1
+#endif
+#endif
+#ifndef WSPR_TIMED_CONSTEXPR
+#define WSPR_TIMED_CONSTEXPR 0
+#endif
+#endif
 
 /**
  * @brief Defines the size of the WSPR message in bits.
  */
 #define MSG_SIZE 162
 
+/**
+ * @brief Result of validating or encoding a WSPR message without exceptions.
+ */
+enum class WsprStatus : uint8_t
+{
+    ok = 0,           ///< Message is valid / was encoded.
+    invalid_callsign, ///< Callsign is empty, too long, or not a Type 1 structure.
+    invalid_locator,  ///< Locator is not a 4-character Maidenhead square.
+    invalid_power,    ///< Power is outside 0-60 dBm or does not end in 0, 3, or 7.
+    invalid_frequency, ///< Frequency cannot be produced by the transmitter's tuning model.
+};
+
+/**
+ * @brief The three WSPR message formats.
+ *
+ * Type 1 carries a standard callsign, 4-character locator, and power.
+ * Stations with a compound callsign or a 6-character locator need two
+ * transmissions: a Type 1 or Type 2 message followed by a Type 3 message
+ * that pairs a 15-bit callsign hash with the full locator.
+ */
+enum class WsprMessageType : uint8_t
+{
+    type1 = 1, ///< Standard callsign, 4-character locator, power.
+    type2 = 2, ///< Compound callsign (prefix or suffix) and power, no locator.
+    type3 = 3, ///< Hashed callsign, 6-character locator, power.
+};
+
+/**
+ * @brief The 50-bit source payload of a WSPR message.
+ *
+ * This is the packed form produced before convolutional encoding. It holds
+ * the 28-bit callsign integer N and the 22-bit locator/power integer M, and
+ * identifies a message exactly. It is far cheaper to compare, hash, or store
+ * than either the input strings or the 162 encoded symbols.
+ */
+struct WsprPayload
+{
+    /**
+     * @brief Number of bytes in the serialized form (50 bits, zero padded).
+     */
+    static constexpr std::size_t byte_size = 7;
+
+    uint32_t n = 0; ///< Packed 28-bit callsign integer.
+    uint32_t m = 0; ///< Packed 22-bit locator and power integer.
+
+    /**
+     * @brief Combines both integers into a single 50-bit key.
+     *
+     * @return `(n << 22) | m`.
+     */
+    constexpr uint64_t key() const noexcept
+    {
+        return (static_cast<uint64_t>(n) << 22) | m;
+    }
+
+    /**
+     * @brief Rebuilds a payload from a key produced by key().
+     *
+     * @param key The 50-bit key.
+     * @return The payload.
+     */
+    static constexpr WsprPayload from_key(uint64_t key) noexcept
+    {
+        WsprPayload payload;
+        payload.n = static_cast<uint32_t>(key >> 22) & 0x0FFFFFFF;
+        payload.m = static_cast<uint32_t>(key) & 0x3FFFFF;
+        return payload;
+    }
+
+    /**
+     * @brief Serializes the payload as 7 big-endian bytes.
+     *
+     * The 50 bits are stored most significant first, in the same order the
+     * encoder consumes them, followed by 6 zero bits.
+     *
+     * @param out Destination buffer of at least byte_size bytes.
+     */
+    constexpr void to_bytes(uint8_t *out) const noexcept
+    {
+        const uint64_t bits = key() << (8 * byte_size - 50);
+        for (std::size_t i = 0; i < byte_size; ++i)
+        {
+            out[i] = static_cast<uint8_t>(bits >> (8 * (byte_size - 1 - i)));
+        }
+    }
+
+    /**
+     * @brief Deserializes a payload written by to_bytes().
+     *
+     * @param in Source buffer of at least byte_size bytes.
+     * @return The payload.
+     */
+    static constexpr WsprPayload from_bytes(const uint8_t *in) noexcept
+    {
+        uint64_t bits = 0;
+        for (std::size_t i = 0; i < byte_size; ++i)
+        {
+            bits = (bits << 8) | in[i];
+        }
+        return from_key(bits >> (8 * byte_size - 50));
+    }
+
+    constexpr bool operator==(const WsprPayload &other) const noexcept
+    {
+        return n == other.n && m == other.m;
+    }
+
+    constexpr bool operator!=(const WsprPayload &other) const noexcept
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief Hashes a payload by its 50-bit key, for use in unordered containers.
+ */
+namespace std
+{
+    template <>
+    struct hash<WsprPayload>
+    {
+        std::size_t operator()(const WsprPayload &payload) const noexcept
+        {
+            return std::hash<uint64_t>{}(payload.key());
+        }
+    };
+}
+
 /**
  * @class WsprMessage
  * @brief Handles generation and encoding of WSPR messages.
+ *
+ * Symbols are held inline in a fixed-size array, so a WsprMessage never
+ * touches the heap and may be freely copied, moved, and stored in
+ * preallocated containers.
+ *
+ * The encoder itself is `constexpr` and lives entirely in this header.
+ * make_symbols() can therefore produce a fixed beacon message at compile
+ * time, leaving only the resulting 162-byte table in the image.
  */
 class WsprMessage
 {
 public:
+    /**
+     * @brief Fixed-size storage for one encoded WSPR message.
+     */
+    using Symbols = std::array<uint8_t, MSG_SIZE>;
+
+    /**
+     * @brief Permutation table type used by the interleaver.
+     */
+    using InterleaveTable = std::array<uint8_t, MSG_SIZE>;
+
     /**
      * @brief Default constructor for WsprMessage.
      *
-     * Initializes the WsprMessage object by setting the symbols pointer to nullptr,
-     * ensuring that no memory is allocated until message parameters are set.
+     * Initializes the WsprMessage object with all symbols zeroed until
+     * message parameters are set.
      */
-    inline WsprMessage() : symbols(nullptr) {}
+    inline WsprMessage() : symbols{}, base_{} {}
 
+#if WSPR_EXCEPTIONS
     /**
      * @brief Constructor for WsprMessage.
      *
      * @param callsign The callsign to encode.
      * @param location The Maidenhead grid location to encode.
      * @param power The power level in dBm.
+     * @throws std::invalid_argument If the callsign or location format is invalid.
      */
-    WsprMessage(const std::string &callsign, const std::string &location, int power);
+    WsprMessage(std::string_view callsign, std::string_view location, int power);
 
     /**
      * @brief Sets the message parameters (callsign, location, power) after construction.
@@ -70,48 +260,841 @@ public:
      * @param power The transmission power level in dBm.
      * @return A reference to this WsprMessage instance.
      */
-    WsprMessage &set_message_parameters(const std::string &callsign, const std::string &location, int power);
+    WsprMessage &set_message_parameters(std::string_view callsign, std::string_view location, int power);
+
+    /**
+     * @brief Encodes a message into a caller-supplied symbol buffer.
+     *
+     * Performs the same validation and normalization as
+     * set_message_parameters() without requiring a WsprMessage instance.
+     *
+     * @param callsign The callsign to encode.
+     * @param location The Maidenhead grid locator (4-character format, e.g., "EM18").
+     * @param power The transmission power level in dBm.
+     * @param out Destination buffer of at least MSG_SIZE bytes.
+     * @throws std::invalid_argument If the callsign or location format is invalid.
+     */
+    static void encode(std::string_view callsign, std::string_view location, int power, uint8_t *out);
+
+    /**
+     * @brief Encodes a message directly into an externally owned buffer.
+     *
+     * @param callsign The callsign to encode.
+     * @param location The Maidenhead grid locator (4-character format, e.g., "EM18").
+     * @param power The transmission power level in dBm.
+     * @param out Destination view; only the first MSG_SIZE bytes are written.
+     * @throws std::invalid_argument If the view is shorter than MSG_SIZE or
+     *         the callsign or location format is invalid.
+     */
+    static void encode(std::string_view callsign, std::string_view location, int power, WsprSpan<uint8_t> out);
+#endif // WSPR_EXCEPTIONS
+
+    /**
+     * @brief Returns a read-only view of the symbols.
+     *
+     * @return View of the MSG_SIZE symbols.
+     */
+    constexpr WsprSpan<const uint8_t> view() const noexcept
+    {
+        return WsprSpan<const uint8_t>(symbols.data(), symbols.size());
+    }
+
+    /**
+     * @brief Returns a mutable view of the symbols.
+     *
+     * @return View of the MSG_SIZE symbols.
+     */
+    constexpr WsprSpan<uint8_t> span() noexcept
+    {
+        return WsprSpan<uint8_t>(symbols.data(), symbols.size());
+    }
+
+    constexpr Symbols::iterator begin() noexcept { return symbols.begin(); }                   ///< First symbol.
+    constexpr Symbols::iterator end() noexcept { return symbols.end(); }                       ///< Past the last symbol.
+    constexpr Symbols::const_iterator begin() const noexcept { return symbols.begin(); }       ///< First symbol.
+    constexpr Symbols::const_iterator end() const noexcept { return symbols.end(); }           ///< Past the last symbol.
+    constexpr Symbols::const_iterator cbegin() const noexcept { return symbols.cbegin(); }     ///< First symbol.
+    constexpr Symbols::const_iterator cend() const noexcept { return symbols.cend(); }         ///< Past the last symbol.
+
+    /**
+     * @brief Encodes a Type 1 message, intended for compile-time use.
+     *
+     * Unlike encode(), the callsign, locator, and power are fully validated:
+     * the callsign must be a standard Type 1 callsign (area digit in the
+     * second or third position, at most three trailing letters), the locator
+     * must be a 4-character Maidenhead square, and the power must be a WSPR
+     * level (0-60 dBm ending in 0, 3, or 7). Lowercase input is accepted.
+     *
+     * When used to initialize a `constexpr` variable, invalid input is a
+     * compile error:
+     * @code
+     * constexpr WsprMessage::Symbols beacon = WsprMessage::make_symbols("AA0NT", "EM18", 20);
+     * @endcode
+     *
+     * @param callsign The callsign to encode.
+     * @param location The Maidenhead grid locator (4-character format, e.g., "EM18").
+     * @param power The transmission power level in dBm.
+     * @return The encoded symbols.
+     * @throws std::invalid_argument If any field is invalid (at run time).
+     *         Without exception support the program aborts instead; use
+     *         try_encode() for run-time input.
+     */
+    static constexpr Symbols make_symbols(std::string_view callsign, std::string_view location, int power)
+    {
+        uint32_t N = 0;
+        uint32_t M = 0;
+        switch (pack_checked(callsign, location, power, N, M))
+        {
+        case WsprStatus::ok:
+            break;
+#if WSPR_EXCEPTIONS
+        case WsprStatus::invalid_callsign:
+            throw std::invalid_argument("Invalid callsign format.");
+        case WsprStatus::invalid_locator:
+            throw std::invalid_argument("Invalid location format.");
+        case WsprStatus::invalid_power:
+            throw std::invalid_argument("Invalid power level.");
+        case WsprStatus::invalid_frequency:
+            throw std::invalid_argument("Invalid frequency."); // Not produced by packing
+#else
+        default:
+            std::abort(); // Not a constant expression, so still a compile error
+#endif
+        }
+
+        Symbols out{};
+        encode_packed(N, M, out.data());
+        return out;
+    }
+
+    /**
+     * @brief Validates and encodes a message without throwing.
+     *
+     * Applies the same rules as make_symbols(). Validation happens while
+     * the fields are packed, in a single pass over each string, and
+     * nothing is allocated.
+     *
+     * @param callsign The callsign to encode (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The transmission power level in dBm.
+     * @param out Destination buffer of at least MSG_SIZE bytes; untouched on failure.
+     * @return WsprStatus::ok, or the first field found to be invalid.
+     */
+    static constexpr WsprStatus try_encode(std::string_view callsign, std::string_view location, int power, uint8_t *out) noexcept
+    {
+#if WSPR_TIMED_CONSTEXPR
+        if (!__builtin_is_constant_evaluated())
+        {
+            return try_encode_timed(callsign, location, power, out);
+        }
+#endif
+        return try_encode_untimed(callsign, location, power, out);
+    }
+
+    /**
+     * @brief Re-encodes this message without throwing.
+     *
+     * The noexcept counterpart of set_message_parameters(), with the
+     * validation rules of try_encode().
+     *
+     * @param callsign The callsign to encode (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The transmission power level in dBm.
+     * @return WsprStatus::ok, or the first field found to be invalid. On
+     *         failure the current symbols are kept.
+     */
+    constexpr WsprStatus try_set(std::string_view callsign, std::string_view location, int power) noexcept
+    {
+#if WSPR_TIMED_CONSTEXPR
+        if (!__builtin_is_constant_evaluated())
+        {
+            return try_set_timed(callsign, location, power);
+        }
+#endif
+        return try_set_untimed(callsign, location, power);
+    }
+
+    /**
+     * @brief Changes only the power level of the current message.
+     *
+     * The callsign occupies the first 28 encoder input bits, so the encoder
+     * register (and the symbols for output bits 0-55) are the same for every
+     * power. Only the 106 symbols that follow are rewritten, from the cached
+     * callsign state, which is about two thirds of the work of try_set() and
+     * skips all string handling.
+     *
+     * Valid after the constructor, set_message_parameters(), try_set(), or
+     * adopt(); edits made directly to `symbols` are not tracked.
+     *
+     * @param power The new transmission power level in dBm.
+     * @return WsprStatus::ok; WsprStatus::invalid_power if the power is not
+     *         a WSPR level; WsprStatus::invalid_callsign if no message has
+     *         been set yet. On failure the current symbols are kept.
+     */
+    constexpr WsprStatus set_power(int power) noexcept
+    {
+#if WSPR_TIMED_CONSTEXPR
+        if (!__builtin_is_constant_evaluated())
+        {
+            return set_power_timed(power);
+        }
+#endif
+        return set_power_untimed(power);
+    }
+
+    /**
+     * @brief Records the payload behind symbols written into `symbols` from elsewhere.
+     *
+     * For code that fills `symbols` without encoding them here, such as a
+     * cache copying out a stored message, so that set_power() afterwards
+     * re-encodes from the right callsign state.
+     *
+     * @param payload The Type 1 payload from pack() that `symbols` now holds.
+     * @return WsprStatus::ok; WsprStatus::invalid_power if the payload does
+     *         not carry a WSPR power level, in which case set_power() is
+     *         disabled until the next encode.
+     */
+    constexpr WsprStatus adopt(const WsprPayload &payload) noexcept
+    {
+        // Bits 0-6 of a Type 1 M hold power + 64
+        const int power = static_cast<int>(payload.m & 0x7F) - 64;
+        if (!is_valid_power(power))
+        {
+            base_ = WsprPayload{};
+            return WsprStatus::invalid_power;
+        }
+        remember(payload.n, payload.m, power);
+        return WsprStatus::ok;
+    }
+
+    /**
+     * @brief Changes only the power level of a Type 1 message in an external buffer.
+     *
+     * The buffer-level counterpart of set_power(), for symbols held outside
+     * a WsprMessage (pools, DMA buffers, schedules). `payload` must be a
+     * Type 1 payload from pack() and `out` must currently hold its
+     * symbols; both are updated together.
+     *
+     * @param payload The Type 1 payload that `out` encodes; its power is replaced.
+     * @param power The new transmission power level in dBm.
+     * @param out Symbol buffer of at least MSG_SIZE bytes.
+     * @return WsprStatus::ok, or WsprStatus::invalid_power with nothing changed.
+     */
+    static constexpr WsprStatus reencode_power(WsprPayload &payload, int power, uint8_t *out) noexcept
+    {
+#if WSPR_TIMED_CONSTEXPR
+        if (!__builtin_is_constant_evaluated())
+        {
+            return reencode_power_timed(payload, power, out);
+        }
+#endif
+        return reencode_power_untimed(payload, power, out);
+    }
+
+    /**
+     * @brief Validates Type 1 message fields without throwing.
+     *
+     * Applies the same rules as make_symbols(). Lowercase input is accepted.
+     *
+     * @param callsign The callsign to check.
+     * @param location The Maidenhead grid locator to check.
+     * @param power The transmission power level in dBm.
+     * @return WsprStatus::ok, or the first field found to be invalid.
+     */
+    static constexpr WsprStatus validate(std::string_view callsign, std::string_view location, int power) noexcept
+    {
+        uint32_t N = 0;
+        uint32_t M = 0;
+        return pack_checked(callsign, location, power, N, M);
+    }
+
+    /**
+     * @brief Validates and packs a message into its 50-bit source payload.
+     *
+     * This is the first half of encoding; encode_payload() is the second.
+     * Applies the same rules as validate(). Nothing is allocated.
+     *
+     * @param callsign The callsign to pack (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The transmission power level in dBm.
+     * @param payload Receives the packed payload on success; untouched otherwise.
+     * @return WsprStatus::ok, or the first field found to be invalid.
+     */
+    static constexpr WsprStatus pack(std::string_view callsign, std::string_view location, int power, WsprPayload &payload) noexcept
+    {
+        uint32_t N = 0;
+        uint32_t M = 0;
+        WsprStatus result = pack_checked(callsign, location, power, N, M);
+        if (result == WsprStatus::ok)
+        {
+            payload.n = N;
+            payload.m = M;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Convolutionally encodes and interleaves a packed payload.
+     *
+     * @param payload A payload produced by pack() (or rebuilt from its key/bytes).
+     * @param out Destination buffer of at least MSG_SIZE bytes.
+     */
+    static constexpr void encode_payload(const WsprPayload &payload, uint8_t *out) noexcept
+    {
+        encode_packed(payload.n, payload.m, out);
+    }
+
+    /**
+     * @brief Reports whether a callsign carries an add-on prefix or suffix.
+     *
+     * @param callsign The callsign to check.
+     * @return True if the callsign contains a '/'.
+     */
+    static constexpr bool is_compound_callsign(std::string_view callsign) noexcept
+    {
+        return callsign.find('/') != std::string_view::npos;
+    }
+
+    /**
+     * @brief Computes the 15-bit callsign hash carried by Type 3 messages.
+     *
+     * This is Bob Jenkins' lookup3 `hashlittle()` with seed 146 over the
+     * uppercased callsign, as used by WSJT-X, masked to 15 bits.
+     *
+     * @param callsign The full callsign, including any prefix or suffix (either case).
+     * @return The 15-bit hash.
+     */
+    static constexpr uint16_t callsign_hash(std::string_view callsign) noexcept
+    {
+        char upper[16] = {};
+        std::size_t length = callsign.length() < sizeof(upper) ? callsign.length() : sizeof(upper);
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            upper[i] = upper_char(callsign[i]);
+        }
+        return static_cast<uint16_t>(nhash(std::string_view(upper, length), 146) & 0x7FFF);
+    }
+
+    /**
+     * @brief Validates and packs a Type 2 (compound callsign) payload.
+     *
+     * Accepts an add-on prefix of 1-3 letters or digits ("PJ4/K1ABC"), a
+     * single-character suffix ("K1ABC/P"), or a two-digit suffix from 10 to
+     * 99 ("K1ABC/12"). The base callsign must be a valid Type 1 callsign.
+     *
+     * @param callsign The compound callsign (either case).
+     * @param power The transmission power level in dBm.
+     * @param payload Receives the packed payload on success; untouched otherwise.
+     * @return WsprStatus::ok, or the first field found to be invalid.
+     */
+    static constexpr WsprStatus pack_type2(std::string_view callsign, int power, WsprPayload &payload) noexcept
+    {
+        std::string_view base;
+        uint32_t prefix = 0;
+        if (!split_compound(callsign, base, prefix))
+        {
+            return WsprStatus::invalid_callsign;
+        }
+        if (!is_valid_power(power))
+        {
+            return WsprStatus::invalid_power;
+        }
+
+        // The 16-bit prefix value spills its top bit into the power field
+        const uint32_t nadd = 1 + (prefix >> 15);
+        payload.n = pack_callsign(base);
+        payload.m = (prefix & 0x7FFF) * 128 + static_cast<uint32_t>(power) + nadd + 64;
+        return WsprStatus::ok;
+    }
+
+    /**
+     * @brief Validates and packs a Type 3 (hashed callsign, 6-character locator) payload.
+     *
+     * @param callsign The full standard or compound callsign to hash (either case).
+     * @param location The 6-character Maidenhead locator, e.g. "FN42AX" (either case).
+     * @param power The transmission power level in dBm.
+     * @param payload Receives the packed payload on success; untouched otherwise.
+     * @return WsprStatus::ok, or the first field found to be invalid.
+     */
+    static constexpr WsprStatus pack_type3(std::string_view callsign, std::string_view location, int power, WsprPayload &payload) noexcept
+    {
+        std::string_view base;
+        uint32_t prefix = 0;
+        if (is_compound_callsign(callsign) ? !split_compound(callsign, base, prefix) : !is_valid_callsign(callsign))
+        {
+            return WsprStatus::invalid_callsign;
+        }
+        return pack_type3(callsign_hash(callsign), location, power, payload);
+    }
 
     /**
-     * @brief Destructor for WsprMessage.
-     * Frees allocated memory for symbols.
+     * @brief Packs a Type 3 payload from a precomputed callsign hash.
+     *
+     * @param hash The 15-bit callsign hash from callsign_hash().
+     * @param location The 6-character Maidenhead locator (either case).
+     * @param power The transmission power level in dBm.
+     * @param payload Receives the packed payload on success; untouched otherwise.
+     * @return WsprStatus::ok, or the first field found to be invalid.
      */
-    ~WsprMessage();
+    static constexpr WsprStatus pack_type3(uint16_t hash, std::string_view location, int power, WsprPayload &payload) noexcept
+    {
+        if (!is_valid_locator6(location))
+        {
+            return WsprStatus::invalid_locator;
+        }
+        if (!is_valid_power(power))
+        {
+            return WsprStatus::invalid_power;
+        }
+
+        // The locator is rotated one place left and packed like a callsign
+        const char call[6] = {upper_char(location[1]), location[2], location[3],
+                              upper_char(location[4]), upper_char(location[5]), upper_char(location[0])};
+        payload.n = pack_call(call);
+        payload.m = static_cast<uint32_t>(hash & 0x7FFF) * 128 + 64 - static_cast<uint32_t>(power + 1);
+        return WsprStatus::ok;
+    }
 
     /**
-     * @brief Pointer to the generated symbols.
+     * @brief The generated symbols, stored inline.
      */
-    unsigned char *symbols;
+    Symbols symbols;
 
     /**
      * @brief Size of the WSPR message in bits.
      */
     static constexpr int size = MSG_SIZE;
 
+    /**
+     * @brief Interleaver permutation.
+     *
+     * `interleave_table[i]` is the symbol position receiving the i-th
+     * convolutional encoder output bit.
+     */
+    static const InterleaveTable interleave_table;
+
+    /**
+     * @brief Inverse interleaver permutation.
+     *
+     * `deinterleave_table[p]` is the encoder output bit index carried by
+     * symbol position `p`.
+     */
+    static const InterleaveTable deinterleave_table;
+
+    /**
+     * @brief 162-bit synchronization vector, one bit per symbol.
+     */
+    static const Symbols sync_vector;
+
+    /**
+     * @brief First generator polynomial of the K=32, r=1/2 convolutional code.
+     */
+    static constexpr uint32_t poly_a = 0xf2d05351;
+
+    /**
+     * @brief Second generator polynomial of the K=32, r=1/2 convolutional code.
+     */
+    static constexpr uint32_t poly_b = 0xe4613c47;
+
+    /**
+     * @brief Computes both convolutional encoder output bits for a register state.
+     *
+     * The register is processed one byte at a time through precomputed
+     * tables, replacing two bit-count loops per input bit with four lookups.
+     *
+     * @param reg The current 32-bit encoder shift register.
+     * @return Bit 0 holds the parity against poly_a, bit 1 the parity against poly_b.
+     */
+    static constexpr unsigned char encode_parity_pair(uint32_t reg) noexcept
+    {
+        return parity_pair_table[0][reg & 0xFF] ^
+               parity_pair_table[1][(reg >> 8) & 0xFF] ^
+               parity_pair_table[2][(reg >> 16) & 0xFF] ^
+               parity_pair_table[3][reg >> 24];
+    }
+
 private:
     /**
-     * @brief Converts a character to its corresponding numeric value.
+     * @brief Per-byte lookup tables of encoder output pairs.
+     *
+     * Parity is linear over XOR, so the parity of `reg & poly` equals the XOR
+     * of the parities of each byte of `reg` masked with the matching byte of
+     * `poly`. Entry `[k][v]` holds both output bits for byte `k` of the
+     * register taking value `v`: bit 0 against poly_a and bit 1 against poly_b.
+     */
+    using ParityPairTable = std::array<std::array<unsigned char, 256>, 4>;
+
+    /**
+     * @brief Compile-time parity-pair lookup tables.
+     */
+    static const ParityPairTable parity_pair_table;
+
+    /**
+     * @brief Builds the parity-pair lookup tables.
+     *
+     * @return The populated table.
+     */
+    static constexpr ParityPairTable make_parity_pair_table()
+    {
+        ParityPairTable table{};
+        for (int k = 0; k < 4; ++k)
+        {
+            for (int v = 0; v < 256; ++v)
+            {
+                uint32_t a = static_cast<uint32_t>(v) & ((poly_a >> (8 * k)) & 0xFF);
+                uint32_t b = static_cast<uint32_t>(v) & ((poly_b >> (8 * k)) & 0xFF);
+                unsigned char pa = 0;
+                unsigned char pb = 0;
+                for (; a; a &= a - 1)
+                {
+                    pa ^= 1;
+                }
+                for (; b; b &= b - 1)
+                {
+                    pb ^= 1;
+                }
+                table[k][v] = static_cast<unsigned char>(pa | (pb << 1));
+            }
+        }
+        return table;
+    }
+
+    /**
+     * @brief Character lookup table type, indexed by byte value.
+     *
+     * Bits 0-5 of each entry hold the packed character value (digits 0-9,
+     * letters of either case 10-35, space 36, anything else 0). Bit 6 marks
+     * a digit and bit 7 a letter.
+     */
+    using CharTable = std::array<uint8_t, 256>;
+
+    static constexpr uint8_t char_value = 0x3F;  ///< Mask for the packed character value.
+    static constexpr uint8_t char_digit = 0x40;  ///< Set for '0'-'9'.
+    static constexpr uint8_t char_letter = 0x80; ///< Set for 'A'-'Z' and 'a'-'z'.
+
+    /**
+     * @brief Compile-time character lookup table.
+     */
+    static const CharTable char_table;
+
+    /**
+     * @brief Builds the character lookup table.
+     *
+     * @return The populated table.
+     */
+    static constexpr CharTable make_char_table()
+    {
+        CharTable table{};
+        for (int c = '0'; c <= '9'; ++c)
+        {
+            table[c] = static_cast<uint8_t>(char_digit | (c - '0'));
+        }
+        for (int c = 'A'; c <= 'Z'; ++c)
+        {
+            table[c] = static_cast<uint8_t>(char_letter | (10 + c - 'A'));
+            table[c - 'A' + 'a'] = table[c];
+        }
+        table[' '] = 36;
+        return table;
+    }
+
+    /**
+     * @brief Looks up the table entry for a character.
+     *
+     * @param ch The character to classify.
+     * @return Its char_table entry.
+     */
+    static constexpr uint8_t char_info(char ch) noexcept
+    {
+        return char_table[static_cast<uint8_t>(ch)];
+    }
+
+    /**
+     * @brief Checks for an ASCII decimal digit.
+     *
+     * @param ch The character to test.
+     * @return True if `ch` is '0'-'9'.
+     */
+    static constexpr bool is_digit(char ch) noexcept
+    {
+        return (char_info(ch) & char_digit) != 0;
+    }
+
+    /**
+     * @brief Checks for an ASCII letter of either case.
+     *
+     * @param ch The character to test.
+     * @return True if `ch` is 'A'-'Z' or 'a'-'z'.
+     */
+    static constexpr bool is_alpha(char ch) noexcept
+    {
+        return (char_info(ch) & char_letter) != 0;
+    }
+
+    /**
+     * @brief Converts an ASCII letter to uppercase.
      *
      * @param ch The character to convert.
-     * @return Numeric value of the character.
+     * @return The uppercase letter, or `ch` unchanged if it is not a lowercase letter.
      */
-    static int get_character_value(char ch);
+    static constexpr char upper_char(char ch) noexcept
+    {
+        const uint8_t info = char_info(ch);
+        return (info & char_letter) ? static_cast<char>('A' + (info & char_value) - 10) : ch;
+    }
 
     /**
-     * @brief Calculates the parity bit for a given value.
+     * @brief Validates a standard (Type 1) callsign.
      *
-     * @param ch The value to calculate parity for.
-     * @return Parity bit (0 or 1).
+     * @param callsign The callsign to check, in either case.
+     * @return True if the callsign can be packed without loss.
      */
-    static int calculate_parity(uint32_t ch);
+    static constexpr bool is_valid_callsign(std::string_view callsign) noexcept
+    {
+        if (callsign.empty() || callsign.length() > 6)
+        {
+            return false;
+        }
+
+        // Locate the area digit using the same rule as the encoder
+        std::size_t digit = 0;
+        if (callsign.length() >= 2 && is_digit(callsign[1]))
+        {
+            if (callsign.length() > 5)
+            {
+                return false; // Shifted right, so only five characters fit
+            }
+            digit = 1;
+        }
+        else if (callsign.length() >= 3 && is_digit(callsign[2]))
+        {
+            digit = 2;
+        }
+        else
+        {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < callsign.length(); ++i)
+        {
+            char ch = callsign[i];
+            bool ok = (i < digit) ? (is_alpha(ch) || is_digit(ch)) : (i == digit || is_alpha(ch));
+            if (!ok)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Validates a 4-character Maidenhead grid square.
+     *
+     * @param location The locator to check, in either case.
+     * @return True if the locator is two field letters (A-R) followed by two digits.
+     */
+    static constexpr bool is_valid_locator(std::string_view location) noexcept
+    {
+        if (location.length() != 4)
+        {
+            return false;
+        }
+        char field0 = upper_char(location[0]);
+        char field1 = upper_char(location[1]);
+        return field0 >= 'A' && field0 <= 'R' &&
+               field1 >= 'A' && field1 <= 'R' &&
+               is_digit(location[2]) && is_digit(location[3]);
+    }
+
+    /**
+     * @brief Validates a WSPR power level.
+     *
+     * @param power The power level in dBm.
+     * @return True if the power is 0-60 dBm and ends in 0, 3, or 7.
+     */
+    static constexpr bool is_valid_power(int power) noexcept
+    {
+        int last = power % 10;
+        return power >= 0 && power <= 60 && (last == 0 || last == 3 || last == 7);
+    }
+
+    /**
+     * @brief Validates a 6-character Maidenhead subsquare locator.
+     *
+     * @param location The locator to check, in either case.
+     * @return True if the locator is a valid 4-character square followed by
+     *         two subsquare letters (A-X).
+     */
+    static constexpr bool is_valid_locator6(std::string_view location) noexcept
+    {
+        if (location.length() != 6 || !is_valid_locator(location.substr(0, 4)))
+        {
+            return false;
+        }
+        char sub0 = upper_char(location[4]);
+        char sub1 = upper_char(location[5]);
+        return sub0 >= 'A' && sub0 <= 'X' && sub1 >= 'A' && sub1 <= 'X';
+    }
+
+    /**
+     * @brief Splits and validates a compound callsign.
+     *
+     * @param callsign The compound callsign (either case).
+     * @param base Receives the standard callsign part.
+     * @param prefix Receives the 16-bit add-on value: a base-37 prefix below
+     *               60000, or 60000 plus the suffix code.
+     * @return True if the callsign is a valid compound callsign.
+     */
+    static constexpr bool split_compound(std::string_view callsign, std::string_view &base, uint32_t &prefix) noexcept
+    {
+        const std::size_t slash = callsign.find('/');
+        if (slash == std::string_view::npos || callsign.find('/', slash + 1) != std::string_view::npos)
+        {
+            return false;
+        }
+        const std::string_view left = callsign.substr(0, slash);
+        const std::string_view right = callsign.substr(slash + 1);
+
+        if (right.length() == 1)
+        {
+            // Single letter or digit suffix: 0-9 map to 0-9, A-Z to 10-35
+            const char ch = upper_char(right[0]);
+            if (!is_digit(ch) && !is_alpha(ch))
+            {
+                return false;
+            }
+            base = left;
+            prefix = 60000 + static_cast<uint32_t>(get_character_value(ch));
+        }
+        else if (right.length() == 2)
+        {
+            // Two-digit suffix 10-99, coded above the single-character range
+            if (!is_digit(right[0]) || !is_digit(right[1]) || right[0] == '0')
+            {
+                return false;
+            }
+            base = left;
+            prefix = 60000 + 26 + static_cast<uint32_t>((right[0] - '0') * 10 + (right[1] - '0'));
+        }
+        else
+        {
+            // Prefix of 1-3 characters, right aligned and space padded, base 37
+            if (left.empty() || left.length() > 3)
+            {
+                return false;
+            }
+            prefix = 0;
+            for (std::size_t i = left.length(); i < 3; ++i)
+            {
+                prefix = prefix * 37 + 36;
+            }
+            for (char ch : left)
+            {
+                if (!is_digit(ch) && !is_alpha(ch))
+                {
+                    return false;
+                }
+                prefix = prefix * 37 + static_cast<uint32_t>(get_character_value(ch));
+            }
+            base = right;
+        }
+
+        return is_valid_callsign(base);
+    }
+
+    /**
+     * @brief Rotates a 32-bit value left.
+     *
+     * @param x The value to rotate.
+     * @param k The rotation count (1-31).
+     * @return The rotated value.
+     */
+    static constexpr uint32_t rotate_left(uint32_t x, int k) noexcept
+    {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    /**
+     * @brief Bob Jenkins' lookup3 `hashlittle()` over a byte string.
+     *
+     * @param key The bytes to hash.
+     * @param seed The initial value.
+     * @return The 32-bit hash.
+     */
+    static constexpr uint32_t nhash(std::string_view key, uint32_t seed) noexcept
+    {
+        std::size_t length = key.length();
+        uint32_t a = 0xdeadbeef + static_cast<uint32_t>(length) + seed;
+        uint32_t b = a;
+        uint32_t c = a;
+        std::size_t offset = 0;
+
+        auto word = [&key](std::size_t at, std::size_t count)
+        {
+            uint32_t value = 0;
+            for (std::size_t i = 0; i < count && i < 4; ++i)
+            {
+                value += static_cast<uint32_t>(static_cast<uint8_t>(key[at + i])) << (8 * i);
+            }
+            return value;
+        };
+
+        while (length > 12)
+        {
+            a += word(offset, 4);
+            b += word(offset + 4, 4);
+            c += word(offset + 8, 4);
+
+            a -= c; a ^= rotate_left(c, 4);  c += b;
+            b -= a; b ^= rotate_left(a, 6);  a += c;
+            c -= b; c ^= rotate_left(b, 8);  b += a;
+            a -= c; a ^= rotate_left(c, 16); c += b;
+            b -= a; b ^= rotate_left(a, 19); a += c;
+            c -= b; c ^= rotate_left(b, 4);  b += a;
+
+            length -= 12;
+            offset += 12;
+        }
+
+        if (length == 0)
+        {
+            return c;
+        }
+
+        a += word(offset, length);
+        if (length > 4)
+        {
+            b += word(offset + 4, length - 4);
+        }
+        if (length > 8)
+        {
+            c += word(offset + 8, length - 8);
+        }
+
+        c ^= b; c -= rotate_left(b, 14);
+        a ^= c; a -= rotate_left(c, 11);
+        b ^= a; b -= rotate_left(a, 25);
+        c ^= b; c -= rotate_left(b, 16);
+        a ^= c; a -= rotate_left(c, 4);
+        b ^= a; b -= rotate_left(a, 14);
+        c ^= b; c -= rotate_left(b, 24);
+        return c;
+    }
 
     /**
-     * @brief Reverses the bit order for address calculation.
+     * @brief Converts a character to its corresponding numeric value.
      *
-     * @param reverseAddressIndex Reference to the current address index.
-     * @return Reversed bit address.
+     * @param ch The character to convert (digit, letter, or space).
+     * @return The numeric value of the character:
+     *         - Digits ('0'-'9') return their integer value (0-9).
+     *         - Letters ('A'-'Z', either case) return 10-35.
+     *         - A space (' ') returns 36.
+     *         - All other characters return 0 (invalid input).
      */
-    static unsigned char reverse_address(unsigned char &reverseAddressIndex);
+    static constexpr int get_character_value(char ch) noexcept
+    {
+        return char_info(ch) & char_value;
+    }
 
     /**
      * @brief Reverses the bits in a byte.
@@ -119,23 +1102,466 @@ private:
      * @param b The byte to reverse.
      * @return The reversed byte.
      */
-    static unsigned char reverse_bits(unsigned char b);
+    static constexpr unsigned char reverse_bits(unsigned char b)
+    {
+        // Swap nibbles, then pairs of bits, then individual bits
+        b = static_cast<unsigned char>((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+        b = static_cast<unsigned char>((b & 0xCC) >> 2 | (b & 0x33) << 2);
+        b = static_cast<unsigned char>((b & 0xAA) >> 1 | (b & 0x55) << 1);
+        return b;
+    }
 
     /**
-     * @brief Converts a string to uppercase.
+     * @brief Builds the interleaver permutation.
+     *
+     * Walks the 8-bit address space in order, bit-reverses each address, and
+     * keeps only the results that fall within the 162-symbol message.
      *
-     * @param str The string to convert.
+     * @return Table mapping encoder output bit index to symbol position.
      */
-    static void to_upper(std::string &str);
+    static constexpr InterleaveTable make_interleave_table()
+    {
+        InterleaveTable table{};
+        unsigned int address = 0;
+        for (std::size_t i = 0; i < table.size(); ++i)
+        {
+            unsigned char result = reverse_bits(static_cast<unsigned char>(address++));
+            while (result >= MSG_SIZE)
+            {
+                result = reverse_bits(static_cast<unsigned char>(address++));
+            }
+            table[i] = result;
+        }
+        return table;
+    }
 
     /**
-     * @brief Generates WSPR symbols based on callsign, location, and power.
+     * @brief Builds the inverse of the interleaver permutation.
+     *
+     * @return Table mapping symbol position to encoder output bit index.
+     */
+    static constexpr InterleaveTable make_deinterleave_table()
+    {
+        InterleaveTable forward = make_interleave_table();
+        InterleaveTable table{};
+        for (std::size_t i = 0; i < forward.size(); ++i)
+        {
+            table[forward[i]] = static_cast<uint8_t>(i);
+        }
+        return table;
+    }
+
+#if WSPR_EXCEPTIONS
+    /**
+     * @brief Shared body of the throwing encoders.
      *
      * @param callsign The callsign to encode.
-     * @param location The Maidenhead grid location to encode.
+     * @param location The Maidenhead grid locator (4-character format).
+     * @param power The transmission power level in dBm.
+     * @param out Destination buffer of at least MSG_SIZE bytes.
+     * @return The packed payload that was encoded.
+     * @throws std::invalid_argument If the callsign or location format is invalid.
+     */
+    static WsprPayload encode_checked(std::string_view callsign, std::string_view location, int power, uint8_t *out);
+#endif
+
+    /**
+     * @brief Validates and packs Type 1 fields in a single pass.
+     *
+     * Each callsign and locator character is case-folded, checked, and
+     * converted to its packed value as it is read, so there is no separate
+     * validation pass and no normalized copy of the strings.
+     *
+     * @param callsign The callsign (either case).
+     * @param location The 4-character locator (either case).
      * @param power The power level in dBm.
+     * @param N Receives the packed 28-bit callsign integer on success.
+     * @param M Receives the packed 22-bit locator/power integer on success.
+     * @return WsprStatus::ok, or the first field found to be invalid.
+     */
+    static constexpr WsprStatus pack_checked(std::string_view callsign, std::string_view location, int power, uint32_t &N, uint32_t &M) noexcept
+    {
+        const std::size_t length = callsign.length();
+        if (length == 0 || length > 6)
+        {
+            return WsprStatus::invalid_callsign;
+        }
+
+        // The area digit lands in the third aligned position; a digit in the
+        // second character means the callsign shifts one place right
+        std::size_t shift = 0;
+        if (length >= 2 && is_digit(callsign[1]))
+        {
+            if (length > 5)
+            {
+                return WsprStatus::invalid_callsign;
+            }
+            shift = 1;
+        }
+        else if (length < 3 || !is_digit(callsign[2]))
+        {
+            return WsprStatus::invalid_callsign;
+        }
+
+        // Character values of the six aligned positions, space padded
+        const std::size_t digit = 2 - shift;
+        uint32_t value[6] = {36, 36, 36, 36, 36, 36};
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            const uint8_t info = char_info(callsign[i]);
+            const bool ok = (i < digit) ? (info & (char_letter | char_digit)) != 0
+                                        : (i == digit || (info & char_letter) != 0);
+            if (!ok)
+            {
+                return WsprStatus::invalid_callsign;
+            }
+            value[i + shift] = info & char_value;
+        }
+
+        if (location.length() != 4)
+        {
+            return WsprStatus::invalid_locator;
+        }
+        const char field0 = upper_char(location[0]);
+        const char field1 = upper_char(location[1]);
+        if (field0 < 'A' || field0 > 'R' || field1 < 'A' || field1 > 'R' ||
+            !is_digit(location[2]) || !is_digit(location[3]))
+        {
+            return WsprStatus::invalid_locator;
+        }
+
+        if (!is_valid_power(power))
+        {
+            return WsprStatus::invalid_power;
+        }
+
+        uint32_t n = value[0] * 36 + value[1];
+        n = n * 10 + value[2];
+        n = n * 27 + value[3] - 10;
+        n = n * 27 + value[4] - 10;
+        n = n * 27 + value[5] - 10;
+
+        const uint32_t grid = static_cast<uint32_t>((179 - 10 * (field0 - 'A') - (location[2] - '0')) * 180 +
+                                                    10 * (field1 - 'A') + (location[3] - '0'));
+        N = n;
+        M = grid * 128 + static_cast<uint32_t>(power) + 64;
+        return WsprStatus::ok;
+    }
+
+    /**
+     * @brief Packs the callsign, location, and power into the source integers.
+     *
+     * @param callsign The amateur radio callsign (up to 6 characters, uppercase).
+     * @param location The Maidenhead grid locator (4 characters, uppercase).
+     * @param power The transmission power level in dBm (0-60 dBm typical range).
+     * @param N Receives the packed 28-bit callsign integer.
+     * @param M Receives the packed 22-bit locator/power integer.
+     */
+    static constexpr void pack_fields(std::string_view callsign, std::string_view location, int power, uint32_t &N, uint32_t &M) noexcept
+    {
+        N = pack_callsign(callsign);
+
+        // Encode location and power into integer M
+        uint32_t M1 = (179 - 10 * (location[0] - 'A') - (location[2] - '0')) * 180 +
+                      (10 * (location[1] - 'A')) + (location[3] - '0');
+        M = M1 * 128 + power + 64;
+    }
+
+    /**
+     * @brief Aligns a standard callsign and packs it into the 28-bit integer N.
+     *
+     * @param callsign The amateur radio callsign (up to 6 characters).
+     * @return The packed callsign integer.
+     */
+    static constexpr uint32_t pack_callsign(std::string_view callsign) noexcept
+    {
+        // Callsign processing - ensure correct structure
+        char call[6] = {' ', ' ', ' ', ' ', ' ', ' '}; // Default to padded spaces
+
+        if (callsign.length() >= 2 && is_digit(callsign[1]))
+        {
+            // Numeric second character: shift callsign one position right
+            for (std::size_t i = 0; i < callsign.length() && i < 5; ++i)
+            {
+                call[i + 1] = callsign[i];
+            }
+        }
+        else if (callsign.length() >= 3 && is_digit(callsign[2]))
+        {
+            // Numeric third character: copy callsign as is
+            for (std::size_t i = 0; i < callsign.length() && i < 6; ++i)
+            {
+                call[i] = callsign[i];
+            }
+        }
+
+        return pack_call(call);
+    }
+
+    /**
+     * @brief Packs six aligned callsign characters into the 28-bit integer N.
+     *
+     * @param call Six characters: alphanumeric or space, alphanumeric, digit,
+     *             then three letters or spaces.
+     * @return The packed callsign integer.
+     */
+    static constexpr uint32_t pack_call(const char *call) noexcept
+    {
+        uint32_t N = get_character_value(call[0]) * 36 + get_character_value(call[1]);
+        N = N * 10 + get_character_value(call[2]);
+        N = N * 27 + get_character_value(call[3]) - 10;
+        N = N * 27 + get_character_value(call[4]) - 10;
+        N = N * 27 + get_character_value(call[5]) - 10;
+        return N;
+    }
+
+    /**
+     * @brief Convolutionally encodes and interleaves packed source integers.
+     *
+     * @param N The packed 28-bit callsign integer.
+     * @param M The packed 22-bit locator/power integer.
+     * @param out Destination buffer of at least MSG_SIZE bytes.
+     */
+    static constexpr void encode_packed(uint32_t N, uint32_t M, uint8_t *out) noexcept
+    {
+        // Initialize symbols array with sync vector
+        for (std::size_t i = 0; i < MSG_SIZE; ++i)
+        {
+            out[i] = sync_vector[i];
+        }
+
+        int i = 0;
+        uint32_t reg = 0;
+        std::size_t bit = 0;
+
+        // Encode N into symbols using convolutional encoding. Input bits are
+        // shifted in without branching: they are data, and a branch per bit
+        // mispredicts on mixed input (and profile feedback favours one)
+        for (i = 27; i >= 0; i--)
+        {
+            reg = (reg << 1) | ((N >> i) & 1);
+            unsigned char pair = encode_parity_pair(reg);
+            out[interleave_table[bit++]] += 2 * (pair & 1);
+            out[interleave_table[bit++]] += pair & 2;
+        }
+
+        // Encode M into symbols
+        for (i = 21; i >= 0; i--)
+        {
+            reg = (reg << 1) | ((M >> i) & 1);
+            unsigned char pair = encode_parity_pair(reg);
+            out[interleave_table[bit++]] += 2 * (pair & 1);
+            out[interleave_table[bit++]] += pair & 2;
+        }
+
+        // Final encoding loop for synchronization
+        for (i = 30; i >= 0; i--)
+        {
+            reg <<= 1;
+            unsigned char pair = encode_parity_pair(reg);
+            out[interleave_table[bit++]] += 2 * (pair & 1);
+            out[interleave_table[bit++]] += pair & 2;
+        }
+    }
+
+    /**
+     * @brief Re-encodes the symbols that depend on M, leaving the rest intact.
+     *
+     * After the 28 bits of N the encoder register equals N, so encoding can
+     * resume there. Output bits 0-55 depend on N alone and are not touched;
+     * each of the remaining 106 symbols is rewritten from its sync bit.
+     *
+     * @param N The packed 28-bit callsign integer that `out` already encodes.
+     * @param M The new packed 22-bit locator/power integer.
+     * @param out Symbol buffer of at least MSG_SIZE bytes.
      */
-    void generate_wspr_symbols(const std::string &callsign, const std::string &location, int power);
+    static constexpr void encode_tail(uint32_t N, uint32_t M, uint8_t *out) noexcept
+    {
+        uint32_t reg = N & 0x0FFFFFFF;
+        std::size_t bit = 56;
+
+        // Encode M
+        for (int i = 21; i >= 0; i--)
+        {
+            reg = (reg << 1) | ((M >> i) & 1);
+            unsigned char pair = encode_parity_pair(reg);
+            const std::size_t a = interleave_table[bit++];
+            const std::size_t b = interleave_table[bit++];
+            out[a] = static_cast<uint8_t>(sync_vector[a] + 2 * (pair & 1));
+            out[b] = static_cast<uint8_t>(sync_vector[b] + (pair & 2));
+        }
+
+        // Flush the register with 31 zero bits
+        for (int i = 30; i >= 0; i--)
+        {
+            reg <<= 1;
+            unsigned char pair = encode_parity_pair(reg);
+            const std::size_t a = interleave_table[bit++];
+            const std::size_t b = interleave_table[bit++];
+            out[a] = static_cast<uint8_t>(sync_vector[a] + 2 * (pair & 1));
+            out[b] = static_cast<uint8_t>(sync_vector[b] + (pair & 2));
+        }
+    }
+
+    /**
+     * @brief The body of try_encode(), without instrumentation.
+     *
+     * @param callsign The callsign to encode (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The transmission power level in dBm.
+     * @param out Destination buffer of at least MSG_SIZE bytes; untouched on failure.
+     * @return As for try_encode().
+     */
+    static constexpr WsprStatus try_encode_untimed(std::string_view callsign, std::string_view location, int power, uint8_t *out) noexcept
+    {
+        uint32_t N = 0;
+        uint32_t M = 0;
+        WsprStatus result = pack_checked(callsign, location, power, N, M);
+        if (result == WsprStatus::ok)
+        {
+            encode_packed(N, M, out);
+        }
+        return result;
+    }
+
+    /**
+     * @brief The body of try_set(), without instrumentation.
+     *
+     * @param callsign The callsign to encode (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The transmission power level in dBm.
+     * @return As for try_set().
+     */
+    constexpr WsprStatus try_set_untimed(std::string_view callsign, std::string_view location, int power) noexcept
+    {
+        uint32_t N = 0;
+        uint32_t M = 0;
+        WsprStatus result = pack_checked(callsign, location, power, N, M);
+        if (result == WsprStatus::ok)
+        {
+            encode_packed(N, M, symbols.data());
+            remember(N, M, power);
+        }
+        return result;
+    }
+
+    /**
+     * @brief The body of set_power(), without instrumentation.
+     *
+     * @param power The new transmission power level in dBm.
+     * @return As for set_power().
+     */
+    constexpr WsprStatus set_power_untimed(int power) noexcept
+    {
+        if (base_.m == 0)
+        {
+            return WsprStatus::invalid_callsign;
+        }
+        if (!is_valid_power(power))
+        {
+            return WsprStatus::invalid_power;
+        }
+        encode_tail(base_.n, base_.m + static_cast<uint32_t>(power), symbols.data());
+        return WsprStatus::ok;
+    }
+
+    /**
+     * @brief The body of reencode_power(), without instrumentation.
+     *
+     * @param payload The Type 1 payload that `out` encodes; its power is replaced.
+     * @param power The new transmission power level in dBm.
+     * @param out Symbol buffer of at least MSG_SIZE bytes.
+     * @return As for reencode_power().
+     */
+    static constexpr WsprStatus reencode_power_untimed(WsprPayload &payload, int power, uint8_t *out) noexcept
+    {
+        if (!is_valid_power(power))
+        {
+            return WsprStatus::invalid_power;
+        }
+        // Bits 0-6 of a Type 1 M hold power + 64 (at most 124)
+        payload.m = (payload.m & ~static_cast<uint32_t>(0x7F)) | (static_cast<uint32_t>(power) + 64);
+        encode_tail(payload.n, payload.m, out);
+        return WsprStatus::ok;
+    }
+
+#if WSPR_TIMED_CONSTEXPR
+    /**
+     * @brief Run-time try_encode(), timed into WsprStats::encode.
+     *
+     * @param callsign The callsign to encode (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The transmission power level in dBm.
+     * @param out Destination buffer of at least MSG_SIZE bytes.
+     * @return As for try_encode().
+     */
+    static WsprStatus try_encode_timed(std::string_view callsign, std::string_view location, int power, uint8_t *out) noexcept;
+
+    /**
+     * @brief Run-time try_set(), timed into WsprStats::reencode.
+     *
+     * @param callsign The callsign to encode (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The transmission power level in dBm.
+     * @return As for try_set().
+     */
+    WsprStatus try_set_timed(std::string_view callsign, std::string_view location, int power) noexcept;
+
+    /**
+     * @brief Run-time set_power(), timed into WsprStats::reencode.
+     *
+     * @param power The new transmission power level in dBm.
+     * @return As for set_power().
+     */
+    WsprStatus set_power_timed(int power) noexcept;
+
+    /**
+     * @brief Run-time reencode_power(), timed into WsprStats::reencode.
+     *
+     * @param payload The Type 1 payload that `out` encodes.
+     * @param power The new transmission power level in dBm.
+     * @param out Symbol buffer of at least MSG_SIZE bytes.
+     * @return As for reencode_power().
+     */
+    static WsprStatus reencode_power_timed(WsprPayload &payload, int power, uint8_t *out) noexcept;
+#endif
+
+    /**
+     * @brief Caches the callsign state of a freshly encoded message for set_power().
+     *
+     * @param N The packed 28-bit callsign integer.
+     * @param M The packed 22-bit locator/power integer.
+     * @param power The power level folded into M.
+     */
+    constexpr void remember(uint32_t N, uint32_t M, int power) noexcept
+    {
+        base_.n = N;
+        base_.m = M - static_cast<uint32_t>(power);
+    }
+
+    /**
+     * @brief Callsign state of the current message: N, and M with the power removed.
+     *
+     * `m` is zero until a message has been set.
+     */
+    WsprPayload base_;
 };
 
+constexpr WsprMessage::InterleaveTable WsprMessage::interleave_table = WsprMessage::make_interleave_table();
+constexpr WsprMessage::InterleaveTable WsprMessage::deinterleave_table = WsprMessage::make_deinterleave_table();
+constexpr WsprMessage::ParityPairTable WsprMessage::parity_pair_table = WsprMessage::make_parity_pair_table();
+constexpr WsprMessage::CharTable WsprMessage::char_table = WsprMessage::make_char_table();
+constexpr WsprMessage::Symbols WsprMessage::sync_vector = {
+    1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0,
+    1, 0, 0, 1, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0,
+    0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1,
+    0, 1, 0, 0, 0, 1, 1, 0, 1, 0, 0, 0, 0, 1, 1, 0, 1, 0,
+    1, 0, 1, 0, 1, 0, 0, 1, 0, 0, 1, 0, 1, 1, 0, 0, 0, 1,
+    1, 0, 1, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1,
+    0, 0, 1, 1, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 0, 1,
+    1, 1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 1, 0, 0, 0, 0,
+    0, 0, 0, 1, 1, 0, 1, 0, 1, 1, 0, 0, 0, 1, 1, 0, 0, 0};
+
+static_assert(WsprSymbolBlock::stride == MSG_SIZE, "WsprSymbolBlock must match the message size");
+
 #endif // WSPR_MESSAGE_H
@@ -0,0 +1,240 @@
+/**
+ * @file wspr_parallel.cpp
+ * @brief Multithreaded bulk WSPR encoding on a persistent thread pool.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_parallel.hpp"
+#include "wspr_stats.hpp"
+
+/**
+ * @brief Creates the encoder and starts its worker threads.
+ *
+ * @param threads Total number of encoding threads including the caller;
+ *                0 uses std::thread::hardware_concurrency().
+ * @param chunk Messages per chunk; rounded up to a multiple of the widest SIMD kernel.
+ * @throws std::system_error If a worker thread cannot be started; workers
+ *         already running are stopped and joined first.
+ */
+WsprParallelEncoder::WsprParallelEncoder(unsigned threads, std::size_t chunk)
+{
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads == 0)
+    {
+        threads = 1; // hardware_concurrency() may be unknown
+    }
+
+    // Keep chunk boundaries aligned to full SIMD groups
+    const std::size_t lanes = WsprSimd::avx2_lanes;
+    chunk_ = chunk < lanes ? lanes : (chunk + lanes - 1) / lanes * lanes;
+
+    workers_.reserve(threads - 1);
+#if WSPR_EXCEPTIONS
+    try
+    {
+        for (unsigned i = 1; i < threads; ++i)
+        {
+            workers_.emplace_back(&WsprParallelEncoder::worker_loop, this);
+        }
+    }
+    catch (...)
+    {
+        stop_workers(); // Destroying a joinable std::thread would terminate
+        throw;
+    }
+#else
+    for (unsigned i = 1; i < threads; ++i)
+    {
+        workers_.emplace_back(&WsprParallelEncoder::worker_loop, this);
+    }
+#endif
+}
+
+/**
+ * @brief Stops and joins all worker threads.
+ */
+WsprParallelEncoder::~WsprParallelEncoder()
+{
+    stop_workers();
+}
+
+/**
+ * @brief Signals every started worker to stop, then joins them.
+ */
+void WsprParallelEncoder::stop_workers() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+
+    for (std::thread &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Returns the total number of encoding threads, including the caller.
+ *
+ * @return Thread count (at least 1).
+ */
+unsigned WsprParallelEncoder::threads() const noexcept
+{
+    return static_cast<unsigned>(workers_.size()) + 1;
+}
+
+/**
+ * @brief Encodes `count` messages into contiguous output rows in parallel.
+ *
+ * @param callsigns Array of `count` callsigns (either case).
+ * @param locations Array of `count` 4-character Maidenhead locators (either case).
+ * @param powers Array of `count` power levels in dBm.
+ * @param count Number of messages to encode.
+ * @param out Destination block of `count` rows of MSG_SIZE symbols.
+ * @param status Optional array of `count` per-item results; may be nullptr.
+ * @param kernel Encoder kernel; unavailable kernels fall back to WsprSimd::best().
+ * @return Number of messages successfully encoded.
+ *
+ * @note Inputs no larger than one chunk, or a single-threaded pool, are
+ *       encoded inline without waking any workers.
+ */
+std::size_t WsprParallelEncoder::encode(const std::string_view *callsigns,
+                                        const std::string_view *locations,
+                                        const int *powers,
+                                        std::size_t count,
+                                        uint8_t (*out)[MSG_SIZE],
+                                        WsprStatus *status,
+                                        WsprKernel kernel)
+{
+    WSPR_STAT_TIME(parallel, count);
+    kernel = WsprSimd::resolve(kernel);
+
+    if (workers_.empty() || count <= chunk_)
+    {
+        return WsprBatch::encode(callsigns, locations, powers, count, out, status, kernel);
+    }
+
+    std::lock_guard<std::mutex> call_lock(call_mutex_);
+
+    Job job;
+    job.callsigns = callsigns;
+    job.locations = locations;
+    job.powers = powers;
+    job.count = count;
+    job.out = out;
+    job.status = status;
+    job.kernel = kernel;
+
+    // Publish the job, then help with it from this thread
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        ++generation_;
+        active_ = static_cast<unsigned>(workers_.size());
+    }
+    wake_.notify_all();
+
+    run_chunks(job);
+
+    // Wait for every worker to leave the job before it goes out of scope
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]
+                   { return active_ == 0; });
+        job_ = nullptr;
+    }
+
+    return job.encoded.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Claims and encodes chunks of a job until none remain.
+ *
+ * @param job The job to work on.
+ *
+ * @note Each chunk covers a disjoint range of rows, so no locking is needed
+ *       around the output or status arrays.
+ */
+void WsprParallelEncoder::run_chunks(Job &job) const noexcept
+{
+    std::size_t encoded = 0;
+
+    for (;;)
+    {
+        const std::size_t begin = job.next.fetch_add(chunk_, std::memory_order_relaxed);
+        if (begin >= job.count)
+        {
+            break;
+        }
+        const std::size_t length = (job.count - begin < chunk_) ? job.count - begin : chunk_;
+
+        encoded += WsprBatch::encode(job.callsigns + begin,
+                                     job.locations + begin,
+                                     job.powers + begin,
+                                     length,
+                                     job.out + begin,
+                                     job.status != nullptr ? job.status + begin : nullptr,
+                                     job.kernel);
+    }
+
+    job.encoded.fetch_add(encoded, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Worker thread body: waits for jobs and helps complete them.
+ */
+void WsprParallelEncoder::worker_loop()
+{
+    uint64_t seen = 0;
+
+    for (;;)
+    {
+        Job *job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, seen]
+                       { return stop_ || generation_ != seen; });
+            if (stop_)
+            {
+                return;
+            }
+            seen = generation_;
+            job = job_;
+        }
+
+        run_chunks(*job);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_ == 0)
+            {
+                done_.notify_one();
+            }
+        }
+    }
+}
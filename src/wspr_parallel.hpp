@@ -0,0 +1,159 @@
+/**
+ * @file wspr_parallel.hpp
+ * @brief Multithreaded bulk WSPR encoding on a persistent thread pool.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_PARALLEL_H
+#define WSPR_PARALLEL_H
+
+#include "wspr_batch.hpp"
+
+#include <atomic>             // For: std::atomic
+#include <condition_variable> // For: std::condition_variable
+#include <cstddef>            // For: std::size_t
+#include <cstdint>            // For: uint8_t, uint64_t
+#include <mutex>              // For: std::mutex
+#include <string_view>        // For: std::string_view
+#include <thread>             // For: std::thread
+#include <vector>             // For: std::vector
+
+/**
+ * @class WsprParallelEncoder
+ * @brief Splits large batch encodes across a pool of worker threads.
+ *
+ * Input is divided into fixed-size chunks that threads claim from a shared
+ * atomic counter, so faster threads simply take more chunks. Each chunk is
+ * encoded with WsprBatch::encode() directly into its own rows of the
+ * caller's output block, so the output is written without locks and row
+ * `i` always holds item `i`.
+ *
+ * Worker threads are created once and reused across calls. The calling
+ * thread also encodes chunks, so a pool of `threads` uses `threads - 1`
+ * workers. With `threads == 1` no threads are created and every call runs
+ * inline, which suits embedded targets.
+ */
+class WsprParallelEncoder
+{
+public:
+    /**
+     * @brief Default number of messages claimed per chunk.
+     */
+    static constexpr std::size_t default_chunk = 1024;
+
+    /**
+     * @brief Creates the encoder and starts its worker threads.
+     *
+     * @param threads Total number of encoding threads including the caller;
+     *                0 uses std::thread::hardware_concurrency().
+     * @param chunk Messages per chunk; rounded up to a multiple of the widest SIMD kernel.
+     * @throws std::system_error If a worker thread cannot be started; workers
+     *         already running are stopped and joined first.
+     */
+    explicit WsprParallelEncoder(unsigned threads = 0, std::size_t chunk = default_chunk);
+
+    /**
+     * @brief Stops and joins all worker threads.
+     */
+    ~WsprParallelEncoder();
+
+    WsprParallelEncoder(const WsprParallelEncoder &) = delete;
+    WsprParallelEncoder &operator=(const WsprParallelEncoder &) = delete;
+
+    /**
+     * @brief Returns the total number of encoding threads, including the caller.
+     *
+     * @return Thread count (at least 1).
+     */
+    unsigned threads() const noexcept;
+
+    /**
+     * @brief Encodes `count` messages into contiguous output rows in parallel.
+     *
+     * Arguments and results match WsprBatch::encode(). Concurrent calls on
+     * the same encoder are serialized.
+     *
+     * @param callsigns Array of `count` callsigns (either case).
+     * @param locations Array of `count` 4-character Maidenhead locators (either case).
+     * @param powers Array of `count` power levels in dBm.
+     * @param count Number of messages to encode.
+     * @param out Destination block of `count` rows of MSG_SIZE symbols.
+     * @param status Optional array of `count` per-item results; may be nullptr.
+     * @param kernel Encoder kernel; unavailable kernels fall back to WsprSimd::best().
+     * @return Number of messages successfully encoded.
+     */
+    std::size_t encode(const std::string_view *callsigns,
+                       const std::string_view *locations,
+                       const int *powers,
+                       std::size_t count,
+                       uint8_t (*out)[MSG_SIZE],
+                       WsprStatus *status,
+                       WsprKernel kernel = WsprKernel::automatic);
+
+private:
+    /**
+     * @brief A single parallel encode shared by all participating threads.
+     */
+    struct Job
+    {
+        const std::string_view *callsigns;
+        const std::string_view *locations;
+        const int *powers;
+        std::size_t count;
+        uint8_t (*out)[MSG_SIZE];
+        WsprStatus *status;
+        WsprKernel kernel;
+        std::atomic<std::size_t> next{0};    ///< First item of the next unclaimed chunk.
+        std::atomic<std::size_t> encoded{0}; ///< Running total of encoded items.
+    };
+
+    /**
+     * @brief Claims and encodes chunks of a job until none remain.
+     *
+     * @param job The job to work on.
+     */
+    void run_chunks(Job &job) const noexcept;
+
+    /**
+     * @brief Worker thread body: waits for jobs and helps complete them.
+     */
+    void worker_loop();
+
+    /**
+     * @brief Signals every started worker to stop, then joins them.
+     */
+    void stop_workers() noexcept;
+
+    std::size_t chunk_;                 ///< Messages per chunk.
+    std::vector<std::thread> workers_;  ///< Worker threads (threads - 1).
+    std::mutex call_mutex_;             ///< Serializes calls to encode().
+    std::mutex mutex_;                  ///< Guards the job hand-off state below.
+    std::condition_variable wake_;      ///< Signals workers that a job or stop is pending.
+    std::condition_variable done_;      ///< Signals the caller that all workers finished.
+    Job *job_ = nullptr;                ///< Current job, or nullptr when idle.
+    uint64_t generation_ = 0;           ///< Incremented for every published job.
+    unsigned active_ = 0;               ///< Workers still working on the current job.
+    bool stop_ = false;                 ///< Set by stop_workers() to end worker loops.
+};
+
+#endif // WSPR_PARALLEL_H
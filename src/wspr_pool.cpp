@@ -0,0 +1,171 @@
+/**
+ * @file wspr_pool.cpp
+ * @brief Contiguous, cache-line-aligned arena of symbol slots for large station fleets.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_pool.hpp"
+
+#include <new>     // For: std::align_val_t
+#include <utility> // For: std::move
+
+/**
+ * @brief Creates a pool.
+ *
+ * @param capacity Number of slots.
+ */
+WsprMessagePool::WsprMessagePool(std::size_t capacity)
+    : arena_(static_cast<uint8_t *>(::operator new[](capacity * stride, std::align_val_t(alignment)))),
+      next_(capacity)
+{
+    // Thread the free list in address order so a fresh pool fills from the front
+    for (std::size_t h = 0; h < capacity; ++h)
+    {
+        next_[h] = (h + 1 < capacity) ? static_cast<Handle>(h + 1) : invalid;
+    }
+    free_ = capacity ? 0 : invalid;
+}
+
+/**
+ * @brief Takes over another pool's arena.
+ *
+ * @param other The source.
+ */
+WsprMessagePool::WsprMessagePool(WsprMessagePool &&other) noexcept
+    : arena_(std::move(other.arena_)),
+      next_(std::move(other.next_)),
+      free_(other.free_),
+      live_(other.live_)
+{
+    other.next_.clear();
+    other.free_ = invalid;
+    other.live_ = 0;
+}
+
+/**
+ * @brief Takes over another pool's arena.
+ *
+ * @param other The source.
+ * @return This pool.
+ */
+WsprMessagePool &WsprMessagePool::operator=(WsprMessagePool &&other) noexcept
+{
+    if (this != &other)
+    {
+        arena_ = std::move(other.arena_);
+        next_ = std::move(other.next_);
+        free_ = other.free_;
+        live_ = other.live_;
+        other.next_.clear();
+        other.free_ = invalid;
+        other.live_ = 0;
+    }
+    return *this;
+}
+
+/**
+ * @brief Frees the aligned arena.
+ *
+ * @param arena The arena.
+ */
+void WsprMessagePool::ArenaDelete::operator()(uint8_t *arena) const noexcept
+{
+    ::operator delete[](arena, std::align_val_t(alignment));
+}
+
+/**
+ * @brief Takes a free slot.
+ *
+ * @return The handle, or `invalid`.
+ */
+WsprMessagePool::Handle WsprMessagePool::acquire() noexcept
+{
+    const Handle handle = free_;
+    if (handle != invalid)
+    {
+        free_ = next_[handle];
+        next_[handle] = held;
+        ++live_;
+    }
+    return handle;
+}
+
+/**
+ * @brief Returns a slot to the pool.
+ *
+ * @param handle The slot.
+ */
+void WsprMessagePool::release(Handle handle) noexcept
+{
+    if (!live(handle))
+    {
+        return;
+    }
+    next_[handle] = free_;
+    free_ = handle;
+    --live_;
+}
+
+/**
+ * @brief Takes a free slot and encodes a message into it.
+ *
+ * @param callsign The callsign.
+ * @param location The locator.
+ * @param power The power level.
+ * @param status Validation result, or null.
+ * @return The slot, or `invalid`.
+ */
+WsprMessagePool::Handle WsprMessagePool::encode(std::string_view callsign, std::string_view location, int power, WsprStatus *status) noexcept
+{
+    WsprPayload payload;
+    const WsprStatus result = WsprMessage::pack(callsign, location, power, payload);
+    if (status != nullptr)
+    {
+        *status = result;
+    }
+    if (result != WsprStatus::ok)
+    {
+        return invalid;
+    }
+
+    const Handle handle = acquire();
+    if (handle != invalid)
+    {
+        WsprMessage::encode_payload(payload, symbols(handle));
+    }
+    return handle;
+}
+
+/**
+ * @brief Re-encodes a message into a held slot.
+ *
+ * @param handle The slot.
+ * @param callsign The callsign.
+ * @param location The locator.
+ * @param power The power level.
+ * @return WsprStatus::ok, or the validation failure.
+ */
+WsprStatus WsprMessagePool::set(Handle handle, std::string_view callsign, std::string_view location, int power) noexcept
+{
+    return WsprMessage::try_encode(callsign, location, power, symbols(handle));
+}
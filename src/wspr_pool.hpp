@@ -0,0 +1,344 @@
+/**
+ * @file wspr_pool.hpp
+ * @brief Contiguous, cache-line-aligned arena of symbol slots for large station fleets.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_POOL_H
+#define WSPR_POOL_H
+
+#include "wspr_message.hpp"
+#include "wspr_span.hpp"
+
+#include <cstddef>     // For: std::size_t
+#include <cstdint>     // For: uint8_t, uint32_t
+#include <memory>      // For: std::unique_ptr
+#include <string_view> // For: std::string_view
+#include <vector>      // For: std::vector
+
+/**
+ * @class WsprMessagePool
+ * @brief Hands out 162-symbol slots from one aligned allocation.
+ *
+ * A WsprMessage already stores its symbols inline, so a std::vector of
+ * them is contiguous. The pool is for fleets whose membership changes:
+ * stations come and go without a heap allocation each, and the live
+ * slots stay inside a single arena. Each slot starts on a cache line and
+ * is padded to a whole number of lines, so a message never shares a line
+ * with its neighbour and occupies the fewest lines possible.
+ *
+ * acquire() and release() are O(1). Free slots form a LIFO list threaded
+ * through an index array, so a just-released slot is the next one handed
+ * out while it is still in cache. The pool is not thread-safe; give
+ * each thread its own pool.
+ */
+class WsprMessagePool
+{
+public:
+    /**
+     * @brief Slot identifier.
+     */
+    using Handle = uint32_t;
+
+    /**
+     * @brief Returned by acquire() when the pool is exhausted.
+     */
+    static constexpr Handle invalid = 0xFFFFFFFFu;
+
+    /**
+     * @brief Alignment of the arena and of every slot.
+     */
+    static constexpr std::size_t alignment = 64;
+
+    /**
+     * @brief Distance between consecutive slots: MSG_SIZE rounded up to whole cache lines.
+     */
+    static constexpr std::size_t stride = (MSG_SIZE + alignment - 1) / alignment * alignment;
+
+    /**
+     * @brief Creates a pool.
+     *
+     * @param capacity Number of slots, allocated up front.
+     */
+    explicit WsprMessagePool(std::size_t capacity);
+
+    WsprMessagePool(const WsprMessagePool &) = delete;
+    WsprMessagePool &operator=(const WsprMessagePool &) = delete;
+
+    /**
+     * @brief Takes over another pool's arena; handles stay valid in the new pool.
+     *
+     * @param other The source; left empty with zero capacity.
+     */
+    WsprMessagePool(WsprMessagePool &&other) noexcept;
+
+    /**
+     * @brief Takes over another pool's arena, freeing this one's.
+     *
+     * @param other The source; left empty with zero capacity.
+     * @return This pool.
+     */
+    WsprMessagePool &operator=(WsprMessagePool &&other) noexcept;
+
+    /**
+     * @brief Takes a free slot.
+     *
+     * @return The slot's handle, or `invalid` if every slot is in use. The
+     *         slot holds whatever symbols it last held.
+     */
+    Handle acquire() noexcept;
+
+    /**
+     * @brief Returns a slot to the pool.
+     *
+     * @param handle A handle from acquire(); releasing a free or invalid handle does nothing.
+     */
+    void release(Handle handle) noexcept;
+
+    /**
+     * @brief Takes a free slot and encodes a Type 1 message into it.
+     *
+     * @param callsign The callsign (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The power level in dBm.
+     * @param status Receives the validation result; may be null.
+     * @return The slot, or `invalid` if the pool is full or the message is
+     *         invalid (no slot is consumed then).
+     */
+    Handle encode(std::string_view callsign, std::string_view location, int power, WsprStatus *status = nullptr) noexcept;
+
+    /**
+     * @brief Re-encodes a message into a slot that is already held.
+     *
+     * @param handle A live slot.
+     * @param callsign The callsign (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The power level in dBm.
+     * @return WsprStatus::ok, or the validation failure (the slot is unchanged).
+     */
+    WsprStatus set(Handle handle, std::string_view callsign, std::string_view location, int power) noexcept;
+
+    /**
+     * @brief Returns a slot's symbols.
+     *
+     * @param handle A live slot.
+     * @return Pointer to MSG_SIZE symbols, aligned to `alignment`.
+     */
+    uint8_t *symbols(Handle handle) noexcept { return arena_.get() + static_cast<std::size_t>(handle) * stride; }
+
+    /**
+     * @brief Returns a slot's symbols.
+     *
+     * @param handle A live slot.
+     * @return Pointer to MSG_SIZE symbols, aligned to `alignment`.
+     */
+    const uint8_t *symbols(Handle handle) const noexcept { return arena_.get() + static_cast<std::size_t>(handle) * stride; }
+
+    /**
+     * @brief Returns a read-only view of a slot's symbols.
+     *
+     * @param handle A live slot.
+     * @return MSG_SIZE symbols.
+     */
+    WsprSpan<const uint8_t> view(Handle handle) const noexcept { return WsprSpan<const uint8_t>(symbols(handle), MSG_SIZE); }
+
+    /**
+     * @brief Reports whether a handle refers to a slot currently held.
+     *
+     * @param handle Any handle.
+     * @return True if acquired and not yet released.
+     */
+    bool live(Handle handle) const noexcept { return handle < next_.size() && next_[handle] == held; }
+
+    /**
+     * @brief Calls `fn(handle, symbols)` for every live slot, in address order.
+     *
+     * @param fn Callable taking a Handle and a `const uint8_t *`.
+     */
+    template <typename Fn>
+    void for_each(Fn &&fn) const
+    {
+        for (Handle h = 0; h < next_.size(); ++h)
+        {
+            if (next_[h] == held)
+            {
+                fn(h, symbols(h));
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of live slots.
+     *
+     * @return Slots in use.
+     */
+    std::size_t size() const noexcept { return live_; }
+
+    /**
+     * @brief Returns the total number of slots.
+     *
+     * @return Capacity.
+     */
+    std::size_t capacity() const noexcept { return next_.size(); }
+
+    /**
+     * @brief Returns the start of the arena.
+     *
+     * @return `capacity() * stride` bytes, aligned to `alignment`.
+     */
+    const uint8_t *data() const noexcept { return arena_.get(); }
+
+private:
+    /**
+     * @brief Marks a slot as held in `next_`.
+     */
+    static constexpr Handle held = invalid - 1;
+
+    /**
+     * @brief Frees the aligned arena.
+     */
+    struct ArenaDelete
+    {
+        void operator()(uint8_t *arena) const noexcept;
+    };
+
+    std::unique_ptr<uint8_t[], ArenaDelete> arena_; ///< `capacity * stride` aligned bytes.
+    std::vector<Handle> next_;                       ///< Next free slot, `held`, or `invalid` at the list end.
+    Handle free_ = invalid;                          ///< Head of the free list.
+    std::size_t live_ = 0;                           ///< Slots in use.
+};
+
+/**
+ * @class WsprPooledMessage
+ * @brief Owns one slot of a WsprMessagePool for as long as it lives.
+ *
+ * The pooled counterpart of WsprMessage for code that wants an object
+ * per station: it acquires a slot on construction, releases it on
+ * destruction, and is movable but not copyable.
+ */
+class WsprPooledMessage
+{
+public:
+    /**
+     * @brief Constructs an empty handle holding no slot.
+     */
+    WsprPooledMessage() noexcept = default;
+
+    /**
+     * @brief Acquires a slot from a pool.
+     *
+     * @param pool The pool; must outlive this object. Check the result
+     *        with `operator bool`; it is empty if the pool was full.
+     */
+    explicit WsprPooledMessage(WsprMessagePool &pool) noexcept : pool_(&pool), handle_(pool.acquire()) {}
+
+    /**
+     * @brief Releases the slot.
+     */
+    ~WsprPooledMessage() { reset(); }
+
+    WsprPooledMessage(const WsprPooledMessage &) = delete;
+    WsprPooledMessage &operator=(const WsprPooledMessage &) = delete;
+
+    /**
+     * @brief Takes over another handle's slot.
+     *
+     * @param other The source; left empty.
+     */
+    WsprPooledMessage(WsprPooledMessage &&other) noexcept : pool_(other.pool_), handle_(other.handle_)
+    {
+        other.handle_ = WsprMessagePool::invalid;
+    }
+
+    /**
+     * @brief Releases this slot, then takes over another handle's slot.
+     *
+     * @param other The source; left empty.
+     * @return This handle.
+     */
+    WsprPooledMessage &operator=(WsprPooledMessage &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            pool_ = other.pool_;
+            handle_ = other.handle_;
+            other.handle_ = WsprMessagePool::invalid;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Reports whether a slot is held.
+     *
+     * @return True if this handle owns a slot.
+     */
+    explicit operator bool() const noexcept { return handle_ != WsprMessagePool::invalid; }
+
+    /**
+     * @brief Encodes a Type 1 message into the slot.
+     *
+     * @param callsign The callsign (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The power level in dBm.
+     * @return WsprStatus::ok, or the validation failure.
+     *
+     * @note The handle must hold a slot.
+     */
+    WsprStatus set(std::string_view callsign, std::string_view location, int power) noexcept
+    {
+        return pool_->set(handle_, callsign, location, power);
+    }
+
+    /**
+     * @brief Returns a read-only view of the symbols.
+     *
+     * @return MSG_SIZE symbols.
+     */
+    WsprSpan<const uint8_t> view() const noexcept { return pool_->view(handle_); }
+
+    /**
+     * @brief Returns the slot's handle in its pool.
+     *
+     * @return The handle, or WsprMessagePool::invalid if empty.
+     */
+    WsprMessagePool::Handle handle() const noexcept { return handle_; }
+
+    /**
+     * @brief Releases the slot, leaving the handle empty.
+     */
+    void reset() noexcept
+    {
+        if (handle_ != WsprMessagePool::invalid)
+        {
+            pool_->release(handle_);
+            handle_ = WsprMessagePool::invalid;
+        }
+    }
+
+private:
+    WsprMessagePool *pool_ = nullptr;                  ///< Owning pool.
+    WsprMessagePool::Handle handle_ = WsprMessagePool::invalid; ///< Held slot.
+};
+
+#endif // WSPR_POOL_H
@@ -0,0 +1,331 @@
+/**
+ * @file wspr_receive.cpp
+ * @brief Receive-side helpers: tone splitting, sync correlation, and deinterleaving.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_receive.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // For: AVX2 intrinsics
+#define WSPR_RECEIVE_X86 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // For: NEON intrinsics
+#define WSPR_RECEIVE_NEON 1
+#endif
+
+/**
+ * @brief Builds the signed, zero-padded sync pattern.
+ *
+ * @return +1 where the sync bit is set, -1 where it is clear, 0 past MSG_SIZE.
+ */
+static constexpr std::array<float, 168> make_sync_pattern()
+{
+    std::array<float, 168> pattern{};
+    for (std::size_t i = 0; i < MSG_SIZE; ++i)
+    {
+        pattern[i] = WsprMessage::sync_vector[i] ? 1.0f : -1.0f;
+    }
+    return pattern;
+}
+
+alignas(32) const std::array<float, 168> WsprReceiver::sync_pattern = make_sync_pattern();
+
+/**
+ * @brief Splits per-tone powers into sync and data soft values.
+ *
+ * @param tone_power MSG_SIZE rows of four tone powers.
+ * @param sync_soft Sync soft values, or null.
+ * @param data_soft Data soft values in channel order, or null.
+ */
+void WsprReceiver::split_tones(const float *tone_power, float *sync_soft, float *data_soft) noexcept
+{
+    for (std::size_t i = 0; i < MSG_SIZE; ++i)
+    {
+        const float *p = tone_power + i * tones;
+        if (sync_soft)
+        {
+            sync_soft[i] = (p[1] + p[3]) - (p[0] + p[2]);
+        }
+        if (data_soft)
+        {
+            data_soft[i] = (p[2] + p[3]) - (p[0] + p[1]);
+        }
+    }
+}
+
+/**
+ * @brief Correlates one candidate's sync soft values with the sync vector.
+ *
+ * @param sync_soft MSG_SIZE sync soft values.
+ * @return The correlation score.
+ */
+float WsprReceiver::sync_correlation(const float *sync_soft) noexcept
+{
+    float score = 0.0f;
+    for (std::size_t i = 0; i < MSG_SIZE; ++i)
+    {
+        score += sync_soft[i] * sync_pattern[i];
+    }
+    return score;
+}
+
+/**
+ * @brief Scores offsets [first, last) one at a time.
+ *
+ * @param sync_soft Sync soft values.
+ * @param first First offset.
+ * @param last One past the last offset.
+ * @param scores Score per offset.
+ */
+static void search_scalar(const float *sync_soft, std::size_t first, std::size_t last, float *scores) noexcept
+{
+    for (std::size_t lag = first; lag < last; ++lag)
+    {
+        scores[lag] = WsprReceiver::sync_correlation(sync_soft + lag);
+    }
+}
+
+#if defined(WSPR_RECEIVE_X86)
+
+/**
+ * @brief Scores offsets with AVX2, 32 at a time, then eight at a time.
+ *
+ * Each lane accumulates one offset in symbol order, so the sums match the
+ * scalar path exactly. Four independent accumulators hide the add latency.
+ *
+ * @param sync_soft Sync soft values.
+ * @param lags Number of offsets.
+ * @param scores Score per offset.
+ * @return Number of offsets scored; the caller finishes the rest.
+ */
+__attribute__((target("avx2"))) static std::size_t search_avx2(const float *sync_soft, std::size_t lags, float *scores) noexcept
+{
+    const float *pattern = WsprReceiver::sync_pattern.data();
+    std::size_t lag = 0;
+
+    for (; lag + 32 <= lags; lag += 32)
+    {
+        const float *base = sync_soft + lag;
+        __m256 acc0 = _mm256_setzero_ps(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        for (std::size_t i = 0; i < MSG_SIZE; ++i)
+        {
+            const __m256 sign = _mm256_set1_ps(pattern[i]);
+            acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(base + i), sign));
+            acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(base + i + 8), sign));
+            acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(_mm256_loadu_ps(base + i + 16), sign));
+            acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(_mm256_loadu_ps(base + i + 24), sign));
+        }
+        _mm256_storeu_ps(scores + lag, acc0);
+        _mm256_storeu_ps(scores + lag + 8, acc1);
+        _mm256_storeu_ps(scores + lag + 16, acc2);
+        _mm256_storeu_ps(scores + lag + 24, acc3);
+    }
+
+    for (; lag + 8 <= lags; lag += 8)
+    {
+        const float *base = sync_soft + lag;
+        __m256 acc = _mm256_setzero_ps();
+        for (std::size_t i = 0; i < MSG_SIZE; ++i)
+        {
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(base + i), _mm256_set1_ps(pattern[i])));
+        }
+        _mm256_storeu_ps(scores + lag, acc);
+    }
+    return lag;
+}
+
+#endif // WSPR_RECEIVE_X86
+
+#if defined(WSPR_RECEIVE_NEON)
+
+/**
+ * @brief Scores offsets with NEON, 16 at a time, then four at a time.
+ *
+ * Each lane accumulates one offset in symbol order, so the sums match the
+ * scalar path exactly.
+ *
+ * @param sync_soft Sync soft values.
+ * @param lags Number of offsets.
+ * @param scores Score per offset.
+ * @return Number of offsets scored; the caller finishes the rest.
+ */
+static std::size_t search_neon(const float *sync_soft, std::size_t lags, float *scores) noexcept
+{
+    const float *pattern = WsprReceiver::sync_pattern.data();
+    std::size_t lag = 0;
+
+    for (; lag + 16 <= lags; lag += 16)
+    {
+        const float *base = sync_soft + lag;
+        float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        for (std::size_t i = 0; i < MSG_SIZE; ++i)
+        {
+            const float32x4_t sign = vdupq_n_f32(pattern[i]);
+            acc0 = vaddq_f32(acc0, vmulq_f32(vld1q_f32(base + i), sign));
+            acc1 = vaddq_f32(acc1, vmulq_f32(vld1q_f32(base + i + 4), sign));
+            acc2 = vaddq_f32(acc2, vmulq_f32(vld1q_f32(base + i + 8), sign));
+            acc3 = vaddq_f32(acc3, vmulq_f32(vld1q_f32(base + i + 12), sign));
+        }
+        vst1q_f32(scores + lag, acc0);
+        vst1q_f32(scores + lag + 4, acc1);
+        vst1q_f32(scores + lag + 8, acc2);
+        vst1q_f32(scores + lag + 12, acc3);
+    }
+
+    for (; lag + 4 <= lags; lag += 4)
+    {
+        const float *base = sync_soft + lag;
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (std::size_t i = 0; i < MSG_SIZE; ++i)
+        {
+            acc = vaddq_f32(acc, vmulq_f32(vld1q_f32(base + i), vdupq_n_f32(pattern[i])));
+        }
+        vst1q_f32(scores + lag, acc);
+    }
+    return lag;
+}
+
+#endif // WSPR_RECEIVE_NEON
+
+/**
+ * @brief Correlates the sync vector at every time offset in a window.
+ *
+ * @param sync_soft `lags + MSG_SIZE - 1` sync soft values.
+ * @param lags Number of offsets.
+ * @param scores Score per offset, or null.
+ * @param kernel Kernel to use.
+ * @return The offset with the highest score.
+ */
+std::size_t WsprReceiver::sync_search(const float *sync_soft, std::size_t lags, float *scores, WsprKernel kernel) noexcept
+{
+    if (lags == 0)
+    {
+        return 0;
+    }
+
+    // Score in blocks so a null `scores` needs no allocation
+    constexpr std::size_t block = 256;
+    float local[block];
+    std::size_t best = 0;
+    float best_score = 0.0f;
+    kernel = WsprSimd::resolve(kernel);
+
+    for (std::size_t first = 0; first < lags; first += block)
+    {
+        const std::size_t count = (lags - first < block) ? lags - first : block;
+        float *out = scores ? scores + first : local;
+        const float *in = sync_soft + first;
+
+        std::size_t done = 0;
+#if defined(WSPR_RECEIVE_X86)
+        if (kernel == WsprKernel::avx2)
+        {
+            done = search_avx2(in, count, out);
+        }
+#endif
+#if defined(WSPR_RECEIVE_NEON)
+        if (kernel == WsprKernel::neon)
+        {
+            done = search_neon(in, count, out);
+        }
+#endif
+        search_scalar(in, done, count, out);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if ((first + i) == 0 || out[i] > best_score)
+            {
+                best = first + i;
+                best_score = out[i];
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Reorders data soft values from channel order into encoder order.
+ *
+ * @param data_soft Data soft values in channel order.
+ * @param bits Soft values in encoder order.
+ */
+void WsprReceiver::deinterleave(const float *data_soft, float *bits) noexcept
+{
+    for (std::size_t k = 0; k < MSG_SIZE; ++k)
+    {
+        bits[k] = data_soft[WsprMessage::interleave_table[k]];
+    }
+}
+
+/**
+ * @brief Splits per-tone powers and deinterleaves the data in one pass.
+ *
+ * @param tone_power MSG_SIZE rows of four tone powers.
+ * @param sync_soft Sync soft values, or null.
+ * @param bits Data soft values in encoder order.
+ */
+void WsprReceiver::demodulate(const float *tone_power, float *sync_soft, float *bits) noexcept
+{
+    for (std::size_t i = 0; i < MSG_SIZE; ++i)
+    {
+        const float *p = tone_power + i * tones;
+        if (sync_soft)
+        {
+            sync_soft[i] = (p[1] + p[3]) - (p[0] + p[2]);
+        }
+        bits[WsprMessage::deinterleave_table[i]] = (p[2] + p[3]) - (p[0] + p[1]);
+    }
+}
+
+/**
+ * @brief Extracts the encoder output bits from hard symbols.
+ *
+ * @param symbols Channel symbols.
+ * @param bits Encoder output bits, in encoder order.
+ */
+void WsprReceiver::deinterleave(const uint8_t *symbols, uint8_t *bits) noexcept
+{
+    for (std::size_t k = 0; k < MSG_SIZE; ++k)
+    {
+        bits[k] = symbols[WsprMessage::interleave_table[k]] >> 1;
+    }
+}
+
+/**
+ * @brief Counts hard symbols whose sync bit disagrees with the sync vector.
+ *
+ * @param symbols Channel symbols.
+ * @return Number of mismatches.
+ */
+int WsprReceiver::sync_errors(const uint8_t *symbols) noexcept
+{
+    int errors = 0;
+    for (std::size_t i = 0; i < MSG_SIZE; ++i)
+    {
+        errors += (symbols[i] & 1) != WsprMessage::sync_vector[i];
+    }
+    return errors;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file wspr_receive.hpp
+ * @brief Receive-side helpers: tone splitting, sync correlation, and deinterleaving.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_RECEIVE_H
+#define WSPR_RECEIVE_H
+
+#include "wspr_message.hpp"
+#include "wspr_simd.hpp"
+
+#include <array>   // For: std::array
+#include <cstddef> // For: std::size_t
+#include <cstdint> // For: uint8_t
+
+/**
+ * @class WsprReceiver
+ * @brief The inverse of the transmit path, for decoders and skimmers.
+ *
+ * Each transmitted symbol is `sync + 2 * data`, so a receiver that has
+ * measured the power of all four tones for each symbol can split them into
+ * a sync soft value and a data soft value. The sync values are correlated
+ * against WsprMessage::sync_vector to find the time offset of a candidate.
+ * The data values are put back into encoder order through the same
+ * interleaver permutation the encoder uses, ready for a convolutional
+ * decoder.
+ *
+ * Soft values are signed. Positive means a 1 bit.
+ */
+class WsprReceiver
+{
+public:
+    /**
+     * @brief Number of FSK tones per symbol.
+     */
+    static constexpr std::size_t tones = 4;
+
+    /**
+     * @brief One soft value per symbol or per encoder output bit.
+     */
+    using SoftSymbols = std::array<float, MSG_SIZE>;
+
+    /**
+     * @brief Sync vector as +1 (sync bit set) and -1 (clear), padded to a multiple of eight with zeros.
+     */
+    static const std::array<float, 168> sync_pattern;
+
+    /**
+     * @brief Splits per-tone powers into sync and data soft values.
+     *
+     * @param tone_power MSG_SIZE rows of four tone powers, row-major.
+     * @param sync_soft Receives `(p1 + p3) - (p0 + p2)` per symbol. May be null.
+     * @param data_soft Receives `(p2 + p3) - (p0 + p1)` per symbol, in channel order. May be null.
+     */
+    static void split_tones(const float *tone_power, float *sync_soft, float *data_soft) noexcept;
+
+    /**
+     * @brief Correlates one candidate's sync soft values with the sync vector.
+     *
+     * @param sync_soft MSG_SIZE sync soft values.
+     * @return Sum of the values with the sign of each sync bit applied. An
+     *         ideal, noise-free signal scores MSG_SIZE times its amplitude.
+     */
+    static float sync_correlation(const float *sync_soft) noexcept;
+
+    /**
+     * @brief Correlates the sync vector at every time offset in a window.
+     *
+     * `scores[lag]` is sync_correlation(sync_soft + lag). SIMD kernels
+     * compute eight (AVX2) or four (NEON) offsets together. Every score
+     * is a running sum of the inputs with the sign of each sync bit
+     * applied, taken in symbol order. No kernel reorders that sum, so all
+     * kernels return identical scores.
+     *
+     * @param sync_soft `lags + MSG_SIZE - 1` sync soft values.
+     * @param lags Number of offsets to score.
+     * @param scores Destination for `lags` scores. May be null if only the
+     *        best offset is needed.
+     * @param kernel Kernel to use; WsprKernel::automatic picks the fastest.
+     * @return The offset with the highest score, or 0 when `lags` is 0.
+     */
+    static std::size_t sync_search(const float *sync_soft, std::size_t lags, float *scores,
+                                   WsprKernel kernel = WsprKernel::automatic) noexcept;
+
+    /**
+     * @brief Reorders data soft values from channel order into encoder order.
+     *
+     * `bits[k] = data_soft[WsprMessage::interleave_table[k]]`. The result is
+     * the soft form of the convolutional encoder's 162 output bits.
+     *
+     * @param data_soft MSG_SIZE data soft values in channel order.
+     * @param bits Destination for MSG_SIZE values in encoder order. Must not alias `data_soft`.
+     */
+    static void deinterleave(const float *data_soft, float *bits) noexcept;
+
+    /**
+     * @brief Splits per-tone powers and deinterleaves the data in one pass.
+     *
+     * This is the same as split_tones() followed by deinterleave(), without
+     * the intermediate buffer.
+     *
+     * @param tone_power MSG_SIZE rows of four tone powers, row-major.
+     * @param sync_soft Receives the sync soft values in channel order. May be null.
+     * @param bits Receives the data soft values in encoder order.
+     */
+    static void demodulate(const float *tone_power, float *sync_soft, float *bits) noexcept;
+
+    /**
+     * @brief Extracts the encoder output bits from hard symbols.
+     *
+     * @param symbols MSG_SIZE channel symbols (0-3).
+     * @param bits Destination for the MSG_SIZE encoder output bits (0 or 1), in encoder order.
+     */
+    static void deinterleave(const uint8_t *symbols, uint8_t *bits) noexcept;
+
+    /**
+     * @brief Counts hard symbols whose sync bit disagrees with the sync vector.
+     *
+     * @param symbols MSG_SIZE channel symbols (0-3).
+     * @return Number of mismatched sync bits, 0 for a clean signal.
+     */
+    static int sync_errors(const uint8_t *symbols) noexcept;
+};
+
+#endif // WSPR_RECEIVE_H
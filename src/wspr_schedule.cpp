@@ -0,0 +1,454 @@
+/**
+ * @file wspr_schedule.cpp
+ * @brief Pre-encoded transmission schedule with a lock-free slot queue.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_schedule.hpp"
+
+#include <utility> // For: std::move
+
+namespace
+{
+    /**
+     * @brief Returns `value` modulo `divisor`, in [0, divisor) for negative values too.
+     *
+     * @param value The dividend.
+     * @param divisor A positive divisor.
+     * @return The non-negative remainder.
+     */
+    std::size_t wrap(int64_t value, std::size_t divisor) noexcept
+    {
+        const int64_t d = static_cast<int64_t>(divisor);
+        const int64_t r = value % d;
+        return static_cast<std::size_t>(r < 0 ? r + d : r);
+    }
+
+    /**
+     * @brief Returns `value / divisor` rounded toward negative infinity.
+     *
+     * @param value The dividend.
+     * @param divisor A positive divisor.
+     * @return The floored quotient.
+     */
+    int64_t floor_div(int64_t value, int64_t divisor) noexcept
+    {
+        const int64_t q = value / divisor;
+        return (value % divisor < 0) ? q - 1 : q;
+    }
+}
+
+/**
+ * @brief Adds a message to the rotation.
+ *
+ * @param callsign Standard or compound callsign.
+ * @param location 4- or 6-character locator.
+ * @param power Power level in dBm.
+ * @return WsprStatus::ok, or the first invalid field.
+ */
+WsprStatus WsprSchedulePlan::add_message(std::string_view callsign, std::string_view location, int power)
+{
+    WsprMessageSequence check;
+    const WsprStatus result = check.set(callsign, location, power);
+    if (result == WsprStatus::ok)
+    {
+        messages_.push_back(Message{std::string(callsign), std::string(location), power});
+        prepared_ = false;
+    }
+    return result;
+}
+
+/**
+ * @brief Sets the power levels to step through.
+ *
+ * @param powers Power levels in dBm, or empty.
+ */
+void WsprSchedulePlan::set_power_steps(std::vector<int> powers)
+{
+    powers_ = std::move(powers);
+    prepared_ = false;
+}
+
+/**
+ * @brief Sets the bands to hop across.
+ *
+ * @param centers_hz Band center frequencies, or empty.
+ */
+void WsprSchedulePlan::set_bands(std::vector<double> centers_hz)
+{
+    bands_ = std::move(centers_hz);
+    prepared_ = false;
+}
+
+/**
+ * @brief Sets the hardware tuning model.
+ *
+ * @param model The frequency-setting model.
+ */
+void WsprSchedulePlan::set_tuning(const WsprTuningModel &model)
+{
+    tuning_ = model;
+    has_tuning_ = true;
+    prepared_ = false;
+}
+
+/**
+ * @brief Encodes every message and tone table the plan can use.
+ *
+ * @return WsprStatus::ok, or the reason the plan cannot be used.
+ */
+WsprStatus WsprSchedulePlan::prepare()
+{
+    prepared_ = false;
+    rotation_.clear();
+    encoded_.clear();
+    tables_.clear();
+
+    if (messages_.empty())
+    {
+        return WsprStatus::invalid_callsign;
+    }
+
+    const std::size_t steps = powers_.empty() ? 1 : powers_.size();
+    encoded_.resize(steps * messages_.size());
+    for (std::size_t step = 0; step < steps; ++step)
+    {
+        for (std::size_t m = 0; m < messages_.size(); ++m)
+        {
+            const Message &message = messages_[m];
+            const int power = powers_.empty() ? message.power : powers_[step];
+            const WsprStatus result = encoded_[step * messages_.size() + m].set(message.callsign, message.location, power);
+            if (result != WsprStatus::ok)
+            {
+                encoded_.clear();
+                return result;
+            }
+        }
+    }
+
+    // The number of transmissions per message does not depend on the power
+    for (std::size_t m = 0; m < messages_.size(); ++m)
+    {
+        for (std::size_t part = 0; part < encoded_[m].count(); ++part)
+        {
+            rotation_.push_back(Place{m, part});
+        }
+    }
+
+    if (has_tuning_)
+    {
+        const std::size_t bands = bands_.empty() ? 1 : bands_.size();
+        tables_.resize(bands);
+        for (std::size_t b = 0; b < bands; ++b)
+        {
+            const double center = bands_.empty() ? 0.0 : bands_[b];
+            if (!WsprToneWords::make_tone_table(WsprToneWords::base_from_center(center), tuning_, tables_[b]))
+            {
+                rotation_.clear();
+                encoded_.clear();
+                tables_.clear();
+                return WsprStatus::invalid_frequency;
+            }
+        }
+    }
+
+    prepared_ = true;
+    return WsprStatus::ok;
+}
+
+/**
+ * @brief Fills a slot from the prepared tables.
+ *
+ * @param index Slot number.
+ * @param slot Destination.
+ */
+void WsprSchedulePlan::slot(int64_t index, WsprSlot &slot) const noexcept
+{
+    const std::size_t transmissions = rotation_.size();
+    const Place &place = rotation_[wrap(index, transmissions)];
+    const int64_t round = floor_div(index, static_cast<int64_t>(transmissions));
+    const std::size_t step = powers_.empty() ? 0 : wrap(round, powers_.size());
+    // The band advances once per full cycle of power steps, so every pair occurs
+    const int64_t cycle = powers_.empty() ? round : floor_div(round, static_cast<int64_t>(powers_.size()));
+    const std::size_t band = bands_.empty() ? 0 : wrap(cycle, bands_.size());
+    const WsprMessageSequence &sequence = encoded_[step * messages_.size() + place.message];
+
+    slot.index = index;
+    slot.message = place.message;
+    slot.band = band;
+    slot.frequency_hz = bands_.empty() ? 0.0 : bands_[band];
+    slot.power = powers_.empty() ? messages_[place.message].power : powers_[step];
+    slot.type = sequence.type(place.part);
+    slot.symbols = sequence.symbols(place.part);
+    slot.has_words = has_tuning_;
+    if (has_tuning_)
+    {
+        WsprToneWords::map(slot.symbols.data(), tables_[band], slot.words.data());
+    }
+}
+
+/**
+ * @brief Creates a ring.
+ *
+ * @param capacity Minimum number of slots.
+ */
+WsprSlotRing::WsprSlotRing(std::size_t capacity)
+{
+    std::size_t cells = 2;
+    while (cells < capacity)
+    {
+        cells <<= 1;
+    }
+    cells_.resize(cells);
+    mask_ = cells - 1;
+}
+
+/**
+ * @brief Returns the next free cell, or null if the ring is full.
+ *
+ * @return Cell to fill.
+ */
+WsprSlot *WsprSlotRing::reserve() noexcept
+{
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == cells_.size())
+    {
+        return nullptr;
+    }
+    return &cells_[tail & mask_];
+}
+
+/**
+ * @brief Publishes the reserved cell.
+ */
+void WsprSlotRing::publish() noexcept
+{
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Returns the oldest published slot, or null if empty.
+ *
+ * @return The slot.
+ */
+const WsprSlot *WsprSlotRing::front() const noexcept
+{
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+    return &cells_[head & mask_];
+}
+
+/**
+ * @brief Releases the front slot.
+ */
+void WsprSlotRing::pop() noexcept
+{
+    head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Returns the number of published, unreleased slots.
+ *
+ * @return Slot count.
+ */
+std::size_t WsprSlotRing::size() const noexcept
+{
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Creates a scheduler over a plan.
+ *
+ * @param plan The plan; copied and prepared if needed.
+ * @param depth Slots to keep encoded ahead.
+ */
+WsprScheduler::WsprScheduler(const WsprSchedulePlan &plan, std::size_t depth)
+    : plan_(plan),
+      status_(plan_.prepared() ? WsprStatus::ok : plan_.prepare()),
+      ring_(depth)
+{
+}
+
+/**
+ * @brief Stops the background thread.
+ */
+WsprScheduler::~WsprScheduler()
+{
+    stop();
+}
+
+/**
+ * @brief Fills the ring; producer side only.
+ *
+ * @param not_before Earliest slot worth encoding.
+ * @return Number of slots encoded.
+ */
+std::size_t WsprScheduler::fill(int64_t not_before)
+{
+    if (status_ != WsprStatus::ok)
+    {
+        return 0;
+    }
+    if (!started_ || next_ < not_before)
+    {
+        next_ = not_before;
+        started_ = true;
+    }
+
+    std::size_t filled = 0;
+    while (WsprSlot *cell = ring_.reserve())
+    {
+        plan_.slot(next_++, *cell);
+        ring_.publish();
+        ++filled;
+    }
+    produced_.fetch_add(filled, std::memory_order_relaxed);
+    return filled;
+}
+
+/**
+ * @brief Starts the background producer.
+ *
+ * @param poll Interval between fills.
+ * @return False if the plan is invalid or the thread is running.
+ */
+bool WsprScheduler::start(std::chrono::milliseconds poll)
+{
+    if (status_ != WsprStatus::ok || thread_.joinable())
+    {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+    }
+    thread_ = std::thread(&WsprScheduler::run, this, poll);
+    return true;
+}
+
+/**
+ * @brief Stops and joins the background producer.
+ */
+void WsprScheduler::stop()
+{
+    if (!thread_.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+}
+
+/**
+ * @brief Returns the slot for `index`; RF thread only.
+ *
+ * @param index The slot about to start.
+ * @return The slot, or null.
+ */
+const WsprSlot *WsprScheduler::acquire(int64_t index) noexcept
+{
+    const WsprSlot *slot = ring_.front();
+    while (slot != nullptr && slot->index < index)
+    {
+        ring_.pop();
+        skipped_.fetch_add(1, std::memory_order_relaxed);
+        slot = ring_.front();
+    }
+    if (slot == nullptr)
+    {
+        missed_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return slot->index == index ? slot : nullptr;
+}
+
+/**
+ * @brief Releases the acquired slot; RF thread only.
+ */
+void WsprScheduler::release() noexcept
+{
+    ring_.pop();
+    consumed_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the queue counters.
+ *
+ * @return A snapshot.
+ */
+WsprScheduler::Stats WsprScheduler::stats() const noexcept
+{
+    Stats snapshot;
+    snapshot.produced = produced_.load(std::memory_order_relaxed);
+    snapshot.consumed = consumed_.load(std::memory_order_relaxed);
+    snapshot.skipped = skipped_.load(std::memory_order_relaxed);
+    snapshot.missed = missed_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+/**
+ * @brief Returns the slot number containing a time.
+ *
+ * @param time A wall-clock time.
+ * @return The slot number.
+ */
+int64_t WsprScheduler::slot_index(std::chrono::system_clock::time_point time) noexcept
+{
+    const int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+    return floor_div(seconds, 120);
+}
+
+/**
+ * @brief Returns the start time of a slot.
+ *
+ * @param index Slot number.
+ * @return The slot's start time.
+ */
+std::chrono::system_clock::time_point WsprScheduler::slot_start(int64_t index) noexcept
+{
+    return std::chrono::system_clock::time_point(std::chrono::seconds(index * 120));
+}
+
+/**
+ * @brief Background producer loop.
+ *
+ * @param poll Interval between fills.
+ */
+void WsprScheduler::run(std::chrono::milliseconds poll)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        lock.unlock();
+        fill(slot_index(std::chrono::system_clock::now()));
+        lock.lock();
+        wake_.wait_for(lock, poll, [this]() { return stopping_; });
+    }
+}
@@ -0,0 +1,386 @@
+/**
+ * @file wspr_schedule.hpp
+ * @brief Pre-encoded transmission schedule with a lock-free slot queue.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_SCHEDULE_H
+#define WSPR_SCHEDULE_H
+
+#include "wspr_message.hpp"
+#include "wspr_sequence.hpp"
+#include "wspr_tones.hpp"
+
+#include <atomic>             // For: std::atomic
+#include <chrono>             // For: std::chrono::system_clock
+#include <condition_variable> // For: std::condition_variable
+#include <cstddef>            // For: std::size_t
+#include <cstdint>            // For: int64_t, uint64_t
+#include <mutex>              // For: std::mutex
+#include <string>             // For: std::string
+#include <thread>             // For: std::thread
+#include <vector>             // For: std::vector
+
+/**
+ * @brief One fully prepared transmission.
+ */
+struct WsprSlot
+{
+    int64_t index = 0;                ///< Slot number: seconds since the Unix epoch divided by 120.
+    std::size_t message = 0;          ///< Position of the message in the plan.
+    std::size_t band = 0;             ///< Position of the band in the plan.
+    double frequency_hz = 0;          ///< Center frequency of the transmission.
+    int power = 0;                    ///< Reported power level in dBm.
+    WsprMessageType type = WsprMessageType::type1; ///< Format of this transmission.
+    WsprMessage::Symbols symbols{};   ///< Channel symbols.
+    bool has_words = false;           ///< True when a tuning model is set and `words` is filled.
+    WsprToneWords::Words words{};     ///< One tuning word per symbol, ready for DMA.
+};
+
+/**
+ * @class WsprSchedulePlan
+ * @brief Describes what to send in every slot and pre-encodes all of it.
+ *
+ * A plan rotates through its messages, steps through a list of power
+ * levels, and hops across a list of bands. Messages that need two
+ * transmissions (compound callsigns and 6-character locators, see
+ * WsprMessageSequence) occupy two consecutive places in the rotation. For
+ * slot `n`:
+ *
+ * - the transmission is `n % T`, where T is the total number of
+ *   transmissions in one rotation;
+ * - the power step is `(n / T) % P`, so each rotation uses the next step;
+ * - the band is `(n / (T * P)) % B`, so a whole rotation, including both
+ *   halves of a two-part message, goes out on one band, and the band moves
+ *   on after every power step has been used once. Every message is sent at
+ *   every (power, band) pair once per T * P * B slots.
+ *
+ * Division rounds toward negative infinity, and P counts as 1 when no
+ * power steps are set.
+ *
+ * The content follows from the slot number alone, so a restarted daemon
+ * picks up the same rotation. prepare() encodes every message at every power
+ * step and builds the tone table for every band, so slot() only copies.
+ */
+class WsprSchedulePlan
+{
+public:
+    /**
+     * @brief Adds a message to the rotation.
+     *
+     * @param callsign Standard or compound callsign (either case).
+     * @param location 4- or 6-character locator (either case); 6 characters
+     *                 for a compound callsign.
+     * @param power Power level in dBm, used when no power steps are set.
+     * @return WsprStatus::ok, or the first invalid field; the message is not added on failure.
+     */
+    WsprStatus add_message(std::string_view callsign, std::string_view location, int power);
+
+    /**
+     * @brief Sets the power levels to step through, one per rotation.
+     *
+     * @param powers Power levels in dBm; empty to use each message's own power.
+     */
+    void set_power_steps(std::vector<int> powers);
+
+    /**
+     * @brief Sets the bands to hop across, one per rotation.
+     *
+     * @param centers_hz Center frequency of each band's transmissions, such
+     *        as the dial frequency plus 1500 Hz. Empty means a single band at 0 Hz.
+     */
+    void set_bands(std::vector<double> centers_hz);
+
+    /**
+     * @brief Sets the hardware tuning model so slots carry tuning words.
+     *
+     * @param model The transmitter's frequency-setting model.
+     */
+    void set_tuning(const WsprTuningModel &model);
+
+    /**
+     * @brief Encodes every message and tone table the plan can use.
+     *
+     * @return WsprStatus::ok. WsprStatus::invalid_callsign if no messages
+     *         were added, WsprStatus::invalid_power if a power step is not
+     *         a WSPR level, or WsprStatus::invalid_frequency if a band
+     *         cannot be produced by the tuning model.
+     */
+    WsprStatus prepare();
+
+    /**
+     * @brief Returns true once prepare() has succeeded and nothing has changed since.
+     *
+     * @return Whether slot() may be called.
+     */
+    bool prepared() const noexcept { return prepared_; }
+
+    /**
+     * @brief Returns the number of transmissions in one message rotation.
+     *
+     * @return T in the slot formula; 0 before prepare().
+     */
+    std::size_t rotation() const noexcept { return rotation_.size(); }
+
+    /**
+     * @brief Fills a slot from the prepared tables.
+     *
+     * @param index Slot number.
+     * @param slot Destination.
+     *
+     * @note Only call after prepare() has returned WsprStatus::ok.
+     */
+    void slot(int64_t index, WsprSlot &slot) const noexcept;
+
+private:
+    /**
+     * @brief A message as added.
+     */
+    struct Message
+    {
+        std::string callsign;
+        std::string location;
+        int power;
+    };
+
+    /**
+     * @brief One place in the rotation: a message and which of its transmissions.
+     */
+    struct Place
+    {
+        std::size_t message;
+        std::size_t part;
+    };
+
+    std::vector<Message> messages_;                  ///< Messages in rotation order.
+    std::vector<int> powers_;                        ///< Power steps, or empty.
+    std::vector<double> bands_;                      ///< Band centers, or empty.
+    bool has_tuning_ = false;                        ///< Whether `tuning_` is set.
+    WsprTuningModel tuning_{};                       ///< Hardware model for tuning words.
+
+    bool prepared_ = false;                          ///< Tables below are current.
+    std::vector<Place> rotation_;                    ///< Transmissions in one rotation.
+    std::vector<WsprMessageSequence> encoded_;       ///< [step * messages + message].
+    std::vector<WsprToneWords::ToneTable> tables_;   ///< Tone table per band.
+};
+
+/**
+ * @class WsprSlotRing
+ * @brief Single-producer, single-consumer ring of prepared slots.
+ *
+ * Slots are stored in place. Neither side copies a slot: the producer
+ * fills the next free cell and publishes it, and the consumer reads it
+ * through a pointer until it releases it. Each side owns one index, and
+ * the two indexes sit on separate cache lines. Only acquire and release
+ * atomic operations are used, with no locks and no allocation after construction.
+ */
+class WsprSlotRing
+{
+public:
+    /**
+     * @brief Creates a ring.
+     *
+     * @param capacity Minimum number of slots; rounded up to a power of two, at least 2.
+     */
+    explicit WsprSlotRing(std::size_t capacity);
+
+    /**
+     * @brief Returns the next free cell for the producer, or null if the ring is full.
+     *
+     * @return Cell to fill, valid until publish().
+     */
+    WsprSlot *reserve() noexcept;
+
+    /**
+     * @brief Publishes the cell returned by reserve().
+     */
+    void publish() noexcept;
+
+    /**
+     * @brief Returns the oldest published slot for the consumer, or null if empty.
+     *
+     * @return The slot, valid until pop().
+     */
+    const WsprSlot *front() const noexcept;
+
+    /**
+     * @brief Releases the slot returned by front() back to the producer.
+     */
+    void pop() noexcept;
+
+    /**
+     * @brief Returns the number of published, unreleased slots.
+     *
+     * @return Approximate when called while the other side is running.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Returns the number of cells.
+     *
+     * @return The capacity.
+     */
+    std::size_t capacity() const noexcept { return cells_.size(); }
+
+private:
+    std::vector<WsprSlot> cells_;                 ///< Slot storage.
+    std::size_t mask_;                            ///< capacity - 1.
+    alignas(64) std::atomic<std::size_t> head_{0}; ///< Next cell to consume; written by the consumer.
+    alignas(64) std::atomic<std::size_t> tail_{0}; ///< Next cell to fill; written by the producer.
+};
+
+/**
+ * @class WsprScheduler
+ * @brief Keeps the next few slots encoded ahead of time for an RF thread.
+ *
+ * A producer, either the scheduler's own background thread or a caller of
+ * fill(), encodes upcoming slots from a WsprSchedulePlan into a
+ * WsprSlotRing. At each slot boundary the RF thread calls acquire() with
+ * the new slot number and gets a pointer to symbols (and tuning words)
+ * that are already computed. It calls release() when the transmission
+ * ends. acquire() and release() never lock, allocate, or encode.
+ */
+class WsprScheduler
+{
+public:
+    /**
+     * @brief Counters for monitoring the queue.
+     */
+    struct Stats
+    {
+        uint64_t produced = 0; ///< Slots encoded into the ring.
+        uint64_t consumed = 0; ///< Slots released by the RF thread.
+        uint64_t skipped = 0;  ///< Slots dropped because their time had passed.
+        uint64_t missed = 0;   ///< acquire() calls that found the ring empty.
+    };
+
+    /**
+     * @brief Creates a scheduler over a prepared plan.
+     *
+     * @param plan The plan to follow; copied, and prepared if it is not already.
+     * @param depth Number of slots to keep encoded ahead.
+     */
+    explicit WsprScheduler(const WsprSchedulePlan &plan, std::size_t depth = 4);
+
+    /**
+     * @brief Stops the background thread if it is running.
+     */
+    ~WsprScheduler();
+
+    WsprScheduler(const WsprScheduler &) = delete;
+    WsprScheduler &operator=(const WsprScheduler &) = delete;
+
+    /**
+     * @brief Returns the result of preparing the plan.
+     *
+     * @return WsprStatus::ok if the scheduler can run.
+     */
+    WsprStatus status() const noexcept { return status_; }
+
+    /**
+     * @brief Fills the ring starting at a slot; call from the producer side only.
+     *
+     * @param not_before Earliest slot worth encoding. Production jumps
+     *        forward to it if it has fallen behind.
+     * @return Number of slots encoded.
+     */
+    std::size_t fill(int64_t not_before);
+
+    /**
+     * @brief Starts a background thread that keeps the ring full.
+     *
+     * @param poll How often the thread checks for free cells.
+     * @return False if the plan is invalid or the thread is already running.
+     */
+    bool start(std::chrono::milliseconds poll = std::chrono::milliseconds(250));
+
+    /**
+     * @brief Stops and joins the background thread.
+     */
+    void stop();
+
+    /**
+     * @brief Returns the prepared slot for `index`; RF thread only.
+     *
+     * Slots older than `index` are dropped. Returns null if the ring is
+     * empty or the next slot is later than `index`.
+     *
+     * @param index The slot about to start.
+     * @return The slot, valid until release().
+     */
+    const WsprSlot *acquire(int64_t index) noexcept;
+
+    /**
+     * @brief Releases the slot returned by acquire(); RF thread only.
+     */
+    void release() noexcept;
+
+    /**
+     * @brief Returns the queue counters.
+     *
+     * @return A snapshot.
+     */
+    Stats stats() const noexcept;
+
+    /**
+     * @brief Returns the slot number containing a time.
+     *
+     * @param time A wall-clock time.
+     * @return Seconds since the Unix epoch divided by 120, rounded down.
+     */
+    static int64_t slot_index(std::chrono::system_clock::time_point time) noexcept;
+
+    /**
+     * @brief Returns the start time of a slot, on an even UTC minute.
+     *
+     * @param index Slot number.
+     * @return The slot's start time.
+     */
+    static std::chrono::system_clock::time_point slot_start(int64_t index) noexcept;
+
+private:
+    /**
+     * @brief Background thread body.
+     *
+     * @param poll Interval between fills.
+     */
+    void run(std::chrono::milliseconds poll);
+
+    WsprSchedulePlan plan_;                ///< Prepared copy of the plan.
+    WsprStatus status_;                    ///< Result of preparing the plan.
+    WsprSlotRing ring_;                    ///< Prepared slots.
+    int64_t next_ = 0;                     ///< Next slot to produce; producer side only.
+    bool started_ = false;                 ///< Whether `next_` has been seeded.
+
+    std::atomic<uint64_t> produced_{0};    ///< See Stats::produced.
+    std::atomic<uint64_t> consumed_{0};    ///< See Stats::consumed.
+    std::atomic<uint64_t> skipped_{0};     ///< See Stats::skipped.
+    std::atomic<uint64_t> missed_{0};      ///< See Stats::missed.
+
+    std::thread thread_;                   ///< Background producer, if started.
+    std::mutex mutex_;                     ///< Guards `stopping_` for the producer's wait.
+    std::condition_variable wake_;         ///< Wakes the producer early to stop.
+    bool stopping_ = false;                ///< Set by stop().
+};
+
+#endif // WSPR_SCHEDULE_H
@@ -0,0 +1,285 @@
+/**
+ * @file wspr_sequence.cpp
+ * @brief Precomputed Type 1/2/3 WSPR message sequences and callsign hash tables.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_sequence.hpp"
+
+/**
+ * @brief Adds a callsign to the table.
+ *
+ * @param callsign A standard or compound callsign (either case).
+ * @return The callsign's 15-bit hash.
+ *
+ * @note Adding a callsign that is already present returns its existing hash.
+ */
+uint16_t WsprCallsignTable::add(std::string_view callsign)
+{
+    std::string key = normalize(callsign);
+    auto found = hashes_.find(key);
+    if (found != hashes_.end())
+    {
+        return found->second;
+    }
+
+    const uint16_t hash = WsprMessage::callsign_hash(key);
+    hashes_.emplace(key, hash);
+    callsigns_.emplace(hash, key);
+    order_.push_back(std::move(key));
+    return hash;
+}
+
+/**
+ * @brief Looks up the precomputed hash of a callsign.
+ *
+ * @param callsign The callsign to look up (either case).
+ * @param hash Receives the hash if the callsign is in the table.
+ * @return True if the callsign was found.
+ */
+bool WsprCallsignTable::find_hash(std::string_view callsign, uint16_t &hash) const
+{
+    auto found = hashes_.find(normalize(callsign));
+    if (found == hashes_.end())
+    {
+        return false;
+    }
+    hash = found->second;
+    return true;
+}
+
+/**
+ * @brief Resolves a hash back to the callsigns that produce it.
+ *
+ * @param hash A 15-bit callsign hash.
+ * @return The matching callsigns in insertion order; usually zero or one.
+ */
+std::vector<std::string> WsprCallsignTable::lookup(uint16_t hash) const
+{
+    std::vector<std::string> matches;
+    if (callsigns_.count(hash) == 0)
+    {
+        return matches;
+    }
+
+    for (const std::string &callsign : order_)
+    {
+        if (hashes_.at(callsign) == hash)
+        {
+            matches.push_back(callsign);
+        }
+    }
+    return matches;
+}
+
+/**
+ * @brief Returns the number of callsigns in the table.
+ *
+ * @return Number of distinct callsigns added.
+ */
+std::size_t WsprCallsignTable::size() const noexcept
+{
+    return order_.size();
+}
+
+/**
+ * @brief Uppercases a callsign for use as a table key.
+ *
+ * @param callsign The callsign in either case.
+ * @return The uppercased callsign.
+ */
+std::string WsprCallsignTable::normalize(std::string_view callsign)
+{
+    std::string key(callsign);
+    for (char &ch : key)
+    {
+        if (ch >= 'a' && ch <= 'z')
+        {
+            ch = static_cast<char>(ch - 'a' + 'A');
+        }
+    }
+    return key;
+}
+
+/**
+ * @brief Plans and encodes the sequence for a station.
+ *
+ * @param callsign Standard or compound callsign (either case).
+ * @param location 4- or 6-character Maidenhead locator (either case);
+ *                 6 characters for a compound callsign.
+ * @param power Transmission power level in dBm.
+ * @return WsprStatus::ok, or the first field found to be invalid.
+ */
+WsprStatus WsprMessageSequence::set(std::string_view callsign, std::string_view location, int power) noexcept
+{
+    return plan(callsign, location, power, WsprMessage::callsign_hash(callsign));
+}
+
+/**
+ * @brief Plans and encodes the sequence, taking the Type 3 hash from a table.
+ *
+ * @param callsign Standard or compound callsign (either case).
+ * @param location 4- or 6-character Maidenhead locator (either case);
+ *                 6 characters for a compound callsign.
+ * @param power Transmission power level in dBm.
+ * @param table Precomputed hashes.
+ * @return WsprStatus::ok, or the first field found to be invalid.
+ */
+WsprStatus WsprMessageSequence::set(std::string_view callsign, std::string_view location, int power, const WsprCallsignTable &table) noexcept
+{
+    uint16_t hash = 0;
+    bool found = false;
+#if WSPR_EXCEPTIONS
+    try
+    {
+        found = table.find_hash(callsign, hash);
+    }
+    catch (...)
+    {
+        found = false; // Key normalization could not allocate; hash directly
+    }
+#else
+    found = table.find_hash(callsign, hash);
+#endif
+    return plan(callsign, location, power, found ? hash : WsprMessage::callsign_hash(callsign));
+}
+
+/**
+ * @brief Returns the number of messages in the sequence.
+ *
+ * @return 0 if unset, otherwise 1 or 2.
+ */
+std::size_t WsprMessageSequence::count() const noexcept
+{
+    return count_;
+}
+
+/**
+ * @brief Returns the format of a message in the sequence.
+ *
+ * @param index Position in the sequence, less than count().
+ * @return The message type.
+ */
+WsprMessageType WsprMessageSequence::type(std::size_t index) const noexcept
+{
+    return types_[index];
+}
+
+/**
+ * @brief Returns the payload of a message in the sequence.
+ *
+ * @param index Position in the sequence, less than count().
+ * @return The packed payload.
+ */
+const WsprPayload &WsprMessageSequence::payload(std::size_t index) const noexcept
+{
+    return payloads_[index];
+}
+
+/**
+ * @brief Returns the encoded symbols of a message in the sequence.
+ *
+ * @param index Position in the sequence, less than count().
+ * @return The encoded symbols.
+ */
+const WsprMessage::Symbols &WsprMessageSequence::symbols(std::size_t index) const noexcept
+{
+    return symbols_[index];
+}
+
+/**
+ * @brief Returns the symbols to send in a given transmit slot.
+ *
+ * @param slot Running slot number; messages alternate by slot.
+ * @return The encoded symbols for that slot.
+ */
+const WsprMessage::Symbols &WsprMessageSequence::for_slot(std::size_t slot) const noexcept
+{
+    return symbols_[slot % count_];
+}
+
+/**
+ * @brief Plans the payloads and encodes them.
+ *
+ * @param callsign Standard or compound callsign.
+ * @param location 4- or 6-character locator; 6 characters for a compound callsign.
+ * @param power Power level in dBm.
+ * @param hash The callsign's 15-bit hash.
+ * @return WsprStatus::ok, or the validation failure.
+ */
+WsprStatus WsprMessageSequence::plan(std::string_view callsign, std::string_view location, int power, uint16_t hash) noexcept
+{
+    count_ = 0;
+
+    if (location.length() != 4 && location.length() != 6)
+    {
+        return WsprStatus::invalid_locator;
+    }
+
+    // A Type 2 message has no locator field, so a compound callsign needs the
+    // 6-character locator that its Type 3 message carries
+    const bool compound = WsprMessage::is_compound_callsign(callsign);
+    if (compound && location.length() != 6)
+    {
+        return WsprStatus::invalid_locator;
+    }
+
+    std::size_t count = 0;
+    WsprStatus result = WsprStatus::ok;
+
+    // First message: Type 2 for a compound callsign, otherwise Type 1
+    if (compound)
+    {
+        result = WsprMessage::pack_type2(callsign, power, payloads_[count]);
+        types_[count] = WsprMessageType::type2;
+    }
+    else
+    {
+        result = WsprMessage::pack(callsign, location.substr(0, 4), power, payloads_[count]);
+        types_[count] = WsprMessageType::type1;
+    }
+    if (result != WsprStatus::ok)
+    {
+        return result;
+    }
+    ++count;
+
+    // Second message: Type 3 carries the full 6-character locator
+    if (location.length() == 6)
+    {
+        result = WsprMessage::pack_type3(hash, location, power, payloads_[count]);
+        if (result != WsprStatus::ok)
+        {
+            return result;
+        }
+        types_[count] = WsprMessageType::type3;
+        ++count;
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        WsprMessage::encode_payload(payloads_[i], symbols_[i].data());
+    }
+    count_ = count;
+    return WsprStatus::ok;
+}
@@ -0,0 +1,201 @@
+/**
+ * @file wspr_sequence.hpp
+ * @brief Precomputed Type 1/2/3 WSPR message sequences and callsign hash tables.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_SEQUENCE_H
+#define WSPR_SEQUENCE_H
+
+#include "wspr_message.hpp"
+
+#include <array>         // For: std::array
+#include <cstddef>       // For: std::size_t
+#include <cstdint>       // For: uint16_t
+#include <string>        // For: std::string
+#include <string_view>   // For: std::string_view
+#include <unordered_map> // For: std::unordered_map
+#include <vector>        // For: std::vector
+
+/**
+ * @class WsprCallsignTable
+ * @brief Precomputed 15-bit callsign hashes for a known station list.
+ *
+ * Hashes are computed once when callsigns are added. Transmitters can then
+ * pack Type 3 messages without rehashing, and receivers can resolve the
+ * hash in a decoded Type 3 message back to a callsign.
+ */
+class WsprCallsignTable
+{
+public:
+    /**
+     * @brief Adds a callsign to the table.
+     *
+     * @param callsign A standard or compound callsign (either case).
+     * @return The callsign's 15-bit hash.
+     */
+    uint16_t add(std::string_view callsign);
+
+    /**
+     * @brief Looks up the precomputed hash of a callsign.
+     *
+     * @param callsign The callsign to look up (either case).
+     * @param hash Receives the hash if the callsign is in the table.
+     * @return True if the callsign was found.
+     */
+    bool find_hash(std::string_view callsign, uint16_t &hash) const;
+
+    /**
+     * @brief Resolves a hash back to the callsigns that produce it.
+     *
+     * @param hash A 15-bit callsign hash.
+     * @return The matching callsigns in insertion order; usually zero or one.
+     */
+    std::vector<std::string> lookup(uint16_t hash) const;
+
+    /**
+     * @brief Returns the number of callsigns in the table.
+     *
+     * @return Number of distinct callsigns added.
+     */
+    std::size_t size() const noexcept;
+
+private:
+    /**
+     * @brief Uppercases a callsign for use as a table key.
+     *
+     * @param callsign The callsign in either case.
+     * @return The uppercased callsign.
+     */
+    static std::string normalize(std::string_view callsign);
+
+    std::unordered_map<std::string, uint16_t> hashes_;            ///< Callsign to hash.
+    std::unordered_multimap<uint16_t, std::string> callsigns_;    ///< Hash to callsign(s).
+    std::vector<std::string> order_;                              ///< Callsigns in insertion order.
+};
+
+/**
+ * @class WsprMessageSequence
+ * @brief Plans and pre-encodes the messages a station transmits in rotation.
+ *
+ * A standard callsign with a 4-character locator needs a single Type 1
+ * message. A 6-character locator adds a Type 3 message after it. A compound
+ * callsign is sent as Type 2 followed by Type 3. Type 2 has no locator
+ * field, so a compound callsign requires a 6-character locator and is
+ * rejected with WsprStatus::invalid_locator otherwise. Every message in the sequence is encoded when the sequence is
+ * set, so picking the symbols for a slot is just an array index, the same
+ * per-slot cost as a single Type 1 message.
+ */
+class WsprMessageSequence
+{
+public:
+    /**
+     * @brief Maximum number of messages in a sequence.
+     */
+    static constexpr std::size_t max_messages = 2;
+
+    /**
+     * @brief Plans and encodes the sequence for a station.
+     *
+     * @param callsign Standard or compound callsign (either case).
+     * @param location 4- or 6-character Maidenhead locator (either case);
+     *                 6 characters for a compound callsign.
+     * @param power Transmission power level in dBm.
+     * @return WsprStatus::ok, or the first field found to be invalid. On
+     *         failure the sequence is left empty.
+     */
+    WsprStatus set(std::string_view callsign, std::string_view location, int power) noexcept;
+
+    /**
+     * @brief Plans and encodes the sequence, taking the Type 3 hash from a table.
+     *
+     * @param callsign Standard or compound callsign (either case).
+     * @param location 4- or 6-character Maidenhead locator (either case);
+     *                 6 characters for a compound callsign.
+     * @param power Transmission power level in dBm.
+     * @param table Precomputed hashes; the hash is computed directly if
+     *              the callsign is not in the table.
+     * @return WsprStatus::ok, or the first field found to be invalid.
+     */
+    WsprStatus set(std::string_view callsign, std::string_view location, int power, const WsprCallsignTable &table) noexcept;
+
+    /**
+     * @brief Returns the number of messages in the sequence.
+     *
+     * @return 0 if unset, otherwise 1 or 2.
+     */
+    std::size_t count() const noexcept;
+
+    /**
+     * @brief Returns the format of a message in the sequence.
+     *
+     * @param index Position in the sequence, less than count().
+     * @return The message type.
+     */
+    WsprMessageType type(std::size_t index) const noexcept;
+
+    /**
+     * @brief Returns the payload of a message in the sequence.
+     *
+     * @param index Position in the sequence, less than count().
+     * @return The packed payload.
+     */
+    const WsprPayload &payload(std::size_t index) const noexcept;
+
+    /**
+     * @brief Returns the encoded symbols of a message in the sequence.
+     *
+     * @param index Position in the sequence, less than count().
+     * @return The encoded symbols.
+     */
+    const WsprMessage::Symbols &symbols(std::size_t index) const noexcept;
+
+    /**
+     * @brief Returns the symbols to send in a given transmit slot.
+     *
+     * @param slot Running slot number; messages alternate by slot.
+     * @return The encoded symbols for that slot.
+     *
+     * @note The sequence must be set (count() > 0).
+     */
+    const WsprMessage::Symbols &for_slot(std::size_t slot) const noexcept;
+
+private:
+    /**
+     * @brief Plans the payloads and encodes them.
+     *
+     * @param callsign Standard or compound callsign.
+     * @param location 4- or 6-character locator; 6 characters for a compound callsign.
+     * @param power Power level in dBm.
+     * @param hash The callsign's 15-bit hash.
+     * @return WsprStatus::ok, or the validation failure.
+     */
+    WsprStatus plan(std::string_view callsign, std::string_view location, int power, uint16_t hash) noexcept;
+
+    std::array<WsprMessage::Symbols, max_messages> symbols_{}; ///< Encoded messages.
+    std::array<WsprPayload, max_messages> payloads_{};         ///< Packed payloads.
+    std::array<WsprMessageType, max_messages> types_{};        ///< Message formats.
+    std::size_t count_ = 0;                                    ///< Messages in use.
+};
+
+#endif // WSPR_SEQUENCE_H
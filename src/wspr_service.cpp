@@ -0,0 +1,268 @@
+/**
+ * @file wspr_service.cpp
+ * @brief Asynchronous encode service with request coalescing and batching.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_service.hpp"
+#include "wspr_batch.hpp"
+
+#include <algorithm> // For: std::min
+
+/**
+ * @brief Creates the service with default options and starts its thread.
+ */
+WsprEncodeService::WsprEncodeService() : WsprEncodeService(Options())
+{
+}
+
+/**
+ * @brief Creates the service and starts its thread.
+ *
+ * @param options Batching and cache settings; a max_batch of 0 is treated as 1.
+ */
+WsprEncodeService::WsprEncodeService(const Options &options)
+    : options_(options), cache_(options.cache_capacity)
+{
+    if (options_.max_batch == 0)
+    {
+        options_.max_batch = 1;
+    }
+    queue_.reserve(options_.max_batch);
+    thread_ = std::thread(&WsprEncodeService::run, this);
+}
+
+/**
+ * @brief Completes every queued request, then stops the service thread.
+ */
+WsprEncodeService::~WsprEncodeService()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+/**
+ * @brief Requests an encode and returns a future for the result.
+ *
+ * @param callsign The callsign (either case).
+ * @param location The 4-character Maidenhead locator (either case).
+ * @param power The power level in dBm.
+ * @return Future for the result.
+ */
+std::future<WsprEncodeResult> WsprEncodeService::submit(std::string_view callsign, std::string_view location, int power)
+{
+    std::promise<WsprEncodeResult> promise;
+    std::future<WsprEncodeResult> future = promise.get_future();
+    dispatch(callsign, location, power, Waiter{std::move(promise)});
+    return future;
+}
+
+/**
+ * @brief Requests an encode and calls `callback` with the result.
+ *
+ * @param callsign The callsign (either case).
+ * @param location The 4-character Maidenhead locator (either case).
+ * @param power The power level in dBm.
+ * @param callback Called once with the result.
+ */
+void WsprEncodeService::submit(std::string_view callsign, std::string_view location, int power, Callback callback)
+{
+    dispatch(callsign, location, power, Waiter{std::move(callback)});
+}
+
+/**
+ * @brief Returns the current counters.
+ *
+ * @return A snapshot of request, coalescing, and batch counts.
+ */
+WsprEncodeService::Stats WsprEncodeService::stats() const
+{
+    Stats snapshot{};
+    snapshot.requests = requests_.load(std::memory_order_relaxed);
+    snapshot.rejected = rejected_.load(std::memory_order_relaxed);
+    snapshot.hits = hits_.load(std::memory_order_relaxed);
+    snapshot.coalesced = coalesced_.load(std::memory_order_relaxed);
+    snapshot.encoded = encoded_.load(std::memory_order_relaxed);
+    snapshot.batches = batches_.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot.queued = queue_.size();
+    return snapshot;
+}
+
+/**
+ * @brief Returns the cache shared by every request.
+ *
+ * @return The cache.
+ */
+WsprCache &WsprEncodeService::cache() noexcept
+{
+    return cache_;
+}
+
+/**
+ * @brief Delivers the result.
+ *
+ * @param result The result.
+ */
+void WsprEncodeService::Waiter::complete(const WsprEncodeResult &result)
+{
+    if (Callback *callback = std::get_if<Callback>(&target))
+    {
+        (*callback)(result);
+    }
+    else
+    {
+        std::get_if<std::promise<WsprEncodeResult>>(&target)->set_value(result);
+    }
+}
+
+/**
+ * @brief Validates a request and completes, joins, or queues it.
+ *
+ * The cache is consulted while the queue lock is held. The service thread
+ * stores a batch in the cache before it removes the batch's in-flight
+ * entries, so a request that finds neither is genuinely new.
+ *
+ * @param callsign The callsign.
+ * @param location The locator.
+ * @param power The power level in dBm.
+ * @param waiter Receives the result.
+ */
+void WsprEncodeService::dispatch(std::string_view callsign, std::string_view location, int power, Waiter &&waiter)
+{
+    requests_.fetch_add(1, std::memory_order_relaxed);
+    WsprEncodeResult result;
+    WsprPayload payload;
+    result.status = WsprMessage::pack(callsign, location, power, payload);
+    if (result.status != WsprStatus::ok)
+    {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        waiter.complete(result);
+        return;
+    }
+    const uint64_t key = payload.key();
+
+    bool queued = false;
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = inflight_.find(key);
+        if (found != inflight_.end())
+        {
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+            found->second.waiters.push_back(std::move(waiter));
+            return;
+        }
+        if (!cache_.lookup(payload, result.symbols.data()))
+        {
+            Pending &pending = inflight_[key];
+            pending.payload = payload;
+            pending.waiters.push_back(std::move(waiter));
+            queue_.emplace_back(key, Clock::now());
+            queued = true;
+            // The thread only needs waking for a new batch or a full one
+            wake = queue_.size() == 1 || queue_.size() == options_.max_batch;
+        }
+    }
+
+    if (queued)
+    {
+        if (wake)
+        {
+            wake_.notify_one();
+        }
+        return;
+    }
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    waiter.complete(result);
+}
+
+/**
+ * @brief Service thread body: gathers, encodes, and completes batches.
+ */
+void WsprEncodeService::run()
+{
+    const std::size_t limit = options_.max_batch;
+    std::vector<WsprPayload> payloads(limit);
+    std::vector<uint8_t> buffer(limit * MSG_SIZE);
+    std::vector<Pending> batch;
+    batch.reserve(limit);
+    auto rows = reinterpret_cast<uint8_t(*)[MSG_SIZE]>(buffer.data());
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        wake_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty())
+        {
+            return; // Stopping, and everything has been completed
+        }
+
+        // Let the batch fill, but never hold the oldest request past max_delay
+        const Clock::time_point deadline = queue_.front().second + options_.max_delay;
+        wake_.wait_until(lock, deadline, [this, limit] { return stop_ || queue_.size() >= limit; });
+
+        const std::size_t count = std::min(queue_.size(), limit);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            payloads[i] = inflight_[queue_[i].first].payload;
+        }
+        queue_.erase(queue_.begin(), queue_.begin() + static_cast<std::ptrdiff_t>(count));
+
+        lock.unlock();
+        WsprBatch::encode_payloads(payloads.data(), count, rows, options_.kernel);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            cache_.store(payloads[i], rows[i]);
+        }
+        encoded_.fetch_add(count, std::memory_order_relaxed);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+
+        // Late arrivals have joined the waiter lists; take them with the entries
+        lock.lock();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto found = inflight_.find(payloads[i].key());
+            batch.push_back(std::move(found->second));
+            inflight_.erase(found);
+        }
+        lock.unlock();
+
+        WsprEncodeResult result;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::copy(rows[i], rows[i] + MSG_SIZE, result.symbols.begin());
+            for (Waiter &waiter : batch[i].waiters)
+            {
+                waiter.complete(result);
+            }
+        }
+        batch.clear();
+        lock.lock();
+    }
+}
@@ -0,0 +1,313 @@
+/**
+ * @file wspr_service.hpp
+ * @brief Asynchronous encode service with request coalescing and batching.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_SERVICE_H
+#define WSPR_SERVICE_H
+
+#include "wspr_cache.hpp"
+#include "wspr_message.hpp"
+#include "wspr_simd.hpp"
+
+#include <atomic>             // For: std::atomic
+#include <chrono>             // For: std::chrono::microseconds, steady_clock
+#include <condition_variable> // For: std::condition_variable
+#include <cstddef>            // For: std::size_t
+#include <cstdint>            // For: uint8_t, uint64_t
+#include <functional>         // For: std::function
+#include <future>             // For: std::future, std::promise
+#include <mutex>              // For: std::mutex
+#include <string_view>        // For: std::string_view
+#include <thread>             // For: std::thread
+#include <unordered_map>      // For: std::unordered_map
+#include <utility>            // For: std::pair
+#include <variant>            // For: std::variant, std::get_if
+#include <vector>             // For: std::vector
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#include <coroutine> // For: std::coroutine_handle
+#define WSPR_COROUTINES 1
+#else
+#define WSPR_COROUTINES 0
+#endif
+
+/**
+ * @brief Outcome of one asynchronous encode.
+ */
+struct WsprEncodeResult
+{
+    WsprStatus status = WsprStatus::ok; ///< Validation result.
+    WsprMessage::Symbols symbols{};     ///< Encoded message, when status is ok.
+};
+
+/**
+ * @class WsprEncodeService
+ * @brief Shares one cache and batch encoder among concurrent requesters.
+ *
+ * Requests are validated on the caller's thread. Invalid requests and
+ * cache hits complete before submit() returns. A request for a message
+ * that is already being encoded joins the in-flight entry instead of
+ * queuing another encode. Every other message is queued for the service
+ * thread, which encodes up to `max_batch` of them at a time with
+ * WsprBatch::encode_payloads() on the SIMD kernels, stores them in the
+ * cache, and completes every waiter.
+ *
+ * A request waits at most `max_delay` for its batch to fill. A full batch
+ * is dispatched at once, so queueing latency is bounded under bursts and
+ * an idle service adds at most `max_delay` to a lone request.
+ *
+ * Completion is delivered through a std::future, or through a callback
+ * that runs on the service thread (or inline for immediate results).
+ * Callbacks must be short and must not throw. When compiled as C++20,
+ * encode() returns an awaitable for coroutines, resumed from the service
+ * thread.
+ *
+ * submit() may be called from any thread. Destroying the service
+ * completes everything still queued, then stops the thread.
+ */
+class WsprEncodeService
+{
+public:
+    /**
+     * @brief Batching and cache settings.
+     */
+    struct Options
+    {
+        std::size_t max_batch = 256;                 ///< Most messages encoded per batch.
+        std::chrono::microseconds max_delay{200};    ///< Longest a request waits for its batch to fill.
+        std::size_t cache_capacity = 1024;           ///< Messages kept in the cache.
+        WsprKernel kernel = WsprKernel::automatic;   ///< Batch encoder kernel.
+    };
+
+    /**
+     * @brief Snapshot of service counters.
+     */
+    struct Stats
+    {
+        uint64_t requests;  ///< Requests submitted.
+        uint64_t rejected;  ///< Requests that failed validation.
+        uint64_t hits;      ///< Requests served from the cache.
+        uint64_t coalesced; ///< Requests that joined an in-flight encode.
+        uint64_t encoded;   ///< Messages encoded.
+        uint64_t batches;   ///< Batches dispatched.
+        std::size_t queued; ///< Messages waiting for a batch.
+    };
+
+    /**
+     * @brief Completion callback; receives the result exactly once.
+     */
+    using Callback = std::function<void(const WsprEncodeResult &)>;
+
+    /**
+     * @brief Creates the service with default options and starts its thread.
+     *
+     * @throws std::system_error If the service thread cannot be started.
+     */
+    WsprEncodeService();
+
+    /**
+     * @brief Creates the service and starts its thread.
+     *
+     * @param options Batching and cache settings.
+     * @throws std::system_error If the service thread cannot be started.
+     */
+    explicit WsprEncodeService(const Options &options);
+
+    /**
+     * @brief Completes every queued request, then stops the service thread.
+     */
+    ~WsprEncodeService();
+
+    WsprEncodeService(const WsprEncodeService &) = delete;
+    WsprEncodeService &operator=(const WsprEncodeService &) = delete;
+
+    /**
+     * @brief Requests an encode and returns a future for the result.
+     *
+     * @param callsign The callsign (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The power level in dBm.
+     * @return Future that becomes ready when the message is encoded;
+     *         already ready for invalid input and cache hits.
+     */
+    std::future<WsprEncodeResult> submit(std::string_view callsign, std::string_view location, int power);
+
+    /**
+     * @brief Requests an encode and calls `callback` with the result.
+     *
+     * @param callsign The callsign (either case).
+     * @param location The 4-character Maidenhead locator (either case).
+     * @param power The power level in dBm.
+     * @param callback Called once, before this returns for invalid input
+     *                 and cache hits, otherwise on the service thread.
+     */
+    void submit(std::string_view callsign, std::string_view location, int power, Callback callback);
+
+#if WSPR_COROUTINES
+    /**
+     * @brief Awaitable returned by encode(); `co_await` yields the result.
+     */
+    class Awaitable
+    {
+    public:
+        /**
+         * @brief Captures a request; nothing is submitted until awaited.
+         *
+         * @param service The service to submit to.
+         * @param callsign The callsign; must outlive the `co_await`.
+         * @param location The locator; must outlive the `co_await`.
+         * @param power The power level in dBm.
+         */
+        Awaitable(WsprEncodeService &service, std::string_view callsign, std::string_view location, int power) noexcept
+            : service_(service), callsign_(callsign), location_(location), power_(power)
+        {
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        /**
+         * @brief Submits the request.
+         *
+         * Whichever of this function and the callback finishes second
+         * resumes the coroutine, so an immediate result does not suspend.
+         *
+         * @param handle The awaiting coroutine.
+         * @return False if the result is already available.
+         */
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            handle_ = handle;
+            service_.submit(callsign_, location_, power_, [this](const WsprEncodeResult &result) {
+                result_ = result;
+                if (done_.exchange(true, std::memory_order_acq_rel))
+                {
+                    handle_.resume();
+                }
+            });
+            return !done_.exchange(true, std::memory_order_acq_rel);
+        }
+
+        WsprEncodeResult await_resume() const noexcept { return result_; }
+
+    private:
+        WsprEncodeService &service_;
+        std::string_view callsign_;
+        std::string_view location_;
+        int power_;
+        std::coroutine_handle<> handle_;
+        WsprEncodeResult result_;
+        std::atomic<bool> done_{false};
+    };
+
+    /**
+     * @brief Requests an encode from a coroutine: `co_await service.encode(...)`.
+     *
+     * @param callsign The callsign (either case); must outlive the `co_await`.
+     * @param location The 4-character Maidenhead locator; must outlive the `co_await`.
+     * @param power The power level in dBm.
+     * @return The awaitable.
+     */
+    Awaitable encode(std::string_view callsign, std::string_view location, int power) noexcept
+    {
+        return Awaitable(*this, callsign, location, power);
+    }
+#endif
+
+    /**
+     * @brief Returns the current counters.
+     *
+     * @return A snapshot of request, coalescing, and batch counts.
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Returns the cache shared by every request.
+     *
+     * @return The cache.
+     */
+    WsprCache &cache() noexcept;
+
+private:
+    /**
+     * @brief One party waiting for a message: a callback or a promise.
+     */
+    struct Waiter
+    {
+        /**
+         * @brief The completion target; a callback needs no shared state.
+         */
+        std::variant<Callback, std::promise<WsprEncodeResult>> target;
+
+        /**
+         * @brief Delivers the result.
+         *
+         * @param result The result.
+         */
+        void complete(const WsprEncodeResult &result);
+    };
+
+    /**
+     * @brief A message queued or being encoded, and everyone waiting for it.
+     */
+    struct Pending
+    {
+        WsprPayload payload;         ///< Packed message.
+        std::vector<Waiter> waiters; ///< Completed together.
+    };
+
+    /**
+     * @brief Validates a request and completes, joins, or queues it.
+     *
+     * @param callsign The callsign.
+     * @param location The locator.
+     * @param power The power level in dBm.
+     * @param waiter Receives the result.
+     */
+    void dispatch(std::string_view callsign, std::string_view location, int power, Waiter &&waiter);
+
+    /**
+     * @brief Service thread body: gathers, encodes, and completes batches.
+     */
+    void run();
+
+    using Clock = std::chrono::steady_clock;
+
+    Options options_;                                    ///< Settings.
+    WsprCache cache_;                                    ///< Shared message cache.
+    mutable std::mutex mutex_;                           ///< Guards the queue state below.
+    std::condition_variable wake_;                       ///< Signals new work or stop.
+    std::unordered_map<uint64_t, Pending> inflight_;     ///< Queued or encoding, by payload key.
+    std::vector<std::pair<uint64_t, Clock::time_point>> queue_; ///< Keys waiting for a batch, oldest first.
+    bool stop_ = false;                                  ///< Set by the destructor.
+    std::atomic<uint64_t> requests_{0};                  ///< Requests submitted.
+    std::atomic<uint64_t> rejected_{0};                  ///< Requests that failed validation.
+    std::atomic<uint64_t> hits_{0};                      ///< Requests served from the cache.
+    std::atomic<uint64_t> coalesced_{0};                 ///< Requests that joined an in-flight encode.
+    std::atomic<uint64_t> encoded_{0};                   ///< Messages encoded.
+    std::atomic<uint64_t> batches_{0};                   ///< Batches dispatched.
+    std::thread thread_;                                 ///< Service thread; started last.
+};
+
+#endif // WSPR_SERVICE_H
@@ -0,0 +1,327 @@
+/**
+ * @file wspr_simd.cpp
+ * @brief Multi-message SIMD convolutional encoders with runtime dispatch.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_simd.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // For: AVX2 intrinsics
+#define WSPR_SIMD_X86 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // For: NEON intrinsics
+#define WSPR_SIMD_NEON 1
+#endif
+
+/**
+ * @brief Reports whether a kernel can run on this CPU.
+ *
+ * @param kernel The kernel to check.
+ * @return True if the kernel is compiled in and supported at run time.
+ */
+bool WsprSimd::available(WsprKernel kernel) noexcept
+{
+    switch (kernel)
+    {
+    case WsprKernel::automatic:
+    case WsprKernel::scalar:
+        return true;
+    case WsprKernel::avx2:
+#if defined(WSPR_SIMD_X86)
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    case WsprKernel::neon:
+#if defined(WSPR_SIMD_NEON)
+        return true; // NEON is part of the target ABI when the compiler enables it
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the fastest kernel available on this CPU.
+ *
+ * @return The preferred SIMD kernel, or WsprKernel::scalar.
+ */
+WsprKernel WsprSimd::best() noexcept
+{
+    static const WsprKernel cached = available(WsprKernel::avx2)   ? WsprKernel::avx2
+                                     : available(WsprKernel::neon) ? WsprKernel::neon
+                                                                   : WsprKernel::scalar;
+    return cached;
+}
+
+/**
+ * @brief Resolves a requested kernel to one that can run here.
+ *
+ * @param kernel The requested kernel.
+ * @return `kernel` if it is a concrete, available kernel, otherwise best().
+ */
+WsprKernel WsprSimd::resolve(WsprKernel kernel) noexcept
+{
+    if (kernel == WsprKernel::automatic || !available(kernel))
+    {
+        return best();
+    }
+    return kernel;
+}
+
+/**
+ * @brief Returns the number of messages a kernel encodes per call.
+ *
+ * @param kernel The kernel to query.
+ * @return Lane count, or 1 for the scalar kernel.
+ */
+std::size_t WsprSimd::lanes(WsprKernel kernel) noexcept
+{
+    switch (kernel)
+    {
+    case WsprKernel::avx2:
+        return avx2_lanes;
+    case WsprKernel::neon:
+        return neon_lanes;
+    default:
+        return 1;
+    }
+}
+
+/**
+ * @brief Interleaves per-step encoder outputs into each lane's symbol buffer.
+ *
+ * @param pairs Row-major `[81][lanes]` array; each entry holds the poly_a
+ *              parity in bit 0 and the poly_b parity in bit 16.
+ * @param lanes Number of messages in the group.
+ * @param out `lanes` destination buffers of MSG_SIZE symbols.
+ *
+ * @note Every symbol position is written exactly once, so symbols are
+ *       assigned from the sync vector directly rather than pre-filled.
+ */
+[[maybe_unused]] static void scatter_pairs(const uint32_t *pairs, std::size_t lanes, uint8_t *const *out) noexcept
+{
+    for (std::size_t lane = 0; lane < lanes; ++lane)
+    {
+        uint8_t *symbols = out[lane];
+        for (std::size_t step = 0; step < 81; ++step)
+        {
+            const uint32_t pair = pairs[step * lanes + lane];
+            const uint8_t pos_a = WsprMessage::interleave_table[2 * step];
+            const uint8_t pos_b = WsprMessage::interleave_table[2 * step + 1];
+            symbols[pos_a] = static_cast<uint8_t>(WsprMessage::sync_vector[pos_a] | ((pair & 1) << 1));
+            symbols[pos_b] = static_cast<uint8_t>(WsprMessage::sync_vector[pos_b] | ((pair >> 15) & 2));
+        }
+    }
+}
+
+#if defined(WSPR_SIMD_X86)
+
+/**
+ * @brief Advances eight shift registers by one input bit and returns both outputs.
+ *
+ * @param reg The eight 32-bit encoder registers, updated in place.
+ * @param in The next input bit for each lane (0 or 1).
+ * @return Per lane: bit 0 is the parity against poly_a, bit 16 the parity
+ *         against poly_b.
+ *
+ * @note Each parity is first folded from 32 to 16 bits, then both halves are
+ *       folded together in one 32-bit lane. Shifts of 8+4+2+1 never carry a
+ *       bit across the 16-bit boundary into bit 0, so the halves stay independent.
+ */
+__attribute__((target("avx2"))) static inline __m256i step_avx2(__m256i &reg, __m256i in)
+{
+    const __m256i poly_a = _mm256_set1_epi32(static_cast<int>(WsprMessage::poly_a));
+    const __m256i poly_b = _mm256_set1_epi32(static_cast<int>(WsprMessage::poly_b));
+    const __m256i low16 = _mm256_set1_epi32(0xFFFF);
+
+    reg = _mm256_or_si256(_mm256_slli_epi32(reg, 1), in);
+
+    __m256i a = _mm256_and_si256(reg, poly_a);
+    __m256i b = _mm256_and_si256(reg, poly_b);
+    a = _mm256_xor_si256(a, _mm256_srli_epi32(a, 16));
+    b = _mm256_xor_si256(b, _mm256_srli_epi32(b, 16));
+
+    __m256i c = _mm256_or_si256(_mm256_and_si256(a, low16), _mm256_slli_epi32(b, 16));
+    c = _mm256_xor_si256(c, _mm256_srli_epi32(c, 8));
+    c = _mm256_xor_si256(c, _mm256_srli_epi32(c, 4));
+    c = _mm256_xor_si256(c, _mm256_srli_epi32(c, 2));
+    c = _mm256_xor_si256(c, _mm256_srli_epi32(c, 1));
+    return c;
+}
+
+/**
+ * @brief Encodes eight packed payloads with AVX2.
+ *
+ * @param n Eight packed 28-bit callsign integers.
+ * @param m Eight packed 22-bit locator/power integers.
+ * @param out Eight destination buffers of MSG_SIZE symbols.
+ */
+__attribute__((target("avx2"))) void WsprSimd::encode_avx2(const uint32_t *n, const uint32_t *m, uint8_t *const *out) noexcept
+{
+    const __m256i one = _mm256_set1_epi32(1);
+
+    // Left-align the payloads so the next input bit is always bit 31
+    __m256i src_n = _mm256_slli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(n)), 32 - 28);
+    __m256i src_m = _mm256_slli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(m)), 32 - 22);
+    __m256i reg = _mm256_setzero_si256();
+
+    // Run all 81 register steps first, then scatter each lane's outputs.
+    // Keeping the vector work and the byte stores in separate loops lets
+    // both pipeline instead of serializing on a store/reload every step.
+    alignas(32) uint32_t pairs[81][avx2_lanes];
+
+    for (int step = 0; step < 81; ++step)
+    {
+        __m256i in = _mm256_setzero_si256();
+        if (step < 28)
+        {
+            in = _mm256_and_si256(_mm256_srli_epi32(src_n, 31), one);
+            src_n = _mm256_slli_epi32(src_n, 1);
+        }
+        else if (step < 50)
+        {
+            in = _mm256_and_si256(_mm256_srli_epi32(src_m, 31), one);
+            src_m = _mm256_slli_epi32(src_m, 1);
+        }
+
+        _mm256_store_si256(reinterpret_cast<__m256i *>(pairs[step]), step_avx2(reg, in));
+    }
+
+    scatter_pairs(&pairs[0][0], avx2_lanes, out);
+}
+
+#else
+
+/**
+ * @brief Encodes eight packed payloads; scalar stand-in on non-x86 targets.
+ *
+ * @param n Eight packed 28-bit callsign integers.
+ * @param m Eight packed 22-bit locator/power integers.
+ * @param out Eight destination buffers of MSG_SIZE symbols.
+ */
+void WsprSimd::encode_avx2(const uint32_t *n, const uint32_t *m, uint8_t *const *out) noexcept
+{
+    for (std::size_t lane = 0; lane < avx2_lanes; ++lane)
+    {
+        WsprPayload payload;
+        payload.n = n[lane];
+        payload.m = m[lane];
+        WsprMessage::encode_payload(payload, out[lane]);
+    }
+}
+
+#endif // WSPR_SIMD_X86
+
+#if defined(WSPR_SIMD_NEON)
+
+/**
+ * @brief Advances four shift registers by one input bit and returns both outputs.
+ *
+ * @param reg The four 32-bit encoder registers, updated in place.
+ * @param in The next input bit for each lane (0 or 1).
+ * @return Per lane: bit 0 is the parity against poly_a, bit 16 the parity
+ *         against poly_b.
+ */
+static inline uint32x4_t step_neon(uint32x4_t &reg, uint32x4_t in)
+{
+    const uint32x4_t poly_a = vdupq_n_u32(WsprMessage::poly_a);
+    const uint32x4_t poly_b = vdupq_n_u32(WsprMessage::poly_b);
+    const uint32x4_t low16 = vdupq_n_u32(0xFFFF);
+
+    reg = vorrq_u32(vshlq_n_u32(reg, 1), in);
+
+    uint32x4_t a = vandq_u32(reg, poly_a);
+    uint32x4_t b = vandq_u32(reg, poly_b);
+    a = veorq_u32(a, vshrq_n_u32(a, 16));
+    b = veorq_u32(b, vshrq_n_u32(b, 16));
+
+    uint32x4_t c = vorrq_u32(vandq_u32(a, low16), vshlq_n_u32(b, 16));
+    c = veorq_u32(c, vshrq_n_u32(c, 8));
+    c = veorq_u32(c, vshrq_n_u32(c, 4));
+    c = veorq_u32(c, vshrq_n_u32(c, 2));
+    c = veorq_u32(c, vshrq_n_u32(c, 1));
+    return c;
+}
+
+/**
+ * @brief Encodes four packed payloads with NEON.
+ *
+ * @param n Four packed 28-bit callsign integers.
+ * @param m Four packed 22-bit locator/power integers.
+ * @param out Four destination buffers of MSG_SIZE symbols.
+ */
+void WsprSimd::encode_neon(const uint32_t *n, const uint32_t *m, uint8_t *const *out) noexcept
+{
+    // Left-align the payloads so the next input bit is always bit 31
+    uint32x4_t src_n = vshlq_n_u32(vld1q_u32(n), 32 - 28);
+    uint32x4_t src_m = vshlq_n_u32(vld1q_u32(m), 32 - 22);
+    uint32x4_t reg = vdupq_n_u32(0);
+
+    uint32_t pairs[81][neon_lanes];
+
+    for (int step = 0; step < 81; ++step)
+    {
+        uint32x4_t in = vdupq_n_u32(0);
+        if (step < 28)
+        {
+            in = vshrq_n_u32(src_n, 31);
+            src_n = vshlq_n_u32(src_n, 1);
+        }
+        else if (step < 50)
+        {
+            in = vshrq_n_u32(src_m, 31);
+            src_m = vshlq_n_u32(src_m, 1);
+        }
+
+        vst1q_u32(pairs[step], step_neon(reg, in));
+    }
+
+    scatter_pairs(&pairs[0][0], neon_lanes, out);
+}
+
+#else
+
+/**
+ * @brief Encodes four packed payloads; scalar stand-in on targets without NEON.
+ *
+ * @param n Four packed 28-bit callsign integers.
+ * @param m Four packed 22-bit locator/power integers.
+ * @param out Four destination buffers of MSG_SIZE symbols.
+ */
+void WsprSimd::encode_neon(const uint32_t *n, const uint32_t *m, uint8_t *const *out) noexcept
+{
+    for (std::size_t lane = 0; lane < neon_lanes; ++lane)
+    {
+        WsprPayload payload;
+        payload.n = n[lane];
+        payload.m = m[lane];
+        WsprMessage::encode_payload(payload, out[lane]);
+    }
+}
+
+#endif // WSPR_SIMD_NEON
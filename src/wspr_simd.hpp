@@ -0,0 +1,125 @@
+/**
+ * @file wspr_simd.hpp
+ * @brief Multi-message SIMD convolutional encoders with runtime dispatch.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_SIMD_H
+#define WSPR_SIMD_H
+
+#include "wspr_message.hpp"
+
+#include <cstddef> // For: std::size_t
+#include <cstdint> // For: uint8_t, uint32_t
+
+/**
+ * @brief Selects the convolutional encoder kernel used for bulk encoding.
+ */
+enum class WsprKernel : uint8_t
+{
+    automatic = 0, ///< Pick the fastest kernel supported by this CPU.
+    scalar,        ///< Portable table-driven encoder, one message at a time.
+    avx2,          ///< x86 AVX2, eight messages in lockstep.
+    neon,          ///< ARM NEON, four messages in lockstep.
+};
+
+/**
+ * @class WsprSimd
+ * @brief Encodes several packed WSPR payloads in lockstep.
+ *
+ * Each SIMD lane holds one message's 32-bit shift register, so all lanes
+ * advance through the 81 input bits together. The output is bit-exact with
+ * WsprMessage's scalar encoder. Kernels are compiled with per-function target
+ * attributes and selected at run time, so the binary still runs on CPUs
+ * without the extension.
+ */
+class WsprSimd
+{
+public:
+    /**
+     * @brief Number of messages encoded per AVX2 kernel call.
+     */
+    static constexpr std::size_t avx2_lanes = 8;
+
+    /**
+     * @brief Number of messages encoded per NEON kernel call.
+     */
+    static constexpr std::size_t neon_lanes = 4;
+
+    /**
+     * @brief Reports whether a kernel can run on this CPU.
+     *
+     * @param kernel The kernel to check.
+     * @return True if the kernel is compiled in and supported at run time.
+     *         WsprKernel::automatic and WsprKernel::scalar are always available.
+     */
+    static bool available(WsprKernel kernel) noexcept;
+
+    /**
+     * @brief Returns the fastest kernel available on this CPU.
+     *
+     * @return WsprKernel::avx2 or WsprKernel::neon when supported, otherwise
+     *         WsprKernel::scalar.
+     */
+    static WsprKernel best() noexcept;
+
+    /**
+     * @brief Resolves a requested kernel to one that can run here.
+     *
+     * @param kernel The requested kernel.
+     * @return `kernel` if available, otherwise best().
+     */
+    static WsprKernel resolve(WsprKernel kernel) noexcept;
+
+    /**
+     * @brief Returns the number of messages a kernel encodes per call.
+     *
+     * @param kernel The kernel to query.
+     * @return Lane count, or 1 for the scalar kernel.
+     */
+    static std::size_t lanes(WsprKernel kernel) noexcept;
+
+    /**
+     * @brief Encodes eight packed payloads with AVX2.
+     *
+     * @param n Eight packed 28-bit callsign integers.
+     * @param m Eight packed 22-bit locator/power integers.
+     * @param out Eight destination buffers of MSG_SIZE symbols.
+     *
+     * @note Only call when available(WsprKernel::avx2) returns true.
+     */
+    static void encode_avx2(const uint32_t *n, const uint32_t *m, uint8_t *const *out) noexcept;
+
+    /**
+     * @brief Encodes four packed payloads with NEON.
+     *
+     * @param n Four packed 28-bit callsign integers.
+     * @param m Four packed 22-bit locator/power integers.
+     * @param out Four destination buffers of MSG_SIZE symbols.
+     *
+     * @note Only call when available(WsprKernel::neon) returns true.
+     */
+    static void encode_neon(const uint32_t *n, const uint32_t *m, uint8_t *const *out) noexcept;
+};
+
+#endif // WSPR_SIMD_H
@@ -0,0 +1,257 @@
+/**
+ * @file wspr_span.hpp
+ * @brief Non-owning views over WSPR symbol buffers, with a C++17 span shim.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_SPAN_H
+#define WSPR_SPAN_H
+
+#include <array>       // For: std::array
+#include <cstddef>     // For: std::size_t
+#include <cstdint>     // For: uint8_t
+#include <type_traits> // For: std::remove_cv_t, std::is_convertible
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version> // For: __cpp_lib_span
+#endif
+#endif
+
+#if defined(__cpp_lib_span) && __cpp_lib_span >= 202002L
+#include <span> // For: std::span
+
+/**
+ * @brief Non-owning view of a contiguous sequence; std::span when available.
+ */
+template <typename T>
+using WsprSpan = std::span<T>;
+
+#else
+
+/**
+ * @class WsprSpan
+ * @brief Minimal stand-in for `std::span<T>` (dynamic extent) on C++17.
+ *
+ * Only the subset of the std::span interface used by this library is
+ * provided, with the same names and semantics, so code written against it
+ * compiles unchanged when the real std::span is picked up under C++20.
+ */
+template <typename T>
+class WsprSpan
+{
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using pointer = T *;
+    using reference = T &;
+    using iterator = T *;
+
+    /**
+     * @brief Constructs an empty view.
+     */
+    constexpr WsprSpan() noexcept : data_(nullptr), size_(0) {}
+
+    /**
+     * @brief Views `size` elements starting at `data`.
+     *
+     * @param data First element.
+     * @param size Number of elements.
+     */
+    constexpr WsprSpan(T *data, size_type size) noexcept : data_(data), size_(size) {}
+
+    /**
+     * @brief Views a built-in array.
+     *
+     * @param array The array to view.
+     */
+    template <std::size_t N>
+    constexpr WsprSpan(T (&array)[N]) noexcept : data_(array), size_(N) {}
+
+    /**
+     * @brief Views a std::array.
+     *
+     * @param array The array to view.
+     */
+    template <typename U, std::size_t N, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr WsprSpan(std::array<U, N> &array) noexcept : data_(array.data()), size_(N) {}
+
+    /**
+     * @brief Views a const std::array.
+     *
+     * @param array The array to view.
+     */
+    template <typename U, std::size_t N, typename = std::enable_if_t<std::is_convertible<const U (*)[], T (*)[]>::value>>
+    constexpr WsprSpan(const std::array<U, N> &array) noexcept : data_(array.data()), size_(N) {}
+
+    /**
+     * @brief Converts a mutable view to a const view.
+     *
+     * @param other The view to convert.
+     */
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr WsprSpan(const WsprSpan<U> &other) noexcept : data_(other.data()), size_(other.size()) {}
+
+    constexpr pointer data() const noexcept { return data_; }                           ///< First element.
+    constexpr size_type size() const noexcept { return size_; }                         ///< Element count.
+    constexpr size_type size_bytes() const noexcept { return size_ * sizeof(T); }       ///< Size in bytes.
+    constexpr bool empty() const noexcept { return size_ == 0; }                        ///< True if no elements.
+    constexpr reference operator[](size_type index) const noexcept { return data_[index]; } ///< Unchecked access.
+    constexpr reference front() const noexcept { return data_[0]; }                     ///< First element.
+    constexpr reference back() const noexcept { return data_[size_ - 1]; }              ///< Last element.
+    constexpr iterator begin() const noexcept { return data_; }                         ///< Start of the view.
+    constexpr iterator end() const noexcept { return data_ + size_; }                   ///< End of the view.
+
+    /**
+     * @brief Returns a view of the first `count` elements.
+     *
+     * @param count Number of elements; must not exceed size().
+     * @return The sub-view.
+     */
+    constexpr WsprSpan first(size_type count) const noexcept { return {data_, count}; }
+
+    /**
+     * @brief Returns a view of the last `count` elements.
+     *
+     * @param count Number of elements; must not exceed size().
+     * @return The sub-view.
+     */
+    constexpr WsprSpan last(size_type count) const noexcept { return {data_ + (size_ - count), count}; }
+
+    /**
+     * @brief Returns a view of `count` elements starting at `offset`.
+     *
+     * @param offset First element of the sub-view.
+     * @param count Number of elements, or `npos` for the rest of the view.
+     * @return The sub-view.
+     */
+    constexpr WsprSpan subspan(size_type offset, size_type count = npos) const noexcept
+    {
+        return {data_ + offset, count == npos ? size_ - offset : count};
+    }
+
+private:
+    static constexpr size_type npos = static_cast<size_type>(-1); ///< Matches std::dynamic_extent.
+
+    T *data_;        ///< First element.
+    size_type size_; ///< Element count.
+};
+
+#endif // __cpp_lib_span
+
+/**
+ * @class WsprSymbolBlock
+ * @brief Views an externally owned buffer as consecutive 162-symbol messages.
+ *
+ * The buffer can be anything the caller owns: a mapped DMA region, shared
+ * memory, or a slice of a larger allocation. The block stores a pointer and
+ * a count only. Each message is handed out as a WsprSpan into the buffer,
+ * and rows() exposes the layout WsprBatch uses, so encoders can write the
+ * final symbols in place with no staging copy.
+ */
+class WsprSymbolBlock
+{
+public:
+    /**
+     * @brief Number of symbols in one message.
+     */
+    static constexpr std::size_t stride = 162;
+
+    /**
+     * @brief Wraps `count` messages stored back to back at `data`.
+     *
+     * @param data Start of a buffer of at least `count * stride` bytes.
+     * @param count Number of messages.
+     */
+    constexpr WsprSymbolBlock(uint8_t *data, std::size_t count) noexcept : data_(data), count_(count) {}
+
+    /**
+     * @brief Wraps as many whole messages as fit in a byte span.
+     *
+     * @param bytes The buffer; trailing bytes short of a message are ignored.
+     */
+    constexpr explicit WsprSymbolBlock(WsprSpan<uint8_t> bytes) noexcept
+        : data_(bytes.data()), count_(bytes.size() / stride) {}
+
+    /**
+     * @brief Returns the number of messages in the block.
+     *
+     * @return Message count.
+     */
+    constexpr std::size_t size() const noexcept { return count_; }
+
+    /**
+     * @brief Returns a view of one message.
+     *
+     * @param index Message index, less than size().
+     * @return The message's 162 symbols.
+     */
+    constexpr WsprSpan<uint8_t> operator[](std::size_t index) const noexcept
+    {
+        return WsprSpan<uint8_t>(data_ + index * stride, stride);
+    }
+
+    /**
+     * @brief Returns the block as rows, for WsprBatch and WsprParallelEncoder.
+     *
+     * @return Pointer to the first message.
+     */
+    uint8_t (*rows() const noexcept)[stride]
+    {
+        return reinterpret_cast<uint8_t(*)[stride]>(data_);
+    }
+
+    /**
+     * @brief Returns the whole block as a flat byte view.
+     *
+     * @return View of `size() * stride` bytes.
+     */
+    constexpr WsprSpan<uint8_t> bytes() const noexcept { return WsprSpan<uint8_t>(data_, count_ * stride); }
+
+    /**
+     * @class iterator
+     * @brief Forward iterator yielding one message view at a time.
+     */
+    class iterator
+    {
+    public:
+        constexpr iterator(uint8_t *position) noexcept : position_(position) {}                          ///< At `position`.
+        constexpr WsprSpan<uint8_t> operator*() const noexcept { return WsprSpan<uint8_t>(position_, stride); } ///< Current message.
+        constexpr iterator &operator++() noexcept { position_ += stride; return *this; }                 ///< Next message.
+        constexpr bool operator==(const iterator &other) const noexcept { return position_ == other.position_; } ///< Same position.
+        constexpr bool operator!=(const iterator &other) const noexcept { return position_ != other.position_; } ///< Different position.
+
+    private:
+        uint8_t *position_; ///< Start of the current message.
+    };
+
+    constexpr iterator begin() const noexcept { return iterator(data_); }                  ///< First message.
+    constexpr iterator end() const noexcept { return iterator(data_ + count_ * stride); } ///< Past the last message.
+
+private:
+    uint8_t *data_;     ///< Start of the external buffer.
+    std::size_t count_; ///< Number of messages.
+};
+
+#endif // WSPR_SPAN_H
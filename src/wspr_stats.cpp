@@ -0,0 +1,107 @@
+/**
+ * @file wspr_stats.cpp
+ * @brief Counts heap allocations for WsprStats in instrumented builds.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_stats.hpp"
+
+#if WSPR_INSTRUMENT
+
+#include "wspr_message.hpp" // For: WSPR_EXCEPTIONS
+
+#include <cstddef> // For: std::size_t
+#include <cstdlib> // For: std::malloc, std::aligned_alloc, std::free, std::abort
+#include <new>     // For: std::align_val_t, std::bad_alloc, std::get_new_handler
+
+namespace
+{
+    /**
+     * @brief Allocates through `allocate`, honouring the new handler, and counts the allocation.
+     *
+     * @param allocate Returns the memory, or nullptr on failure.
+     * @return The memory; only returns on success.
+     */
+    template <typename Allocate>
+    void *counted(Allocate allocate)
+    {
+        for (;;)
+        {
+            if (void *memory = allocate())
+            {
+                WSPR_STAT_ADD(allocations, 1);
+                return memory;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr)
+            {
+#if WSPR_EXCEPTIONS
+                throw std::bad_alloc();
+#else
+                std::abort();
+#endif
+            }
+            handler();
+        }
+    }
+}
+
+// Replacing the global allocation functions counts every heap allocation in
+// the process, including those made inside the standard library (vector
+// growth, hash map rehashing, std::function captures, thread state). The
+// standard library's array and nothrow forms call these.
+
+void *operator new(std::size_t size)
+{
+    return counted([size]() { return std::malloc(size == 0 ? 1 : size); });
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    // aligned_alloc() needs a size that is a multiple of the alignment
+    const std::size_t rounded = (size + align - 1) / align * align;
+    return counted([align, rounded]() { return std::aligned_alloc(align, rounded == 0 ? align : rounded); });
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+#endif // WSPR_INSTRUMENT
@@ -0,0 +1,332 @@
+/**
+ * @file wspr_stats.hpp
+ * @brief Compile-time optional latency and event counters for the encoding paths.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_STATS_H
+#define WSPR_STATS_H
+
+#include <atomic>  // For: std::atomic
+#include <chrono>  // For: std::chrono::steady_clock
+#include <cstdint> // For: uint64_t
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // For: __rdtsc
+#endif
+
+/**
+ * @brief Enables the instrumentation hooks when defined to 1 (make INSTRUMENT=1).
+ *
+ * When it is 0, the WSPR_STAT_* macros expand to nothing, so the encoding
+ * paths contain no counter or clock code at all. WsprStats still exists
+ * either way, so code that reads the counters builds in both
+ * configurations; it reads zeros when instrumentation is off.
+ *
+ * An instrumented build also replaces the global operator new and delete
+ * (wspr_stats.cpp) so that the allocation count covers every heap
+ * allocation, including those inside the standard library. A program that
+ * replaces them itself cannot link an instrumented build.
+ */
+#ifndef WSPR_INSTRUMENT
+#define WSPR_INSTRUMENT 0
+#endif
+
+/**
+ * @class WsprClock
+ * @brief The cheapest monotonic tick counter on this target.
+ *
+ * Uses the time-stamp counter (`rdtsc`) on x86 and the virtual counter
+ * (`CNTVCT_EL0`) on AArch64, falling back to std::chrono::steady_clock
+ * nanoseconds elsewhere (including 32-bit ARM, where user access to the
+ * counter depends on the kernel).
+ */
+class WsprClock
+{
+public:
+    /**
+     * @brief Reads the tick counter.
+     *
+     * @return The current tick count.
+     */
+    static inline uint64_t now() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#endif
+    }
+
+    /**
+     * @brief Returns the tick rate.
+     *
+     * On x86 the rate is calibrated against steady_clock over about 10 ms
+     * on the first call, so call it outside timing-critical code.
+     *
+     * @return Ticks per second.
+     */
+    static double ticks_per_second() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        static const double rate = []() {
+            const auto start_time = std::chrono::steady_clock::now();
+            const uint64_t start = now();
+            while (std::chrono::steady_clock::now() - start_time < std::chrono::milliseconds(10))
+            {
+            }
+            const uint64_t ticks = now() - start;
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+            return static_cast<double>(ticks) / seconds;
+        }();
+        return rate;
+#elif defined(__aarch64__)
+        uint64_t frequency;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+        return static_cast<double>(frequency);
+#else
+        return 1e9;
+#endif
+    }
+};
+
+/**
+ * @brief Latency of one instrumented operation.
+ *
+ * All members are relaxed atomics, updated without locks from any thread.
+ */
+struct WsprTimingCounter
+{
+    std::atomic<uint64_t> calls{0};       ///< Number of timed calls.
+    std::atomic<uint64_t> items{0};       ///< Messages handled by those calls.
+    std::atomic<uint64_t> total_ticks{0}; ///< Sum of call durations.
+    std::atomic<uint64_t> max_ticks{0};   ///< Longest single call.
+
+    /**
+     * @brief Records one call.
+     *
+     * @param ticks Duration in WsprClock ticks.
+     * @param count Messages handled by the call.
+     */
+    void record(uint64_t ticks, uint64_t count) noexcept
+    {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        items.fetch_add(count, std::memory_order_relaxed);
+        total_ticks.fetch_add(ticks, std::memory_order_relaxed);
+        uint64_t seen = max_ticks.load(std::memory_order_relaxed);
+        while (ticks > seen && !max_ticks.compare_exchange_weak(seen, ticks, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /**
+     * @brief Zeroes the counter.
+     */
+    void reset() noexcept
+    {
+        calls.store(0, std::memory_order_relaxed);
+        items.store(0, std::memory_order_relaxed);
+        total_ticks.store(0, std::memory_order_relaxed);
+        max_ticks.store(0, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief A point-in-time copy of WsprStats with durations in nanoseconds.
+ */
+struct WsprStatsSnapshot
+{
+    /**
+     * @brief Latency summary of one operation.
+     */
+    struct Timing
+    {
+        uint64_t calls = 0;   ///< Number of timed calls.
+        uint64_t items = 0;   ///< Messages handled.
+        double total_ns = 0;  ///< Total time spent.
+        double max_ns = 0;    ///< Longest single call.
+        double mean_ns = 0;   ///< Mean time per call.
+    };
+
+    Timing encode;            ///< Single-message encodes (WsprMessage::encode, try_encode, constructors).
+    Timing reencode;          ///< WsprMessage::set_message_parameters(), try_set(), set_power() and reencode_power() calls.
+    Timing batch;             ///< WsprBatch::encode() and encode_payloads() calls.
+    Timing parallel;          ///< WsprParallelEncoder::encode() calls.
+    Timing cache;             ///< WsprCache::encode() calls, hits and misses together.
+    uint64_t cache_hits = 0;  ///< WsprCache lookups served from the cache.
+    uint64_t cache_misses = 0; ///< WsprCache lookups that had to encode.
+    double cache_hit_rate = 0; ///< Hits over lookups, 0 when there were none.
+    uint64_t allocations = 0; ///< Calls to the global operator new, process-wide; see wspr_stats.cpp.
+};
+
+/**
+ * @class WsprStats
+ * @brief Process-wide instrumentation counters.
+ *
+ * Every member is a lock-free atomic, so hooks on the hot paths never
+ * block. The counters are process-wide rather than per object, so one
+ * snapshot covers every WsprMessage, WsprBatch, WsprCache and
+ * WsprParallelEncoder in the process.
+ */
+class WsprStats
+{
+public:
+    /**
+     * @brief True when the library was built with WSPR_INSTRUMENT=1.
+     */
+    static constexpr bool enabled = WSPR_INSTRUMENT != 0;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Instrumentation counters must be lock-free");
+
+    WsprTimingCounter encode;                ///< See WsprStatsSnapshot::encode.
+    WsprTimingCounter reencode;              ///< See WsprStatsSnapshot::reencode.
+    WsprTimingCounter batch;                 ///< See WsprStatsSnapshot::batch.
+    WsprTimingCounter parallel;              ///< See WsprStatsSnapshot::parallel.
+    WsprTimingCounter cache;                 ///< See WsprStatsSnapshot::cache.
+    std::atomic<uint64_t> cache_hits{0};     ///< See WsprStatsSnapshot::cache_hits.
+    std::atomic<uint64_t> cache_misses{0};   ///< See WsprStatsSnapshot::cache_misses.
+    std::atomic<uint64_t> allocations{0};    ///< See WsprStatsSnapshot::allocations.
+
+    /**
+     * @brief Returns the process-wide counters.
+     *
+     * @return The shared instance; constant-initialized, so no guard on access.
+     */
+    static WsprStats &global() noexcept
+    {
+        static WsprStats stats;
+        return stats;
+    }
+
+    /**
+     * @brief Copies the counters and converts ticks to nanoseconds.
+     *
+     * @return The snapshot. Counters keep running while it is taken, so
+     *         fields may reflect slightly different instants.
+     */
+    static WsprStatsSnapshot snapshot() noexcept
+    {
+        WsprStats &stats = global();
+        const double ns_per_tick = 1e9 / WsprClock::ticks_per_second();
+
+        WsprStatsSnapshot out;
+        convert(stats.encode, ns_per_tick, out.encode);
+        convert(stats.reencode, ns_per_tick, out.reencode);
+        convert(stats.batch, ns_per_tick, out.batch);
+        convert(stats.parallel, ns_per_tick, out.parallel);
+        convert(stats.cache, ns_per_tick, out.cache);
+        out.cache_hits = stats.cache_hits.load(std::memory_order_relaxed);
+        out.cache_misses = stats.cache_misses.load(std::memory_order_relaxed);
+        const uint64_t lookups = out.cache_hits + out.cache_misses;
+        out.cache_hit_rate = lookups == 0 ? 0.0 : static_cast<double>(out.cache_hits) / static_cast<double>(lookups);
+        out.allocations = stats.allocations.load(std::memory_order_relaxed);
+        return out;
+    }
+
+    /**
+     * @brief Zeroes every counter.
+     */
+    static void reset() noexcept
+    {
+        WsprStats &stats = global();
+        stats.encode.reset();
+        stats.reencode.reset();
+        stats.batch.reset();
+        stats.parallel.reset();
+        stats.cache.reset();
+        stats.cache_hits.store(0, std::memory_order_relaxed);
+        stats.cache_misses.store(0, std::memory_order_relaxed);
+        stats.allocations.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @brief Converts one timing counter.
+     *
+     * @param counter The source counter.
+     * @param ns_per_tick Tick length in nanoseconds.
+     * @param out The destination summary.
+     */
+    static void convert(const WsprTimingCounter &counter, double ns_per_tick, WsprStatsSnapshot::Timing &out) noexcept
+    {
+        out.calls = counter.calls.load(std::memory_order_relaxed);
+        out.items = counter.items.load(std::memory_order_relaxed);
+        out.total_ns = static_cast<double>(counter.total_ticks.load(std::memory_order_relaxed)) * ns_per_tick;
+        out.max_ns = static_cast<double>(counter.max_ticks.load(std::memory_order_relaxed)) * ns_per_tick;
+        out.mean_ns = out.calls == 0 ? 0.0 : out.total_ns / static_cast<double>(out.calls);
+    }
+};
+
+/**
+ * @class WsprScopedTimer
+ * @brief Records the lifetime of a scope into a WsprTimingCounter.
+ */
+class WsprScopedTimer
+{
+public:
+    /**
+     * @brief Starts timing.
+     *
+     * @param counter The counter to record into.
+     * @param items Messages handled by the timed call.
+     */
+    WsprScopedTimer(WsprTimingCounter &counter, uint64_t items) noexcept
+        : counter_(counter), items_(items), start_(WsprClock::now())
+    {
+    }
+
+    /**
+     * @brief Stops timing and records the call.
+     */
+    ~WsprScopedTimer() { counter_.record(WsprClock::now() - start_, items_); }
+
+    WsprScopedTimer(const WsprScopedTimer &) = delete;
+    WsprScopedTimer &operator=(const WsprScopedTimer &) = delete;
+
+private:
+    WsprTimingCounter &counter_;
+    uint64_t items_;
+    uint64_t start_;
+};
+
+#if WSPR_INSTRUMENT
+/**
+ * @brief Times the rest of the enclosing scope into WsprStats::global().counter.
+ */
+#define WSPR_STAT_TIME(counter, items) WsprScopedTimer wspr_stat_timer_(WsprStats::global().counter, (items))
+/**
+ * @brief Adds `n` to the atomic WsprStats::global().field.
+ */
+#define WSPR_STAT_ADD(field, n) WsprStats::global().field.fetch_add((n), std::memory_order_relaxed)
+#else
+#define WSPR_STAT_TIME(counter, items) ((void)0)
+#define WSPR_STAT_ADD(field, n) ((void)0)
+#endif // WSPR_INSTRUMENT
+
+#endif // WSPR_STATS_H
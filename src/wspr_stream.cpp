@@ -0,0 +1,399 @@
+/**
+ * @file wspr_stream.cpp
+ * @brief Streaming bulk encoder from delimited text records to symbol output.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wspr_stream.hpp"
+#include "wspr_packed.hpp"
+#include <cstring> // For: std::memchr, std::memmove, std::memcpy
+
+namespace
+{
+    constexpr std::size_t read_size = 1 << 20;   ///< Bytes requested per read.
+    constexpr std::size_t output_size = 1 << 20; ///< Output buffer capacity.
+    constexpr std::size_t record_max = 512;      ///< Upper bound on one formatted record.
+
+    /**
+     * @brief Returns true for characters that separate fields.
+     *
+     * @param ch The character to test.
+     * @return True for a comma, semicolon, space, tab, or carriage return.
+     */
+    constexpr bool is_separator(char ch) noexcept
+    {
+        return ch == ',' || ch == ';' || ch == ' ' || ch == '\t' || ch == '\r';
+    }
+
+    /**
+     * @brief Parses a signed decimal power level.
+     *
+     * @param field The characters to parse.
+     * @param value Receives the value; saturates well outside the valid range.
+     * @return False if the field is not an optionally signed integer.
+     */
+    bool parse_power(std::string_view field, int &value) noexcept
+    {
+        std::size_t i = 0;
+        bool negative = false;
+        if (!field.empty() && (field[0] == '-' || field[0] == '+'))
+        {
+            negative = (field[0] == '-');
+            i = 1;
+        }
+        if (i == field.size())
+        {
+            return false;
+        }
+
+        int result = 0;
+        for (; i < field.size(); ++i)
+        {
+            if (field[i] < '0' || field[i] > '9')
+            {
+                return false;
+            }
+            if (result < 100000)
+            {
+                result = result * 10 + (field[i] - '0');
+            }
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+
+    /**
+     * @brief Returns a short description of a validation failure.
+     *
+     * @param status The failure.
+     * @return A static string.
+     */
+    const char *describe(WsprStatus status) noexcept
+    {
+        switch (status)
+        {
+        case WsprStatus::invalid_callsign:
+            return "invalid callsign";
+        case WsprStatus::invalid_locator:
+            return "invalid locator";
+        case WsprStatus::invalid_power:
+            return "invalid power level";
+        default:
+            return "invalid record";
+        }
+    }
+}
+
+/**
+ * @brief Creates a stream encoder and its thread pool.
+ *
+ * @param options Output format, thread count, and kernel.
+ */
+WsprStreamEncoder::WsprStreamEncoder(const Options &options)
+    : options_(options),
+      encoder_(options.threads),
+      input_(read_size),
+      output_(output_size)
+{
+    callsigns_.reserve(block_records);
+    locations_.reserve(block_records);
+    powers_.reserve(block_records);
+    lines_.reserve(block_records);
+    malformed_.reserve(block_records);
+    status_.resize(block_records);
+    symbols_.resize(block_records * MSG_SIZE);
+}
+
+/**
+ * @brief Encodes every record from `in` until end of file.
+ *
+ * @param in Input stream, read in binary blocks.
+ * @param out Output stream for the encoded records.
+ * @param errors Stream for per-record diagnostics; may be nullptr.
+ * @return False if reading or writing failed.
+ */
+bool WsprStreamEncoder::run(std::FILE *in, std::FILE *out, std::FILE *errors)
+{
+    std::size_t filled = 0;
+    uint64_t line = 0;
+    bool eof = false;
+
+    while (!eof)
+    {
+        // Keep at least one read's worth of space; only a very long line grows the buffer
+        if (input_.size() - filled < read_size)
+        {
+            input_.resize(filled + read_size);
+        }
+
+        const std::size_t got = std::fread(input_.data() + filled, 1, input_.size() - filled, in);
+        if (got == 0)
+        {
+            if (std::ferror(in))
+            {
+                return false;
+            }
+            eof = true;
+        }
+        filled += got;
+
+        const char *start = input_.data();
+        const char *const end = start + filled;
+        while (start < end)
+        {
+            const char *newline = static_cast<const char *>(std::memchr(start, '\n', static_cast<std::size_t>(end - start)));
+            if (newline == nullptr)
+            {
+                if (!eof)
+                {
+                    break; // Incomplete line; finish it after the next read
+                }
+                newline = end;
+            }
+
+            parse_line(start, newline, ++line);
+            start = (newline == end) ? end : newline + 1;
+
+            if (callsigns_.size() == block_records && !encode_block(out, errors))
+            {
+                return false;
+            }
+        }
+
+        // Views into the buffer must be consumed before the tail moves
+        if (!encode_block(out, errors))
+        {
+            return false;
+        }
+
+        const std::size_t tail = static_cast<std::size_t>(end - start);
+        std::memmove(input_.data(), start, tail);
+        filled = tail;
+    }
+
+    return flush(out) && std::fflush(out) == 0;
+}
+
+/**
+ * @brief Returns the totals accumulated over all runs.
+ *
+ * @return The stream statistics.
+ */
+WsprStreamEncoder::Stats WsprStreamEncoder::stats() const noexcept
+{
+    return stats_;
+}
+
+/**
+ * @brief Parses one input line into the pending block.
+ *
+ * @param begin First character of the line.
+ * @param end One past the last character, excluding the newline.
+ * @param line One-based line number for diagnostics.
+ */
+void WsprStreamEncoder::parse_line(const char *begin, const char *end, uint64_t line)
+{
+    // Split into at most four fields so extra columns are detected
+    std::string_view fields[4];
+    std::size_t count = 0;
+    const char *p = begin;
+    while (count < 4)
+    {
+        while (p < end && is_separator(*p))
+        {
+            ++p;
+        }
+        if (p == end)
+        {
+            break;
+        }
+        const char *field = p;
+        while (p < end && !is_separator(*p))
+        {
+            ++p;
+        }
+        fields[count++] = std::string_view(field, static_cast<std::size_t>(p - field));
+    }
+
+    if (count == 0 || fields[0][0] == '#')
+    {
+        return; // Blank line or comment
+    }
+
+    int power = 0;
+    const bool parsed = (count == 3) && parse_power(fields[2], power);
+
+    if (!header_checked_)
+    {
+        header_checked_ = true;
+        if (count == 3 && !parsed)
+        {
+            return; // CSV header such as "callsign,locator,power"
+        }
+    }
+
+    ++stats_.records;
+    callsigns_.push_back(parsed ? fields[0] : std::string_view());
+    locations_.push_back(parsed ? fields[1] : std::string_view());
+    powers_.push_back(power);
+    lines_.push_back(line);
+    malformed_.push_back(parsed ? 0 : 1);
+}
+
+/**
+ * @brief Encodes the pending block and appends it to the output buffer.
+ *
+ * @param out Output stream, written whenever the buffer fills.
+ * @param errors Stream for per-record diagnostics; may be nullptr.
+ * @return False if writing failed.
+ */
+bool WsprStreamEncoder::encode_block(std::FILE *out, std::FILE *errors)
+{
+    const std::size_t count = callsigns_.size();
+    if (count == 0)
+    {
+        return true;
+    }
+
+    auto rows = reinterpret_cast<uint8_t(*)[MSG_SIZE]>(symbols_.data());
+    encoder_.encode(callsigns_.data(), locations_.data(), powers_.data(), count, rows, status_.data(), options_.kernel);
+
+    bool ok = true;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (status_[i] != WsprStatus::ok)
+        {
+            ++stats_.rejected;
+            if (errors != nullptr)
+            {
+                std::fprintf(errors, "line %llu: %s\n", static_cast<unsigned long long>(lines_[i]),
+                             malformed_[i] ? "expected callsign, locator, and power" : describe(status_[i]));
+            }
+            continue;
+        }
+
+        if (output_.size() - output_used_ < record_max && !flush(out))
+        {
+            ok = false;
+            break;
+        }
+        format_record(i, rows[i]);
+        ++stats_.encoded;
+    }
+
+    callsigns_.clear();
+    locations_.clear();
+    powers_.clear();
+    lines_.clear();
+    malformed_.clear();
+    return ok;
+}
+
+/**
+ * @brief Formats one encoded record into the output buffer.
+ *
+ * @param index Record position in the pending block.
+ * @param symbols The record's encoded symbols.
+ */
+void WsprStreamEncoder::format_record(std::size_t index, const uint8_t *symbols)
+{
+    char *p = output_.data() + output_used_;
+
+    switch (options_.format)
+    {
+    case WsprStreamFormat::binary:
+        WsprPackedSymbols::pack(symbols, reinterpret_cast<uint8_t *>(p));
+        output_used_ += WsprPackedSymbols::size;
+        return;
+
+    case WsprStreamFormat::json:
+    {
+        // Validated callsigns and locators are alphanumeric, so no escaping is needed
+        append("{\"callsign\":\"");
+        append(callsigns_[index]);
+        append("\",\"locator\":\"");
+        append(locations_[index]);
+        append("\",\"power\":");
+        char number[4];
+        int length = 0;
+        int power = powers_[index];
+        if (power >= 10)
+        {
+            number[length++] = static_cast<char>('0' + power / 10);
+        }
+        number[length++] = static_cast<char>('0' + power % 10);
+        append(std::string_view(number, static_cast<std::size_t>(length)));
+        append(",\"symbols\":[");
+        p = output_.data() + output_used_;
+        for (std::size_t i = 0; i < MSG_SIZE; ++i)
+        {
+            *p++ = static_cast<char>('0' + symbols[i]);
+            *p++ = ',';
+        }
+        p[-1] = ']';
+        *p++ = '}';
+        *p++ = '\n';
+        output_used_ = static_cast<std::size_t>(p - output_.data());
+        return;
+    }
+
+    case WsprStreamFormat::text:
+    default:
+        for (std::size_t i = 0; i < MSG_SIZE; ++i)
+        {
+            *p++ = static_cast<char>('0' + symbols[i]);
+            *p++ = ',';
+        }
+        p[-1] = '\n';
+        output_used_ = static_cast<std::size_t>(p - output_.data());
+        return;
+    }
+}
+
+/**
+ * @brief Writes the output buffer to the stream and empties it.
+ *
+ * @param out Output stream.
+ * @return False if writing failed.
+ */
+bool WsprStreamEncoder::flush(std::FILE *out)
+{
+    if (output_used_ == 0)
+    {
+        return true;
+    }
+    const bool ok = std::fwrite(output_.data(), 1, output_used_, out) == output_used_;
+    output_used_ = 0;
+    return ok;
+}
+
+/**
+ * @brief Appends a string to the output buffer.
+ *
+ * @param text The characters to append.
+ */
+void WsprStreamEncoder::append(std::string_view text)
+{
+    std::memcpy(output_.data() + output_used_, text.data(), text.size());
+    output_used_ += text.size();
+}
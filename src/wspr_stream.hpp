@@ -0,0 +1,176 @@
+/**
+ * @file wspr_stream.hpp
+ * @brief Streaming bulk encoder from delimited text records to symbol output.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_STREAM_H
+#define WSPR_STREAM_H
+
+#include "wspr_parallel.hpp"
+
+#include <cstddef>     // For: std::size_t
+#include <cstdint>     // For: uint8_t, uint64_t
+#include <cstdio>      // For: std::FILE
+#include <string_view> // For: std::string_view
+#include <vector>      // For: std::vector
+
+/**
+ * @brief Output encodings produced by WsprStreamEncoder.
+ */
+enum class WsprStreamFormat : uint8_t
+{
+    text = 0, ///< One line of 162 comma-separated symbols per record.
+    binary,   ///< Back-to-back 41-byte WsprPackedSymbols records.
+    json      ///< One JSON object per line (NDJSON) echoing the inputs and symbols.
+};
+
+/**
+ * @class WsprStreamEncoder
+ * @brief Encodes newline-delimited records from a stream at I/O speed.
+ *
+ * Each input line holds a callsign, a locator, and a power level. Fields are
+ * separated by commas, semicolons, spaces, or tabs, so plain text and CSV
+ * both work. Blank lines and lines starting with `#` are skipped. A first
+ * line whose power field is not a number is treated as a CSV header.
+ *
+ * Input is read in large blocks with `std::fread`, and records are parsed
+ * in place as views into the read buffer. They are encoded in blocks
+ * through WsprParallelEncoder, and the formatted output is collected in a
+ * buffer written with `std::fwrite`. Nothing uses iostreams and nothing is
+ * flushed per record. Records that fail to parse or validate are reported
+ * on the error stream with their line number and left out of the output.
+ */
+class WsprStreamEncoder
+{
+public:
+    /**
+     * @brief Records encoded per call into the batch encoder.
+     */
+    static constexpr std::size_t block_records = 8192;
+
+    /**
+     * @brief Stream configuration.
+     */
+    struct Options
+    {
+        WsprStreamFormat format = WsprStreamFormat::text; ///< Output encoding.
+        unsigned threads = 1;                             ///< Encoding threads; 0 uses all cores.
+        WsprKernel kernel = WsprKernel::automatic;        ///< Batch encoder kernel.
+    };
+
+    /**
+     * @brief Running totals for a stream.
+     */
+    struct Stats
+    {
+        uint64_t records = 0;  ///< Records read, excluding blanks, comments, and a header.
+        uint64_t encoded = 0;  ///< Records written to the output.
+        uint64_t rejected = 0; ///< Records that failed to parse or validate.
+    };
+
+    /**
+     * @brief Creates a stream encoder and its thread pool.
+     *
+     * @param options Output format, thread count, and kernel.
+     */
+    explicit WsprStreamEncoder(const Options &options);
+
+    /**
+     * @brief Encodes every record from `in` until end of file.
+     *
+     * @param in Input stream, read in binary blocks.
+     * @param out Output stream for the encoded records.
+     * @param errors Stream for per-record diagnostics; may be nullptr.
+     * @return False if reading or writing failed.
+     */
+    bool run(std::FILE *in, std::FILE *out, std::FILE *errors);
+
+    /**
+     * @brief Returns the totals accumulated over all runs.
+     *
+     * @return The stream statistics.
+     */
+    Stats stats() const noexcept;
+
+private:
+    /**
+     * @brief Parses one input line into the pending block.
+     *
+     * @param begin First character of the line.
+     * @param end One past the last character, excluding the newline.
+     * @param line One-based line number for diagnostics.
+     */
+    void parse_line(const char *begin, const char *end, uint64_t line);
+
+    /**
+     * @brief Encodes the pending block and appends it to the output buffer.
+     *
+     * @param out Output stream, written whenever the buffer fills.
+     * @param errors Stream for per-record diagnostics; may be nullptr.
+     * @return False if writing failed.
+     */
+    bool encode_block(std::FILE *out, std::FILE *errors);
+
+    /**
+     * @brief Formats one encoded record into the output buffer.
+     *
+     * @param index Record position in the pending block.
+     * @param symbols The record's encoded symbols.
+     */
+    void format_record(std::size_t index, const uint8_t *symbols);
+
+    /**
+     * @brief Writes the output buffer to the stream and empties it.
+     *
+     * @param out Output stream.
+     * @return False if writing failed.
+     */
+    bool flush(std::FILE *out);
+
+    /**
+     * @brief Appends a string to the output buffer.
+     *
+     * @param text The characters to append.
+     */
+    void append(std::string_view text);
+
+    Options options_;               ///< Stream configuration.
+    Stats stats_;                   ///< Running totals.
+    WsprParallelEncoder encoder_;   ///< Block encoder.
+    std::vector<char> input_;       ///< Read buffer; grows only for very long lines.
+    std::vector<char> output_;      ///< Pending formatted output.
+    std::size_t output_used_ = 0;   ///< Bytes of `output_` in use.
+    bool header_checked_ = false;   ///< First record has been examined for a header.
+
+    // Pending block, one entry per record; views point into `input_`
+    std::vector<std::string_view> callsigns_;
+    std::vector<std::string_view> locations_;
+    std::vector<int> powers_;
+    std::vector<uint64_t> lines_;
+    std::vector<uint8_t> malformed_;
+    std::vector<WsprStatus> status_;
+    std::vector<uint8_t> symbols_;
+};
+
+#endif // WSPR_STREAM_H
@@ -0,0 +1,247 @@
+/**
+ * @file wspr_tones.hpp
+ * @brief Maps WSPR symbols to precomputed hardware tuning words.
+ * @brief An implementation of a WSPR packet generator.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WSPR_TONES_H
+#define WSPR_TONES_H
+
+#include "wspr_message.hpp"
+
+#include <array>   // For: std::array
+#include <cstddef> // For: std::size_t
+#include <cstdint> // For: uint32_t, uint64_t
+
+/**
+ * @brief How a transmitter turns a tuning word into a frequency.
+ */
+enum class WsprTuning : uint8_t
+{
+    divider = 0, ///< Fixed-point divisor: f = reference / (word / 2^fraction_bits).
+    accumulator  ///< Phase accumulator (DDS): f = reference * word / 2^fraction_bits.
+};
+
+/**
+ * @struct WsprTuningModel
+ * @brief Describes the frequency-setting hardware that consumes tuning words.
+ */
+struct WsprTuningModel
+{
+    WsprTuning tuning;      ///< How the word sets the output frequency.
+    double reference_hz;    ///< Reference clock the hardware divides or accumulates.
+    unsigned fraction_bits; ///< Fractional bits of a divisor, or the accumulator width.
+    unsigned word_bits;     ///< Width of the computed word before `or_mask` is applied.
+    uint32_t or_mask;       ///< Constant bits ORed into every word, such as a register password.
+
+    /**
+     * @brief Returns the model for a Raspberry Pi general-purpose clock divider.
+     *
+     * The CM_GPxDIV register holds a 12.12 fixed-point divisor (DIVI, DIVF)
+     * and must be written with the 0x5A password in its top byte. At HF
+     * one DIVF step is wider than the tone spacing, so check the table
+     * with WsprToneWords::frequency() before relying on it.
+     *
+     * @param pll_hz Frequency of the clock source feeding the divider.
+     * @return The tuning model.
+     */
+    static constexpr WsprTuningModel raspberry_pi_clock(double pll_hz = 500e6) noexcept
+    {
+        return {WsprTuning::divider, pll_hz, 12, 24, 0x5A000000u};
+    }
+
+    /**
+     * @brief Returns the model for a direct digital synthesizer.
+     *
+     * @param reference_hz DDS system clock.
+     * @param bits Width of the frequency tuning word, at most 32.
+     * @return The tuning model.
+     */
+    static constexpr WsprTuningModel dds(double reference_hz, unsigned bits = 32) noexcept
+    {
+        return {WsprTuning::accumulator, reference_hz, bits, bits, 0};
+    }
+};
+
+/**
+ * @class WsprToneWords
+ * @brief Output stage producing one tuning word per WSPR symbol.
+ *
+ * The four tone words are computed once for a given base frequency and
+ * hardware model. Mapping a message is then one table load per symbol, and
+ * its output is a flat array of 32-bit words that a DMA engine can stream
+ * straight into the frequency register during the transmission. Nothing
+ * has to be computed in the timing-critical loop.
+ */
+class WsprToneWords
+{
+public:
+    /**
+     * @brief Spacing between adjacent WSPR tones in Hz (12000 / 8192).
+     */
+    static constexpr double tone_spacing = 12000.0 / 8192.0;
+
+    /**
+     * @brief Duration of one symbol in seconds (8192 / 12000).
+     */
+    static constexpr double symbol_period = 8192.0 / 12000.0;
+
+    /**
+     * @brief The tuning words for tones 0 through 3.
+     */
+    using ToneTable = std::array<uint32_t, 4>;
+
+    /**
+     * @brief Storage for one message's worth of contiguous tuning words.
+     */
+    using Words = std::array<uint32_t, MSG_SIZE>;
+
+    /**
+     * @brief Converts a signal's center frequency to the frequency of tone 0.
+     *
+     * WSPR frequencies are usually quoted as the center of the 6 Hz wide
+     * signal, which lies halfway between tones 1 and 2.
+     *
+     * @param center_hz Center frequency of the transmitted signal.
+     * @return Frequency of the lowest tone.
+     */
+    static constexpr double base_from_center(double center_hz) noexcept
+    {
+        return center_hz - 1.5 * tone_spacing;
+    }
+
+    /**
+     * @brief Computes the tuning word for one frequency.
+     *
+     * @param frequency_hz Target output frequency.
+     * @param model Hardware tuning model.
+     * @param word Receives the rounded word with `or_mask` applied.
+     * @return False if the frequency is not positive or the word is zero or
+     *         does not fit in `word_bits`.
+     */
+    static constexpr bool tuning_word(double frequency_hz, const WsprTuningModel &model, uint32_t &word) noexcept
+    {
+        if (!(frequency_hz > 0.0) || !(model.reference_hz > 0.0) ||
+            model.word_bits == 0 || model.word_bits > 32 || model.fraction_bits > 32)
+        {
+            return false;
+        }
+
+        const double scale = static_cast<double>(uint64_t{1} << model.fraction_bits);
+        const double exact = (model.tuning == WsprTuning::divider)
+                                 ? model.reference_hz / frequency_hz * scale
+                                 : frequency_hz / model.reference_hz * scale;
+        const double limit = static_cast<double>(uint64_t{1} << model.word_bits);
+        if (!(exact + 0.5 < limit))
+        {
+            return false;
+        }
+
+        const uint64_t rounded = static_cast<uint64_t>(exact + 0.5);
+        if (rounded == 0)
+        {
+            return false;
+        }
+        word = static_cast<uint32_t>(rounded) | model.or_mask;
+        return true;
+    }
+
+    /**
+     * @brief Returns the frequency a tuning word actually produces.
+     *
+     * Useful to see how far the hardware's quantization moves each tone.
+     *
+     * @param word A word from tuning_word(); `or_mask` bits are ignored.
+     * @param model Hardware tuning model.
+     * @return Output frequency in Hz, or 0 for a zero word.
+     */
+    static constexpr double frequency(uint32_t word, const WsprTuningModel &model) noexcept
+    {
+        const uint64_t mask = (model.word_bits >= 32) ? 0xFFFFFFFFull : ((uint64_t{1} << model.word_bits) - 1);
+        const double value = static_cast<double>(word & (mask & ~static_cast<uint64_t>(model.or_mask)));
+        if (value == 0.0)
+        {
+            return 0.0;
+        }
+        const double scale = static_cast<double>(uint64_t{1} << model.fraction_bits);
+        return (model.tuning == WsprTuning::divider)
+                   ? model.reference_hz * scale / value
+                   : model.reference_hz * value / scale;
+    }
+
+    /**
+     * @brief Precomputes the four tone words for a transmission.
+     *
+     * @param base_hz Frequency of tone 0.
+     * @param model Hardware tuning model.
+     * @param table Receives the words for tones 0-3.
+     * @return False if any tone cannot be represented; `table` is then unchanged.
+     */
+    static constexpr bool make_tone_table(double base_hz, const WsprTuningModel &model, ToneTable &table) noexcept
+    {
+        ToneTable words{};
+        for (std::size_t tone = 0; tone < words.size(); ++tone)
+        {
+            if (!tuning_word(base_hz + static_cast<double>(tone) * tone_spacing, model, words[tone]))
+            {
+                return false;
+            }
+        }
+        table = words;
+        return true;
+    }
+
+    /**
+     * @brief Maps 162 symbols to tuning words in a caller-provided buffer.
+     *
+     * @param symbols Source buffer of MSG_SIZE symbols, each 0-3.
+     * @param table Tone words from make_tone_table().
+     * @param out Destination for the words; word `i` goes to `out[i * stride]`.
+     * @param stride Distance between consecutive words, in words. Values
+     *               above 1 let words be written straight into an array of
+     *               DMA control blocks or register-pair records.
+     */
+    static constexpr void map(const uint8_t *symbols, const ToneTable &table, uint32_t *out, std::size_t stride = 1) noexcept
+    {
+        for (std::size_t i = 0; i < MSG_SIZE; ++i)
+        {
+            out[i * stride] = table[symbols[i] & 3];
+        }
+    }
+
+    /**
+     * @brief Maps a message's symbols to contiguous tuning words.
+     *
+     * @param symbols The symbols to map.
+     * @param table Tone words from make_tone_table().
+     * @return The 162 tuning words.
+     */
+    static constexpr Words map(const WsprMessage::Symbols &symbols, const ToneTable &table) noexcept
+    {
+        Words words{};
+        map(symbols.data(), table, words.data());
+        return words;
+    }
+};
+
+#endif // WSPR_TONES_H